@@ -0,0 +1,81 @@
+/**
+ * @file abcgAllocationCounter.cpp
+ * @brief Definition of helper functions for counting memory allocations.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgAllocationCounter.hpp"
+
+#if defined(ABCG_COUNT_ALLOCATIONS)
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<std::uint64_t> allocationCount{};
+} // namespace
+
+// Replacements of the global allocation functions. The array and nothrow
+// versions of the standard library call these ones.
+void *operator new(std::size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  // NOLINTNEXTLINE(cppcoreguidelines-no-malloc)
+  if (auto *pointer{std::malloc(size == 0 ? 1 : size)}; pointer != nullptr) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc)
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t /*size*/) noexcept {
+  std::free(pointer);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc)
+#endif
+
+/**
+ * @brief Returns whether the allocations are counted.
+ *
+ * @returns `true` if ABCg is built with `BENCHMARK_COUNT_ALLOCATIONS`;
+ * `false` otherwise.
+ */
+bool abcg::isAllocationCountingEnabled() noexcept {
+#if defined(ABCG_COUNT_ALLOCATIONS)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * @brief Returns the number of calls to the global `operator new` since the
+ * program started.
+ *
+ * Aligned allocations (`operator new` with `std::align_val_t`) are not
+ * counted.
+ *
+ * @returns Number of allocations, or zero if the allocations are not counted
+ * (see abcg::isAllocationCountingEnabled).
+ */
+std::uint64_t abcg::getAllocationCount() noexcept {
+#if defined(ABCG_COUNT_ALLOCATIONS)
+  return allocationCount.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,27 @@
+/**
+ * @file abcgAllocationCounter.hpp
+ * @brief Declaration of helper functions for counting memory allocations.
+ *
+ * If ABCg is built with `BENCHMARK_COUNT_ALLOCATIONS` (the default when
+ * `ENABLE_BENCHMARK` is set), which defines the preprocessor symbol
+ * `ABCG_COUNT_ALLOCATIONS`, the global `operator new` and `operator delete`
+ * are replaced by versions that count the allocations of the whole program,
+ * including those of ABCg and of its dependencies written in C++.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_ALLOCATION_COUNTER_HPP_
+#define ABCG_ALLOCATION_COUNTER_HPP_
+
+#include <cstdint>
+
+namespace abcg {
+[[nodiscard]] bool isAllocationCountingEnabled() noexcept;
+[[nodiscard]] std::uint64_t getAllocationCount() noexcept;
+} // namespace abcg
+
+#endif
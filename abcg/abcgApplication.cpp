@@ -13,9 +13,14 @@
 #include <SDL_image.h>
 #include <SDL_thread.h>
 
+#include <charconv>
+#include <random>
 #include <span>
+#include <string_view>
 
+#include "abcgAllocationCounter.hpp"
 #include "abcgException.hpp"
+#include "abcgTrace.hpp"
 #include "abcgWindow.hpp"
 
 #if defined(__EMSCRIPTEN__)
@@ -27,6 +32,19 @@
 // @endcond
 #include "tiny_obj_loader.h"
 
+namespace {
+template <typename T> T parseNumber(std::string_view option, std::string_view text) {
+  T value{};
+  auto const *last{text.data() + text.size()};
+  if (auto const [ptr, ec]{std::from_chars(text.data(), last, value)};
+      ec != std::errc{} || ptr != last) {
+    throw abcg::RuntimeError(
+        fmt::format("Invalid value for command-line option {}", option));
+  }
+  return value;
+}
+} // namespace
+
 #if defined(__EMSCRIPTEN__)
 void abcg::mainLoopCallback(void *userData) {
   abcg::Application &app{*(static_cast<abcg::Application *>(userData))};
@@ -44,8 +62,45 @@ void abcg::mainLoopCallback(void *userData) {
  * of which the last one is nullptr and the previous ones, if any, point to
  * null-terminated multibyte strings that represent the arguments passed to the
  * program from the execution environment.
+ *
+ * The following command-line options override the window settings given to
+ * abcg::Window::setWindowSettings. Other arguments are ignored.
+ *
+ * - `--headless`: sets abcg::WindowSettings::headless to `true`.
+ * - `--hot-reload`: sets abcg::WindowSettings::hotReload to `true`.
+ * - `--frames=N`: sets abcg::WindowSettings::maxFrames to `N`.
+ * - `--size=WxH`: sets abcg::WindowSettings::width to `W` and
+ *   abcg::WindowSettings::height to `H`.
+ *
+ * The following options control the timing and input of the session:
+ *
+ * - `--seed=N`: sets the value returned by abcg::Application::getRandomSeed.
+ * - `--record=FILE`: records the SDL events, the frame times and the random
+ *   seed to a binary log.
+ * - `--replay=FILE`: replays a session recorded with `--record`, ignoring
+ *   live input. The application exits at the end of the log.
+ * - `--fixed-delta=SECONDS`: advances the time by a fixed amount in each
+ *   iteration of the main loop, regardless of the real time. When replaying,
+ *   the recorded frame times are ignored.
+ *
+ * With any of the options `--record`, `--replay` or `--fixed-delta`, all
+ * abcg::Timer objects use a virtual clock that advances only once per
+ * iteration of the main loop.
+ *
+ * - `--report=FILE`: writes a JSON report with frame time percentiles,
+ *   CPU/GPU times and frame counters (abcg::BenchmarkReport) when the
+ *   application exits. This sets abcg::WindowSettings::frameCounters to
+ *   `true`.
+ * - `--capture=FILE`: captures the OpenGL calls to a file that can be replayed
+ *   with `abcg_replay` (abcg::WindowSettings::capturePath).
+ * - `--capture-frames=FIRST,COUNT`: sets the frames measured by the replay of
+ *   the capture (abcg::WindowSettings::captureFirstFrame and
+ *   abcg::WindowSettings::captureFrameCount). By default, only the first
+ *   frame is measured.
+ *
+ * @throw abcg::RuntimeError if the value of an option is invalid.
  */
-abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
+abcg::Application::Application(int argc, char **argv) {
   // Get executable relative path
   std::string const argv_str{*std::span{&argv, 1}[0]};
 #if defined(WIN32)
@@ -61,6 +116,72 @@ abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
 #endif
 
   abcg::Application::m_assetsPath = abcg::Application::m_basePath + "/assets/";
+
+  std::string recordPath;
+  std::string replayPath;
+  m_randomSeed = std::random_device{}();
+
+  // Parse command-line options
+  for (std::string_view const arg :
+       std::span{argv, gsl::narrow<std::size_t>(argc)}.subspan(1)) {
+    auto const separator{arg.find('=')};
+    auto const option{arg.substr(0, separator)};
+    auto const value{separator == std::string_view::npos
+                         ? std::string_view{}
+                         : arg.substr(separator + 1)};
+
+    if (option == "--headless") {
+      m_headless = true;
+    } else if (option == "--hot-reload") {
+      m_hotReload = true;
+    } else if (option == "--frames") {
+      m_maxFrames = parseNumber<std::size_t>(option, value);
+    } else if (option == "--size") {
+      auto const x{value.find('x')};
+      if (x == std::string_view::npos) {
+        throw abcg::RuntimeError(
+            fmt::format("Invalid value for command-line option {}", option));
+      }
+      m_width = parseNumber<int>(option, value.substr(0, x));
+      m_height = parseNumber<int>(option, value.substr(x + 1));
+    } else if (option == "--seed") {
+      m_randomSeed = parseNumber<unsigned int>(option, value);
+    } else if (option == "--record") {
+      recordPath = value;
+    } else if (option == "--replay") {
+      replayPath = value;
+    } else if (option == "--report") {
+      m_reportPath = value;
+    } else if (option == "--capture") {
+      m_capturePath = value;
+    } else if (option == "--capture-frames") {
+      auto const comma{value.find(',')};
+      if (comma == std::string_view::npos) {
+        throw abcg::RuntimeError(
+            fmt::format("Invalid value for command-line option {}", option));
+      }
+      m_captureFirstFrame =
+          parseNumber<std::size_t>(option, value.substr(0, comma));
+      m_captureFrameCount =
+          parseNumber<std::size_t>(option, value.substr(comma + 1));
+    } else if (option == "--fixed-delta") {
+      auto const seconds{parseNumber<double>(option, value)};
+      m_fixedDeltaTime = std::chrono::duration_cast<Timer::clock::duration>(
+          std::chrono::duration<double>{seconds});
+    }
+  }
+
+  if (!replayPath.empty()) {
+    m_randomSeed =
+        gsl::narrow_cast<unsigned int>(m_eventLog.openForReading(replayPath));
+  } else if (!recordPath.empty()) {
+    m_eventLog.openForWriting(recordPath, m_randomSeed);
+  }
+
+  if (m_eventLog.isRecording() || m_eventLog.isReplaying() ||
+      m_fixedDeltaTime.count() > 0) {
+    Timer::enableVirtualClock();
+  }
 }
 
 /**
@@ -75,6 +196,37 @@ abcg::Application::Application([[maybe_unused]] int argc, char **argv) {
  * @throw abcg::SDLImageError if `IMG_Init` failed.
  */
 void abcg::Application::run(Window &window) {
+  // Apply command-line overrides
+  auto windowSettings{window.getWindowSettings()};
+  windowSettings.headless = windowSettings.headless || m_headless;
+  windowSettings.hotReload = windowSettings.hotReload || m_hotReload;
+  windowSettings.frameCounters =
+      windowSettings.frameCounters || !m_reportPath.empty();
+  if (!m_capturePath.empty()) {
+    windowSettings.capturePath = m_capturePath;
+  }
+  if (m_captureFrameCount > 0) {
+    windowSettings.captureFirstFrame = m_captureFirstFrame;
+    windowSettings.captureFrameCount = m_captureFrameCount;
+  }
+  if (m_maxFrames > 0) {
+    windowSettings.maxFrames = m_maxFrames;
+  }
+  if (m_width > 0 && m_height > 0) {
+    windowSettings.width = m_width;
+    windowSettings.height = m_height;
+  }
+  window.setWindowSettings(windowSettings);
+
+#if !defined(__EMSCRIPTEN__)
+  if (windowSettings.headless) {
+    // Do not require a display or an audio device unless the user selected
+    // the drivers explicitly
+    SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+  }
+#endif
+
   if (Uint32 const subsystemMask{SDL_INIT_VIDEO | SDL_INIT_AUDIO |
                                  SDL_INIT_GAMECONTROLLER};
       SDL_Init(subsystemMask) != 0) {
@@ -90,8 +242,14 @@ void abcg::Application::run(Window &window) {
   }
 #endif
 
+  if (auto const *tracePath{SDL_getenv("ABCG_TRACE")};
+      tracePath != nullptr && *tracePath != '\0') {
+    Trace::start(tracePath);
+  }
+
   m_window = &window;
   m_window->templateCreate();
+  m_lastIterationTime = Timer::clock::now();
 
 #if defined(__EMSCRIPTEN__)
   emscripten_set_main_loop_arg(mainLoopCallback, this, 0, true);
@@ -102,22 +260,99 @@ void abcg::Application::run(Window &window) {
   };
 #endif
 
+  if (!m_reportPath.empty()) {
+    m_report.write(m_reportPath, m_window->getWindowSettings(), m_randomSeed);
+  }
+
   m_window->templateDestroy();
 
+  Trace::stop();
+
 #if !defined(__EMSCRIPTEN__)
   IMG_Quit();
 #endif
   SDL_Quit();
 }
 
-void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) const {
+void abcg::Application::mainLoopIterator([[maybe_unused]] bool &done) {
+  m_events.clear();
+
   SDL_Event event{};
-  while (SDL_PollEvent(&event) != 0) {
+  if (m_eventLog.isReplaying()) {
+    // Ignore live input, except for quit requests
+    while (SDL_PollEvent(&event) != 0) {
+      if (event.type == SDL_QUIT)
+        done = true;
+    }
+
+    Timer::clock::duration deltaTime{};
+    if (!m_eventLog.readFrame(deltaTime, m_events, m_window->getSDLWindowID())) {
+      done = true;
+      return;
+    }
+    Timer::advanceVirtualClock(m_fixedDeltaTime.count() > 0 ? m_fixedDeltaTime
+                                                            : deltaTime);
+  } else {
+    Timer::clock::duration idleTime{};
 #if !defined(__EMSCRIPTEN__)
-    if (event.type == SDL_QUIT)
+    // Sleep until there is something to paint
+    auto const idleStart{Timer::clock::now()};
+    if (m_window->waitEvent(event)) {
+      m_events.push_back(event);
+    }
+    idleTime = Timer::clock::now() - idleStart;
+#endif
+    while (SDL_PollEvent(&event) != 0) {
+      m_events.push_back(event);
+    }
+
+    if (Timer::isVirtualClockEnabled()) {
+      auto const now{Timer::clock::now()};
+      auto const deltaTime{m_fixedDeltaTime.count() > 0
+                               ? m_fixedDeltaTime
+                               : now - m_lastIterationTime - idleTime};
+      m_lastIterationTime = now;
+      Timer::advanceVirtualClock(deltaTime);
+      if (m_eventLog.isRecording()) {
+        m_eventLog.writeFrame(deltaTime, m_events);
+      }
+    }
+  }
+
+  for (auto const &pendingEvent : m_events) {
+#if !defined(__EMSCRIPTEN__)
+    if (pendingEvent.type == SDL_QUIT)
       done = true;
 #endif
-    m_window->templateHandleEvent(event, done);
+    m_window->templateHandleEvent(pendingEvent, done);
+  }
+
+  if (m_window->needsRedraw()) {
+    auto const paintBegin{Timer::clock::now()};
+    m_window->templatePaint();
+    if (!m_reportPath.empty()) {
+      addReportFrame(paintBegin);
+    }
+  }
+
+  if (auto const maxFrames{m_window->getWindowSettings().maxFrames};
+      maxFrames > 0 && m_window->getFrameCount() >= maxFrames) {
+    done = true;
+#if defined(__EMSCRIPTEN__)
+    emscripten_cancel_main_loop();
+#endif
+  }
+}
+
+void abcg::Application::addReportFrame(Timer::clock::time_point paintBegin) {
+  using seconds = std::chrono::duration<double>;
+  auto const allocationCount{getAllocationCount()};
+  // The first frame is skipped as it also measures the window creation
+  if (m_window->getFrameCount() > 1) {
+    m_report.addFrame(m_window->getFrameTime(),
+                      seconds{Timer::clock::now() - paintBegin}.count(),
+                      allocationCount - m_lastAllocationCount,
+                      m_window->getGPUTimes(), m_window->getFrameCounters());
   }
-  m_window->templatePaint();
+  m_lastAllocationCount = allocationCount;
 }
@@ -11,7 +11,14 @@
 #ifndef ABCG_APPLICATION_HPP_
 #define ABCG_APPLICATION_HPP_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
+
+#include "abcgBenchmarkReport.hpp"
+#include "abcgEventLog.hpp"
+#include "abcgTimer.hpp"
 
 #define ABCG_VERSION_MAJOR 3
 #define ABCG_VERSION_MINOR 0
@@ -73,11 +80,66 @@ public:
    */
   [[nodiscard]] static std::string const &getBasePath() { return m_basePath; }
 
+  /**
+   * @brief Returns the seed to be used by pseudo-random number generators.
+   *
+   * @return Seed given in the command-line option `--seed`, or the seed of
+   * the session being replayed with `--replay`. Otherwise, a seed generated
+   * by `std::random_device` when the application was created.
+   *
+   * Use this seed instead of a time-based seed so that recorded sessions can
+   * be replayed deterministically.
+   */
+  [[nodiscard]] static unsigned int getRandomSeed() { return m_randomSeed; }
+
+  /**
+   * @brief Returns a seed derived from abcg::Application::getRandomSeed for
+   * one of several independent pseudo-random number generators.
+   *
+   * @param stream Constant that identifies the generator (e.g., one per
+   * subsystem). Different constants give unrelated seeds, so that generators
+   * seeded from the same session do not produce the same sequence.
+   *
+   * @return Hash of the base seed and the given constant.
+   */
+  [[nodiscard]] static unsigned int getRandomSeed(unsigned int stream) {
+    // Finalizer of MurmurHash3
+    auto hash{static_cast<std::uint32_t>(m_randomSeed) ^
+              (static_cast<std::uint32_t>(stream) * 0x9e3779b9U)};
+    hash ^= hash >> 16U;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13U;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16U;
+    return hash;
+  }
+
 private:
-  void mainLoopIterator(bool &done) const;
+  void mainLoopIterator(bool &done);
+  void addReportFrame(Timer::clock::time_point paintBegin);
 
   Window *m_window{};
 
+  EventLog m_eventLog;
+  std::vector<SDL_Event> m_events;
+  Timer::clock::duration m_fixedDeltaTime{};
+  Timer::clock::time_point m_lastIterationTime{};
+
+  std::string m_reportPath;
+  BenchmarkReport m_report;
+  // Allocations counted until the end of the previous frame
+  std::uint64_t m_lastAllocationCount{};
+
+  // Overrides of the window settings given in the command line
+  bool m_headless{};
+  bool m_hotReload{};
+  std::size_t m_maxFrames{};
+  std::string m_capturePath;
+  std::size_t m_captureFirstFrame{};
+  std::size_t m_captureFrameCount{};
+  int m_width{};
+  int m_height{};
+
 #if defined(__EMSCRIPTEN__)
   friend void mainLoopCallback(void *userData);
 #endif
@@ -86,6 +148,7 @@ private:
   // See https://bugs.llvm.org/show_bug.cgi?id=48040
   static inline std::string m_assetsPath{};
   static inline std::string m_basePath{};
+  static inline unsigned int m_randomSeed{};
   // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 };
 
@@ -0,0 +1,153 @@
+/**
+ * @file abcgBenchmarkReport.cpp
+ * @brief Definition of abcg::BenchmarkReport members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgBenchmarkReport.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+#include "abcgAllocationCounter.hpp"
+#include "abcgException.hpp"
+#include "abcgProfiler.hpp"
+#include "abcgUtil.hpp"
+
+namespace {
+std::string toJSON(abcg::FrameStatistics const &statistics) {
+  return fmt::format(
+      R"({{"average": {:.4f}, "p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, )"
+      R"("max": {:.4f}, "hitches": {}}})",
+      statistics.getAverage() * 1000.0,
+      statistics.getPercentile(50.0) * 1000.0,
+      statistics.getPercentile(95.0) * 1000.0,
+      statistics.getPercentile(99.0) * 1000.0,
+      statistics.getMaximum() * 1000.0, statistics.getHitchCount());
+}
+} // namespace
+
+/**
+ * @brief Constructs an empty report.
+ *
+ * The statistics are computed over all frames of the run.
+ */
+abcg::BenchmarkReport::BenchmarkReport() {
+  m_frameTimes.setWindowSize(std::numeric_limits<std::size_t>::max());
+  m_paintTimes.setWindowSize(std::numeric_limits<std::size_t>::max());
+}
+
+/**
+ * @brief Adds the measurements of a frame.
+ *
+ * @param frameTime Real time since the previous frame, in seconds (see
+ * abcg::Window::getFrameTime).
+ * @param paintTime Time spent painting the frame, in seconds.
+ * @param allocations Number of memory allocations since the previous frame.
+ * @param gpuTimes GPU times returned by abcg::Window::getGPUTimes.
+ * @param frameCounters Counters returned by abcg::Window::getFrameCounters.
+ */
+void abcg::BenchmarkReport::addFrame(
+    double frameTime, double paintTime, std::uint64_t allocations,
+    std::vector<GPUTime> const &gpuTimes,
+    std::vector<FrameCounter> const &frameCounters) {
+  m_frameTimes.addFrameTime(frameTime);
+  m_paintTimes.addFrameTime(paintTime);
+  m_allocations.sum += allocations;
+  m_allocations.maximum = std::max(m_allocations.maximum, allocations);
+  ++m_allocations.count;
+  for (auto const &gpuTime : gpuTimes) {
+    auto &scope{m_gpuScopes[gpuTime.name]};
+    scope.sum += gpuTime.milliseconds;
+    scope.maximum = std::max(scope.maximum, gpuTime.milliseconds);
+    ++scope.count;
+  }
+  for (auto const &frameCounter : frameCounters) {
+    auto &counter{m_counters[frameCounter.name]};
+    counter.sum += frameCounter.value;
+    counter.maximum = std::max(counter.maximum, frameCounter.value);
+    ++counter.count;
+  }
+}
+
+/**
+ * @brief Writes the report to a JSON file.
+ *
+ * @param path Path to the output file.
+ * @param windowSettings Settings of the window used in the run.
+ * @param seed Random seed of the run.
+ *
+ * @throw abcg::RuntimeError if the file cannot be created.
+ */
+void abcg::BenchmarkReport::write(std::string const &path,
+                                  WindowSettings const &windowSettings,
+                                  unsigned int seed) const {
+  std::ofstream file{path, std::ios::trunc};
+  if (!file) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to create report file {}", path));
+  }
+
+  file << "{\n";
+  file << fmt::format("  \"title\": \"{}\",\n",
+                      escapeJSON(windowSettings.title));
+  file << fmt::format("  \"width\": {},\n", windowSettings.width);
+  file << fmt::format("  \"height\": {},\n", windowSettings.height);
+  file << fmt::format("  \"seed\": {},\n", seed);
+  file << fmt::format("  \"frames\": {},\n", m_frameTimes.getFrameCount());
+  file << fmt::format("  \"frameTime\": {},\n", toJSON(m_frameTimes));
+  file << fmt::format("  \"paintTime\": {},\n", toJSON(m_paintTimes));
+  if (isAllocationCountingEnabled() && m_allocations.count > 0) {
+    file << fmt::format(
+        R"(  "allocations": {{"average": {:.2f}, "max": {}, "total": {}}},)"
+        "\n",
+        gsl::narrow_cast<double>(m_allocations.sum) /
+            gsl::narrow_cast<double>(m_allocations.count),
+        m_allocations.maximum, m_allocations.sum);
+  }
+
+  file << "  \"gpu\": {";
+  auto separator{""};
+  for (auto const &[name, scope] : m_gpuScopes) {
+    file << fmt::format(
+        R"({}{}    "{}": {{"average": {:.4f}, "max": {:.4f}}})", separator,
+        "\n", escapeJSON(name),
+        scope.sum / gsl::narrow_cast<double>(scope.count), scope.maximum);
+    separator = ",";
+  }
+  file << (m_gpuScopes.empty() ? "}" : "\n  }");
+
+  file << ",\n  \"counters\": {";
+  separator = "";
+  for (auto const &[name, counter] : m_counters) {
+    file << fmt::format(
+        R"({}{}    "{}": {{"average": {:.2f}, "max": {}}})", separator, "\n",
+        escapeJSON(name),
+        gsl::narrow_cast<double>(counter.sum) /
+            gsl::narrow_cast<double>(counter.count),
+        counter.maximum);
+    separator = ",";
+  }
+  file << (m_counters.empty() ? "}" : "\n  }");
+
+  // Statistics of the last frames recorded by the CPU profiler
+  file << ",\n  \"cpu\": {";
+  separator = "";
+#if defined(ABCG_PROFILER)
+  for (auto const &scope : Profiler::getScopeStatistics()) {
+    file << fmt::format(
+        R"({}{}    "{}": {{"average": {:.4f}, "max": {:.4f}}})", separator,
+        "\n", escapeJSON(scope.name), scope.average, scope.maximum);
+    separator = ",";
+  }
+#endif
+  file << (*separator == '\0' ? "}" : "\n  }");
+  file << "\n}\n";
+
+  fmt::print("Benchmark report written to {}\n", path);
+}
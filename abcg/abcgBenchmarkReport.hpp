@@ -0,0 +1,72 @@
+/**
+ * @file abcgBenchmarkReport.hpp
+ * @brief Header file of abcg::BenchmarkReport.
+ *
+ * Declaration of abcg::BenchmarkReport.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_BENCHMARK_REPORT_HPP_
+#define ABCG_BENCHMARK_REPORT_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "abcgFrameStatistics.hpp"
+#include "abcgWindow.hpp"
+
+namespace abcg {
+class BenchmarkReport;
+} // namespace abcg
+
+/**
+ * @brief Collects performance data of a run and writes it as a JSON report.
+ *
+ * The report contains the percentiles of the frame time and of the CPU time
+ * spent painting each frame, the average and maximum GPU time of each GPU
+ * timer scope, the average and maximum value of each frame counter, the
+ * number of memory allocations per frame and in total if ABCg is built with
+ * `BENCHMARK_COUNT_ALLOCATIONS` (see abcg::getAllocationCount) and, if ABCg is
+ * built with `ENABLE_PROFILER`, the statistics of the CPU profiler scopes. All
+ * times are in milliseconds and are measured with the real clock, even if the
+ * application runs with `--fixed-delta`.
+ *
+ * @sa abcg::Application::Application for the command-line option `--report`.
+ */
+class abcg::BenchmarkReport {
+public:
+  BenchmarkReport();
+
+  void addFrame(double frameTime, double paintTime, std::uint64_t allocations,
+                std::vector<GPUTime> const &gpuTimes,
+                std::vector<FrameCounter> const &frameCounters);
+  void write(std::string const &path, WindowSettings const &windowSettings,
+             unsigned int seed) const;
+
+private:
+  struct GPUScope {
+    double sum{};
+    double maximum{};
+    std::size_t count{};
+  };
+
+  struct Counter {
+    std::uint64_t sum{};
+    std::uint64_t maximum{};
+    std::size_t count{};
+  };
+
+  FrameStatistics m_frameTimes;
+  FrameStatistics m_paintTimes;
+  Counter m_allocations;
+  std::map<std::string, GPUScope> m_gpuScopes;
+  std::map<std::string, Counter> m_counters;
+};
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file abcgBlockLayout.hpp
+ * @brief Compile-time validation of std140/std430 block layouts.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_BLOCK_LAYOUT_HPP_
+#define ABCG_BLOCK_LAYOUT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <glm/glm.hpp>
+
+namespace abcg {
+
+/**
+ * @brief Memory layout of a uniform or shader storage block.
+ */
+enum class BlockLayout { Std140, Std430 };
+
+/**
+ * @brief Array with elements aligned to 16 bytes.
+ *
+ * In the std140 layout, the stride of an array is rounded up to 16 bytes,
+ * which cannot be expressed with a plain C++ array of scalars or 2-component
+ * vectors. This array can be used instead:
+ * @code
+ * struct LightBlock {
+ *   abcg::BlockArray<float, 4> intensities; // uniform float intensities[4];
+ * };
+ * @endcode
+ *
+ * @tparam T Type of the elements.
+ * @tparam N Number of elements.
+ */
+template <typename T, std::size_t N> struct BlockArray {
+  /** @brief Element padded to 16 bytes. */
+  struct alignas(16) Element {
+    /** @brief Value of the element. */
+    T value;
+  };
+
+  /** @brief Elements of the array. */
+  std::array<Element, N> elements{};
+
+  /** @brief Returns a reference to the element at position `index`. */
+  constexpr T &operator[](std::size_t index) { return elements[index].value; }
+  /** @brief Returns a reference to the element at position `index`. */
+  constexpr T const &operator[](std::size_t index) const {
+    return elements[index].value;
+  }
+};
+
+/**
+ * @brief Type and offset of a member of a C++ struct that mirrors a block.
+ *
+ * Use the ABCG_BLOCK_FIELD macro to create objects of this type.
+ *
+ * @tparam T Type of the member.
+ */
+template <typename T> struct BlockField {
+  /** @brief Offset of the member, in bytes. */
+  std::size_t offset{};
+};
+
+/**
+ * @brief Alignment and size of a type in a block.
+ *
+ * Specializations are provided for `float`, `std::int32_t`, `std::uint32_t`,
+ * `glm` vectors and matrices of these types, `std::array`, C arrays and
+ * abcg::BlockArray.
+ *
+ * @tparam Layout Memory layout of the block.
+ * @tparam T C++ type.
+ */
+template <BlockLayout Layout, typename T> struct BlockTypeTraits {
+  static_assert(!std::is_same_v<T, T>,
+                "Type not supported in std140/std430 blocks");
+};
+
+/**
+ * @brief Rounds up an offset to a multiple of an alignment.
+ */
+constexpr std::size_t alignBlockOffset(std::size_t offset,
+                                       std::size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+/** @cond */
+template <BlockLayout Layout, typename T>
+  requires std::is_same_v<T, float> || std::is_same_v<T, std::int32_t> ||
+           std::is_same_v<T, std::uint32_t>
+struct BlockTypeTraits<Layout, T> {
+  static constexpr std::size_t alignment{4};
+  static constexpr std::size_t size{4};
+  static constexpr bool matches{sizeof(T) == size};
+};
+
+template <BlockLayout Layout, glm::length_t L, typename T, glm::qualifier Q>
+struct BlockTypeTraits<Layout, glm::vec<L, T, Q>> {
+  static constexpr std::size_t alignment{
+      BlockTypeTraits<Layout, T>::alignment * (L == 3 ? 4 : L)};
+  static constexpr std::size_t size{BlockTypeTraits<Layout, T>::size * L};
+  static constexpr bool matches{sizeof(glm::vec<L, T, Q>) == size};
+};
+
+// Stride and alignment of the elements of an array
+template <BlockLayout Layout, typename T> struct BlockArrayTraits {
+  static constexpr std::size_t alignment{
+      Layout == BlockLayout::Std140
+          ? alignBlockOffset(BlockTypeTraits<Layout, T>::alignment, 16)
+          : BlockTypeTraits<Layout, T>::alignment};
+  static constexpr std::size_t stride{
+      alignBlockOffset(BlockTypeTraits<Layout, T>::size, alignment)};
+};
+
+template <BlockLayout Layout, typename T, std::size_t N>
+struct BlockTypeTraits<Layout, std::array<T, N>> {
+  static constexpr std::size_t alignment{
+      BlockArrayTraits<Layout, T>::alignment};
+  static constexpr std::size_t size{BlockArrayTraits<Layout, T>::stride * N};
+  static constexpr bool matches{BlockTypeTraits<Layout, T>::matches &&
+                                sizeof(T) ==
+                                    BlockArrayTraits<Layout, T>::stride};
+};
+
+template <BlockLayout Layout, typename T, std::size_t N>
+struct BlockTypeTraits<Layout, T[N]>
+    : BlockTypeTraits<Layout, std::array<T, N>> {};
+
+template <BlockLayout Layout, typename T, std::size_t N>
+struct BlockTypeTraits<Layout, BlockArray<T, N>> {
+  static constexpr std::size_t alignment{
+      BlockArrayTraits<Layout, T>::alignment};
+  static constexpr std::size_t size{BlockArrayTraits<Layout, T>::stride * N};
+  static constexpr bool matches{
+      BlockTypeTraits<Layout, T>::matches &&
+      sizeof(typename BlockArray<T, N>::Element) ==
+          BlockArrayTraits<Layout, T>::stride};
+};
+
+// Column-major matrices are stored as arrays of column vectors
+template <BlockLayout Layout, glm::length_t C, glm::length_t R, typename T,
+          glm::qualifier Q>
+struct BlockTypeTraits<Layout, glm::mat<C, R, T, Q>>
+    : BlockTypeTraits<Layout, std::array<glm::vec<R, T, Q>, C>> {};
+/** @endcond */
+
+/**
+ * @brief Checks whether the members of a C++ struct are laid out as the
+ * members of a block with the given memory layout.
+ *
+ * The members must be given in order of declaration, without omissions. For
+ * example:
+ * @code
+ * struct ObjectBlock {
+ *   glm::vec4 color;
+ *   glm::vec2 translation;
+ *   float rotation;
+ *   float scale;
+ * };
+ * static_assert(abcg::isBlockLayout<abcg::BlockLayout::Std140, ObjectBlock>(
+ *     ABCG_BLOCK_FIELD(ObjectBlock, color),
+ *     ABCG_BLOCK_FIELD(ObjectBlock, translation),
+ *     ABCG_BLOCK_FIELD(ObjectBlock, rotation),
+ *     ABCG_BLOCK_FIELD(ObjectBlock, scale)));
+ * @endcode
+ *
+ * If the check fails, reorder the members or insert padding members. A `vec3`
+ * should be followed by a scalar or padded to 16 bytes, and arrays of scalars
+ * or 2-component vectors in std140 blocks should use abcg::BlockArray. A
+ * `mat3` is stored as three 16-byte columns and can be mirrored by a
+ * `glm::mat3x4`.
+ *
+ * @tparam Layout Memory layout of the block.
+ * @tparam TStruct C++ struct that mirrors the block.
+ * @tparam TFields Types of the members of the struct.
+ *
+ * @param fields Types and offsets of the members of the struct.
+ *
+ * @return `true` if the offset of each member and the size of each array are
+ * those given by the layout rules, and the struct is large enough to hold the
+ * block.
+ */
+template <BlockLayout Layout, typename TStruct, typename... TFields>
+consteval bool isBlockLayout(BlockField<TFields>... fields) {
+  std::size_t offset{};
+  bool matches{true};
+  auto const check{[&]<typename T>(BlockField<T> field) {
+    using Traits = BlockTypeTraits<Layout, std::remove_cv_t<T>>;
+    offset = alignBlockOffset(offset, Traits::alignment);
+    matches = matches && Traits::matches && field.offset == offset;
+    offset += Traits::size;
+  }};
+  (check(fields), ...);
+  return matches && offset <= sizeof(TStruct);
+}
+
+/**
+ * @brief Shortcut for abcg::isBlockLayout with abcg::BlockLayout::Std140.
+ */
+template <typename TStruct, typename... TFields>
+consteval bool isStd140(BlockField<TFields>... fields) {
+  return isBlockLayout<BlockLayout::Std140, TStruct>(fields...);
+}
+
+/**
+ * @brief Shortcut for abcg::isBlockLayout with abcg::BlockLayout::Std430.
+ */
+template <typename TStruct, typename... TFields>
+consteval bool isStd430(BlockField<TFields>... fields) {
+  return isBlockLayout<BlockLayout::Std430, TStruct>(fields...);
+}
+
+} // namespace abcg
+
+/**
+ * @brief Creates an abcg::BlockField with the type and offset of a member of a
+ * struct.
+ *
+ * @param Struct Name of the struct.
+ * @param member Name of the member.
+ */
+#define ABCG_BLOCK_FIELD(Struct, member)                                       \
+  abcg::BlockField<decltype(Struct::member)> { offsetof(Struct, member) }
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file abcgEventLog.cpp
+ * @brief Definition of abcg::EventLog members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgEventLog.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#include "abcgException.hpp"
+
+namespace {
+constexpr std::array<char, 8> magic{'A', 'B', 'C', 'G', 'L', 'O', 'G', '\0'};
+constexpr std::uint32_t version{1};
+constexpr std::uint32_t sdlVersion{SDL_COMPILEDVERSION};
+
+template <typename T> void write(std::ofstream &stream, T const &value) {
+  auto const bytes{std::bit_cast<std::array<char, sizeof(T)>>(value)};
+  stream.write(bytes.data(), bytes.size());
+}
+
+template <typename T> bool read(std::ifstream &stream, T &value) {
+  std::array<char, sizeof(T)> bytes{};
+  if (!stream.read(bytes.data(), bytes.size()))
+    return false;
+  value = std::bit_cast<T>(bytes);
+  return true;
+}
+
+// Events that contain pointers cannot be replayed
+bool isRecordable(SDL_Event const &event) {
+  switch (event.type) {
+  case SDL_SYSWMEVENT:
+  case SDL_DROPFILE:
+  case SDL_DROPTEXT:
+  case SDL_DROPBEGIN:
+  case SDL_DROPCOMPLETE:
+#if SDL_VERSION_ATLEAST(2, 0, 22)
+  case SDL_TEXTEDITING_EXT:
+#endif
+    return false;
+  default:
+    return event.type < SDL_USEREVENT;
+  }
+}
+
+// Makes the event refer to the window of the current session
+void setWindowID(SDL_Event &event, Uint32 windowID) {
+  switch (event.type) {
+  case SDL_WINDOWEVENT:
+    event.window.windowID = windowID;
+    break;
+  case SDL_KEYDOWN:
+  case SDL_KEYUP:
+    event.key.windowID = windowID;
+    break;
+  case SDL_TEXTEDITING:
+    event.edit.windowID = windowID;
+    break;
+  case SDL_TEXTINPUT:
+    event.text.windowID = windowID;
+    break;
+  case SDL_MOUSEMOTION:
+    event.motion.windowID = windowID;
+    break;
+  case SDL_MOUSEBUTTONDOWN:
+  case SDL_MOUSEBUTTONUP:
+    event.button.windowID = windowID;
+    break;
+  case SDL_MOUSEWHEEL:
+    event.wheel.windowID = windowID;
+    break;
+  default:
+    break;
+  }
+}
+} // namespace
+
+/**
+ * @brief Creates a log file for recording.
+ *
+ * @param path Path to the log file.
+ * @param seed Random seed of the session.
+ *
+ * @throw abcg::RuntimeError if the file cannot be created.
+ */
+void abcg::EventLog::openForWriting(std::string const &path,
+                                    std::uint64_t seed) {
+  m_output.open(path, std::ios::binary | std::ios::trunc);
+  if (!m_output) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to create event log {}", path));
+  }
+
+  write(m_output, magic);
+  write(m_output, version);
+  write(m_output, sdlVersion);
+  write(m_output, gsl::narrow<std::uint32_t>(sizeof(SDL_Event)));
+  write(m_output, seed);
+}
+
+/**
+ * @brief Opens a log file for replaying.
+ *
+ * @param path Path to the log file.
+ *
+ * @returns Random seed of the recorded session.
+ *
+ * @throw abcg::RuntimeError if the file cannot be opened or was recorded with
+ * an incompatible build.
+ */
+std::uint64_t abcg::EventLog::openForReading(std::string const &path) {
+  m_input.open(path, std::ios::binary);
+  if (!m_input) {
+    throw abcg::RuntimeError(fmt::format("Failed to open event log {}", path));
+  }
+
+  std::array<char, 8> fileMagic{};
+  std::uint32_t fileVersion{};
+  std::uint32_t fileSDLVersion{};
+  std::uint32_t eventSize{};
+  std::uint64_t seed{};
+  if (!read(m_input, fileMagic) || !read(m_input, fileVersion) ||
+      !read(m_input, fileSDLVersion) || !read(m_input, eventSize) ||
+      !read(m_input, seed) || fileMagic != magic) {
+    throw abcg::RuntimeError(fmt::format("Invalid event log {}", path));
+  }
+  if (fileVersion != version || fileSDLVersion != sdlVersion ||
+      eventSize != sizeof(SDL_Event)) {
+    throw abcg::RuntimeError(fmt::format(
+        "Event log {} was recorded with an incompatible build", path));
+  }
+
+  return seed;
+}
+
+/**
+ * @brief Returns whether the log is open for recording.
+ */
+bool abcg::EventLog::isRecording() const { return m_output.is_open(); }
+
+/**
+ * @brief Returns whether the log is open for replaying.
+ */
+bool abcg::EventLog::isReplaying() const { return m_input.is_open(); }
+
+/**
+ * @brief Writes the record of an iteration of the main loop.
+ *
+ * @param deltaTime Time increment of the iteration.
+ * @param events Events handled in the iteration. Events that contain pointers
+ * are skipped.
+ */
+void abcg::EventLog::writeFrame(Timer::clock::duration deltaTime,
+                                std::vector<SDL_Event> const &events) {
+  auto const numEvents{std::count_if(events.begin(), events.end(),
+                                     isRecordable)};
+  write(m_output, std::int64_t{deltaTime.count()});
+  write(m_output, gsl::narrow<std::uint32_t>(numEvents));
+  for (auto const &event : events) {
+    if (isRecordable(event)) {
+      write(m_output, event);
+    }
+  }
+}
+
+/**
+ * @brief Reads the record of the next iteration of the main loop.
+ *
+ * @param deltaTime Time increment of the iteration.
+ * @param events Events handled in the iteration.
+ * @param windowID ID of the window the events will be sent to.
+ *
+ * @returns `false` if the end of the log was reached; `true` otherwise.
+ */
+bool abcg::EventLog::readFrame(Timer::clock::duration &deltaTime,
+                               std::vector<SDL_Event> &events,
+                               Uint32 windowID) {
+  std::int64_t ticks{};
+  std::uint32_t numEvents{};
+  if (!read(m_input, ticks) || !read(m_input, numEvents))
+    return false;
+
+  deltaTime = Timer::clock::duration{ticks};
+  events.resize(numEvents);
+  for (auto &event : events) {
+    if (!read(m_input, event))
+      return false;
+    setWindowID(event, windowID);
+  }
+  return true;
+}
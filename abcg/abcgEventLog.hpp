@@ -0,0 +1,61 @@
+/**
+ * @file abcgEventLog.hpp
+ * @brief Header file of abcg::EventLog.
+ *
+ * Declaration of abcg::EventLog.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_EVENT_LOG_HPP_
+#define ABCG_EVENT_LOG_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "abcgExternal.hpp"
+#include "abcgTimer.hpp"
+
+namespace abcg {
+class EventLog;
+} // namespace abcg
+
+/**
+ * @brief Binary log of SDL events and frame times.
+ *
+ * The log starts with a header containing a random seed, followed by one
+ * record per iteration of the main loop. Each record contains the time
+ * increment of the iteration and the SDL events handled in it.
+ *
+ * SDL events that contain pointers (drag-and-drop, system window manager and
+ * user events) are not recorded. Events are stored as raw SDL_Event
+ * structures, and thus a log can only be replayed by an application built
+ * with the same SDL version on the same platform.
+ *
+ * @sa abcg::Application::Application for the command-line options `--record`
+ * and `--replay`.
+ */
+class abcg::EventLog {
+public:
+  void openForWriting(std::string const &path, std::uint64_t seed);
+  std::uint64_t openForReading(std::string const &path);
+
+  [[nodiscard]] bool isRecording() const;
+  [[nodiscard]] bool isReplaying() const;
+
+  void writeFrame(Timer::clock::duration deltaTime,
+                  std::vector<SDL_Event> const &events);
+  bool readFrame(Timer::clock::duration &deltaTime,
+                 std::vector<SDL_Event> &events, Uint32 windowID);
+
+private:
+  std::ofstream m_output;
+  std::ifstream m_input;
+};
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file abcgFileWatcher.cpp
+ * @brief Definition of abcg::FileWatcher members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFileWatcher.hpp"
+
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define ABCG_FILE_WATCHER_INOTIFY
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#endif
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+
+struct abcg::FileWatcher::State {
+  std::mutex mutex;
+  std::set<std::filesystem::path> changedFiles;
+  Callback onChange;
+  std::thread thread;
+#if defined(ABCG_FILE_WATCHER_INOTIFY)
+  int inotifyFD{-1};
+  std::array<int, 2> stopPipe{-1, -1};
+  // Watched directory of each watch descriptor
+  std::unordered_map<int, std::filesystem::path> directories;
+
+  void addWatch(std::filesystem::path const &directory);
+  void addWatchRecursive(std::filesystem::path const &directory);
+  void run();
+#endif
+};
+
+#if defined(ABCG_FILE_WATCHER_INOTIFY)
+void abcg::FileWatcher::State::addWatch(
+    std::filesystem::path const &directory) {
+  auto const mask{IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR};
+  if (auto const descriptor{
+          inotify_add_watch(inotifyFD, directory.c_str(), mask)};
+      descriptor >= 0) {
+    directories[descriptor] = directory;
+  }
+}
+
+void abcg::FileWatcher::State::addWatchRecursive(
+    std::filesystem::path const &directory) {
+  addWatch(directory);
+  std::error_code error;
+  for (auto const &entry :
+       std::filesystem::recursive_directory_iterator(directory, error)) {
+    if (entry.is_directory(error)) {
+      addWatch(entry.path());
+    }
+  }
+}
+
+void abcg::FileWatcher::State::run() {
+  std::array<pollfd, 2> descriptors{
+      {{.fd = inotifyFD, .events = POLLIN, .revents = 0},
+       {.fd = stopPipe[0], .events = POLLIN, .revents = 0}}};
+
+  // Buffer aligned for reading inotify_event structures
+  alignas(inotify_event) std::array<char, 4096> buffer{};
+
+  while (true) {
+    if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    if ((descriptors[1].revents & POLLIN) != 0)
+      break;
+    if ((descriptors[0].revents & POLLIN) == 0)
+      continue;
+
+    auto const length{::read(inotifyFD, buffer.data(), buffer.size())};
+    if (length <= 0)
+      continue;
+
+    std::vector<std::filesystem::path> files;
+    for (std::size_t offset{}; offset < gsl::narrow<std::size_t>(length);) {
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      auto const *event{reinterpret_cast<inotify_event const *>(
+          std::next(buffer.data(), gsl::narrow<std::ptrdiff_t>(offset)))};
+      offset += sizeof(inotify_event) + event->len;
+
+      auto const directory{directories.find(event->wd)};
+      if (directory == directories.end() || event->len == 0)
+        continue;
+
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+      auto const path{directory->second / event->name};
+      if ((event->mask & IN_ISDIR) != 0U) {
+        if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0U) {
+          addWatchRecursive(path);
+        }
+      } else if ((event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0U) {
+        files.push_back(path);
+      }
+    }
+
+    if (files.empty())
+      continue;
+
+    bool notify{};
+    {
+      std::scoped_lock const lock{mutex};
+      notify = changedFiles.empty();
+      changedFiles.insert(files.begin(), files.end());
+    }
+    if (notify && onChange) {
+      onChange();
+    }
+  }
+}
+#endif
+
+/**
+ * @brief Constructs an inactive file watcher.
+ */
+abcg::FileWatcher::FileWatcher() : m_state{std::make_unique<State>()} {}
+
+/**
+ * @brief Move constructor.
+ */
+abcg::FileWatcher::FileWatcher(FileWatcher &&) noexcept = default;
+
+/**
+ * @brief Move assignment.
+ */
+abcg::FileWatcher &
+abcg::FileWatcher::operator=(FileWatcher &&) noexcept = default;
+
+/**
+ * @brief Destructor. Stops watching.
+ */
+abcg::FileWatcher::~FileWatcher() {
+  if (m_state) {
+    stop();
+  }
+}
+
+/**
+ * @brief Starts watching a directory and its subdirectories.
+ *
+ * If the watcher is already active, it is stopped first. This does nothing if
+ * file watching is not supported.
+ *
+ * @param directory Path to the directory.
+ * @param onChange Function called by the watcher thread when files are
+ * modified. It must be thread-safe (e.g., it can call `SDL_PushEvent`).
+ *
+ * @throw abcg::RuntimeError if the watcher could not be created.
+ */
+void abcg::FileWatcher::start(std::filesystem::path const &directory,
+                              Callback const &onChange) {
+  stop();
+#if defined(ABCG_FILE_WATCHER_INOTIFY)
+  m_state->inotifyFD = inotify_init1(IN_CLOEXEC);
+  if (m_state->inotifyFD < 0) {
+    throw abcg::RuntimeError("Failed to initialize inotify");
+  }
+  if (pipe(m_state->stopPipe.data()) != 0) {
+    close(m_state->inotifyFD);
+    m_state->inotifyFD = -1;
+    throw abcg::RuntimeError("Failed to create pipe for the file watcher");
+  }
+
+  m_state->onChange = onChange;
+  m_state->addWatchRecursive(directory);
+  m_state->thread = std::thread{[state = m_state.get()] { state->run(); }};
+#else
+  (void)directory;
+  (void)onChange;
+#endif
+}
+
+/**
+ * @brief Stops watching and joins the watcher thread.
+ *
+ * Modified files not yet taken are discarded.
+ */
+void abcg::FileWatcher::stop() {
+#if defined(ABCG_FILE_WATCHER_INOTIFY)
+  if (m_state->thread.joinable()) {
+    char const wake{};
+    [[maybe_unused]] auto const written{write(m_state->stopPipe[1], &wake, 1)};
+    m_state->thread.join();
+  }
+  for (auto &descriptor : m_state->stopPipe) {
+    if (descriptor >= 0) {
+      close(descriptor);
+      descriptor = -1;
+    }
+  }
+  if (m_state->inotifyFD >= 0) {
+    close(m_state->inotifyFD);
+    m_state->inotifyFD = -1;
+  }
+  m_state->directories.clear();
+#endif
+  std::scoped_lock const lock{m_state->mutex};
+  m_state->changedFiles.clear();
+}
+
+/**
+ * @brief Returns whether the watcher is watching a directory.
+ */
+bool abcg::FileWatcher::isActive() const noexcept {
+  return m_state->thread.joinable();
+}
+
+/**
+ * @brief Returns the files modified since the last call and clears the list.
+ *
+ * @returns Paths of the modified files, each reported once.
+ */
+std::vector<std::filesystem::path> abcg::FileWatcher::takeChangedFiles() {
+  std::scoped_lock const lock{m_state->mutex};
+  std::vector<std::filesystem::path> files{m_state->changedFiles.begin(),
+                                           m_state->changedFiles.end()};
+  m_state->changedFiles.clear();
+  return files;
+}
+
+/**
+ * @brief Returns whether file watching is supported on this platform.
+ *
+ * This is `true` only on Linux.
+ */
+bool abcg::FileWatcher::isSupported() noexcept {
+#if defined(ABCG_FILE_WATCHER_INOTIFY)
+  return true;
+#else
+  return false;
+#endif
+}
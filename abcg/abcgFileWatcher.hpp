@@ -0,0 +1,67 @@
+/**
+ * @file abcgFileWatcher.hpp
+ * @brief Header file of abcg::FileWatcher.
+ *
+ * Declaration of abcg::FileWatcher.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FILE_WATCHER_HPP_
+#define ABCG_FILE_WATCHER_HPP_
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace abcg {
+class FileWatcher;
+} // namespace abcg
+
+/**
+ * @brief Watches a directory tree for modified files.
+ *
+ * On Linux, the directory and its subdirectories are watched with inotify by a
+ * background thread that sleeps until the kernel reports a change, so the
+ * filesystem is not polled. A file is reported when it is closed after being
+ * written, or when it is moved into a watched directory, which is how most
+ * editors save files. On other platforms, no file is ever reported.
+ *
+ * @sa abcg::WindowSettings::hotReload.
+ */
+class abcg::FileWatcher {
+public:
+  /**
+   * @brief Function called by the watcher thread when files are modified.
+   *
+   * It is called only when the set of modified files not yet taken with
+   * abcg::FileWatcher::takeChangedFiles becomes non-empty.
+   */
+  using Callback = std::function<void()>;
+
+  FileWatcher();
+  FileWatcher(FileWatcher const &) = delete;
+  FileWatcher(FileWatcher &&) noexcept;
+  FileWatcher &operator=(FileWatcher const &) = delete;
+  FileWatcher &operator=(FileWatcher &&) noexcept;
+  ~FileWatcher();
+
+  void start(std::filesystem::path const &directory,
+             Callback const &onChange = {});
+  void stop();
+
+  [[nodiscard]] bool isActive() const noexcept;
+  [[nodiscard]] std::vector<std::filesystem::path> takeChangedFiles();
+
+  [[nodiscard]] static bool isSupported() noexcept;
+
+private:
+  struct State;
+  std::unique_ptr<State> m_state;
+};
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * @file abcgFrameLimiter.cpp
+ * @brief Definition of abcg::FrameLimiter members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFrameLimiter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using namespace std::chrono;
+
+namespace {
+// Smoothing factor of the exponential moving averages
+constexpr double smoothing{0.05};
+
+template <typename Rep, typename Period>
+double toSeconds(duration<Rep, Period> const &time) {
+  return duration_cast<duration<double>>(time).count();
+}
+} // namespace
+
+/**
+ * @brief Sets the target frame rate.
+ *
+ * @param frameRate Target frame rate, in frames per second. If zero or
+ * negative, abcg::FrameLimiter::wait does not block.
+ */
+void abcg::FrameLimiter::setTargetFrameRate(double frameRate) noexcept {
+  if (frameRate != m_targetFrameRate) {
+    // Restart the frame cadence from the last frame
+    m_deadline = m_lastWakeUp;
+  }
+  m_targetFrameRate = frameRate;
+}
+
+/**
+ * @brief Returns the target frame rate.
+ *
+ * @returns Target frame rate, in frames per second, or zero if the frame rate
+ * is unlimited.
+ */
+double abcg::FrameLimiter::getTargetFrameRate() const noexcept {
+  return m_targetFrameRate;
+}
+
+/**
+ * @brief Restarts the frame cadence and clears the statistics.
+ */
+void abcg::FrameLimiter::reset() {
+  m_lastWakeUp = clock::now();
+  m_deadline = m_lastWakeUp;
+  m_meanFramePeriod = 0.0;
+  m_jitter = 0.0;
+  m_cpuUsage = 1.0;
+}
+
+/**
+ * @brief Blocks until the end of the current frame period.
+ *
+ * This must be called once per frame. If the end of the current frame period
+ * has already passed, the function returns immediately and the cadence is
+ * restarted from the current time instead of trying to catch up.
+ *
+ * In WebAssembly builds, the frame rate is controlled by the browser and this
+ * function only updates the statistics.
+ */
+void abcg::FrameLimiter::wait() {
+  auto busyUntil{clock::now()};
+
+#if !defined(__EMSCRIPTEN__)
+  if (m_targetFrameRate > 0.0) {
+    m_deadline +=
+        duration_cast<clock::duration>(duration<double>{1.0 / m_targetFrameRate});
+    if (m_deadline < busyUntil) {
+      m_deadline = busyUntil;
+    } else {
+      // Spinning keeps the CPU busy
+      auto const spinTime{sleepUntil(m_deadline)};
+      busyUntil += spinTime;
+    }
+  }
+#endif
+
+  auto const now{clock::now()};
+  auto const framePeriod{toSeconds(now - m_lastWakeUp)};
+  auto const busyTime{toSeconds(busyUntil - m_lastWakeUp)};
+  m_lastWakeUp = now;
+
+  auto const expectedPeriod{m_targetFrameRate > 0.0 ? 1.0 / m_targetFrameRate
+                                                    : m_meanFramePeriod};
+  m_jitter += smoothing * (std::abs(framePeriod - expectedPeriod) - m_jitter);
+  m_meanFramePeriod += smoothing * (framePeriod - m_meanFramePeriod);
+  if (framePeriod > 0.0) {
+    m_cpuUsage += smoothing * (busyTime / framePeriod - m_cpuUsage);
+  }
+}
+
+/**
+ * @brief Returns the frame pacing jitter.
+ *
+ * @returns Moving average of the absolute difference, in seconds, between the
+ * actual frame period and the target frame period (or the mean frame period if
+ * the frame rate is unlimited).
+ */
+double abcg::FrameLimiter::getJitter() const noexcept { return m_jitter; }
+
+/**
+ * @brief Returns the fraction of the frame period in which the CPU is busy.
+ *
+ * This is the time spent outside abcg::FrameLimiter::wait plus the time spent
+ * spinning inside it. The time spent sleeping is not included.
+ *
+ * @returns Moving average of the CPU usage of the rendering loop, in the range
+ * [0, 1]. It is 1 if the frame rate is unlimited.
+ */
+double abcg::FrameLimiter::getCPUUsage() const noexcept { return m_cpuUsage; }
+
+// Returns the time spent spinning
+abcg::FrameLimiter::clock::duration
+abcg::FrameLimiter::sleepUntil(clock::time_point deadline) {
+  // Sleep in short steps while the remaining time is larger than the expected
+  // duration of a step, then spin for the rest of the period
+  auto const step{milliseconds{1}};
+  while (true) {
+    auto const start{clock::now()};
+    auto const remaining{toSeconds(deadline - start)};
+    auto const margin{m_sleepMean + 2.0 * std::sqrt(m_sleepVariance)};
+    if (remaining <= margin)
+      break;
+
+    std::this_thread::sleep_for(step);
+
+    auto const delta{toSeconds(clock::now() - start) - m_sleepMean};
+    m_sleepMean += smoothing * delta;
+    m_sleepVariance =
+        (1.0 - smoothing) * (m_sleepVariance + smoothing * delta * delta);
+  }
+
+  auto const spinStart{clock::now()};
+  while (clock::now() < deadline) {
+    // Spin
+  }
+  return std::max(clock::now() - spinStart, clock::duration::zero());
+}
@@ -0,0 +1,65 @@
+/**
+ * @file abcgFrameLimiter.hpp
+ * @brief Header file of abcg::FrameLimiter.
+ *
+ * Declaration of abcg::FrameLimiter.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAME_LIMITER_HPP_
+#define ABCG_FRAME_LIMITER_HPP_
+
+#include <chrono>
+
+namespace abcg {
+class FrameLimiter;
+} // namespace abcg
+
+/**
+ * @brief Limits the rate of the rendering loop to a target frame rate.
+ *
+ * abcg::FrameLimiter::wait blocks the calling thread until the end of the
+ * current frame period. Most of the remaining time is spent sleeping, and only
+ * a small fraction at the end of the period is spent spinning. The length of
+ * this fraction is adjusted at runtime from the observed accuracy of the
+ * operating system scheduler, so that frame pacing stays tight without
+ * spending the whole frame in a busy loop.
+ *
+ * @sa abcg::WindowSettings::targetFrameRate.
+ */
+class abcg::FrameLimiter {
+public:
+  void setTargetFrameRate(double frameRate) noexcept;
+  [[nodiscard]] double getTargetFrameRate() const noexcept;
+
+  void reset();
+  void wait();
+
+  [[nodiscard]] double getJitter() const noexcept;
+  [[nodiscard]] double getCPUUsage() const noexcept;
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  clock::duration sleepUntil(clock::time_point deadline);
+
+  double m_targetFrameRate{};
+
+  clock::time_point m_lastWakeUp{clock::now()};
+  clock::time_point m_deadline{m_lastWakeUp};
+
+  // Statistics of the actual duration of short sleeps, in seconds
+  double m_sleepMean{0.005};
+  double m_sleepVariance{};
+
+  // Smoothed frame statistics
+  double m_meanFramePeriod{};
+  double m_jitter{};
+  double m_cpuUsage{1.0};
+};
+
+#endif
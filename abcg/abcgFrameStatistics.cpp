@@ -0,0 +1,201 @@
+/**
+ * @file abcgFrameStatistics.cpp
+ * @brief Definition of abcg::FrameStatistics members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgFrameStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "abcgExternal.hpp"
+
+/**
+ * @brief Adds the duration of a frame to the window.
+ *
+ * If the window is full, the oldest frame time is discarded.
+ *
+ * @param frameTime Frame time, in seconds.
+ */
+void abcg::FrameStatistics::addFrameTime(double frameTime) {
+  if (m_frameTimes.size() < m_windowSize) {
+    m_frameTimes.push_back(frameTime);
+  } else {
+    m_sum -= m_frameTimes.at(m_offset);
+    m_frameTimes.at(m_offset) = frameTime;
+    m_offset = (m_offset + 1) % m_windowSize;
+  }
+  m_sum += frameTime;
+  m_sorted = false;
+}
+
+/**
+ * @brief Sets the maximum number of frames in the window.
+ *
+ * Changing the size of the window discards the current frame times.
+ *
+ * @param size Number of frames. Must be greater than zero.
+ */
+void abcg::FrameStatistics::setWindowSize(std::size_t size) {
+  size = std::max<std::size_t>(size, 1);
+  if (size == m_windowSize)
+    return;
+  m_windowSize = size;
+  reset();
+}
+
+/**
+ * @brief Discards all frame times.
+ */
+void abcg::FrameStatistics::reset() {
+  m_frameTimes.clear();
+  m_sortedFrameTimes.clear();
+  m_offset = 0;
+  m_sum = 0.0;
+  m_sorted = true;
+}
+
+/**
+ * @brief Returns the maximum number of frames in the window.
+ */
+std::size_t abcg::FrameStatistics::getWindowSize() const noexcept {
+  return m_windowSize;
+}
+
+/**
+ * @brief Returns the number of frames currently in the window.
+ */
+std::size_t abcg::FrameStatistics::getFrameCount() const noexcept {
+  return m_frameTimes.size();
+}
+
+/**
+ * @brief Returns the frame times in the window.
+ *
+ * @returns Frame times, in seconds, from the oldest to the most recent.
+ */
+std::vector<double> abcg::FrameStatistics::getFrameTimes() const {
+  std::vector<double> frameTimes;
+  frameTimes.reserve(m_frameTimes.size());
+  auto const offset{gsl::narrow<std::ptrdiff_t>(m_offset)};
+  frameTimes.insert(frameTimes.end(), m_frameTimes.begin() + offset,
+                    m_frameTimes.end());
+  frameTimes.insert(frameTimes.end(), m_frameTimes.begin(),
+                    m_frameTimes.begin() + offset);
+  return frameTimes;
+}
+
+/**
+ * @brief Returns the average frame time, or zero if the window is empty.
+ */
+double abcg::FrameStatistics::getAverage() const noexcept {
+  if (m_frameTimes.empty())
+    return 0.0;
+  return m_sum / gsl::narrow_cast<double>(m_frameTimes.size());
+}
+
+/**
+ * @brief Returns the maximum frame time, or zero if the window is empty.
+ */
+double abcg::FrameStatistics::getMaximum() const {
+  auto const &sorted{getSortedFrameTimes()};
+  return sorted.empty() ? 0.0 : sorted.back();
+}
+
+/**
+ * @brief Returns a percentile of the frame times.
+ *
+ * The percentile is computed with the nearest-rank method.
+ *
+ * @param percentile Percentile in the range [0, 100], e.g., 50 for the
+ * median, 99 for the time that is exceeded by only 1% of the frames.
+ *
+ * @returns Frame time, in seconds, or zero if the window is empty.
+ */
+double abcg::FrameStatistics::getPercentile(double percentile) const {
+  auto const &sorted{getSortedFrameTimes()};
+  if (sorted.empty())
+    return 0.0;
+
+  auto const rank{std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 *
+                            gsl::narrow_cast<double>(sorted.size()))};
+  auto const index{std::clamp(gsl::narrow_cast<std::size_t>(rank),
+                              std::size_t{1}, sorted.size()) -
+                   1};
+  return sorted.at(index);
+}
+
+/**
+ * @brief Returns the number of hitches in the window.
+ *
+ * A hitch is a frame that takes longer than a multiple of the median frame
+ * time.
+ *
+ * @param factor Multiple of the median frame time above which a frame is
+ * considered a hitch.
+ *
+ * @returns Number of hitches.
+ */
+std::size_t abcg::FrameStatistics::getHitchCount(double factor) const {
+  auto const &sorted{getSortedFrameTimes()};
+  auto const threshold{getPercentile(50.0) * factor};
+  auto const first{std::ranges::upper_bound(sorted, threshold)};
+  return gsl::narrow<std::size_t>(std::distance(first, sorted.end()));
+}
+
+/**
+ * @brief Returns the distribution of the frame times.
+ *
+ * @param numBins Number of bins of equal width.
+ * @param maxTime Upper bound of the last bin, in seconds. Frame times greater
+ * than this are counted in the last bin.
+ *
+ * @returns Number of frames in each bin.
+ */
+std::vector<std::size_t>
+abcg::FrameStatistics::getHistogram(std::size_t numBins, double maxTime) const {
+  std::vector<std::size_t> histogram(numBins);
+  getHistogram(histogram, maxTime);
+  return histogram;
+}
+
+/**
+ * @brief Computes the distribution of the frame times into a given array.
+ *
+ * This is the same as the overload that returns a vector, but does not
+ * allocate memory, so it can be called every frame.
+ *
+ * @param histogram Array that receives the number of frames in each bin. The
+ * number of bins is the size of the array.
+ * @param maxTime Upper bound of the last bin, in seconds. Frame times greater
+ * than this are counted in the last bin.
+ */
+void abcg::FrameStatistics::getHistogram(std::span<std::size_t> histogram,
+                                         double maxTime) const {
+  std::ranges::fill(histogram, 0);
+  auto const numBins{histogram.size()};
+  if (numBins == 0 || maxTime <= 0.0)
+    return;
+
+  auto const binsPerSecond{gsl::narrow_cast<double>(numBins) / maxTime};
+  for (auto const frameTime : m_frameTimes) {
+    auto const bin{gsl::narrow_cast<std::size_t>(
+        std::max(frameTime * binsPerSecond, 0.0))};
+    ++histogram[std::min(bin, numBins - 1)];
+  }
+}
+
+std::vector<double> const &
+abcg::FrameStatistics::getSortedFrameTimes() const {
+  if (!m_sorted) {
+    m_sortedFrameTimes = m_frameTimes;
+    std::ranges::sort(m_sortedFrameTimes);
+    m_sorted = true;
+  }
+  return m_sortedFrameTimes;
+}
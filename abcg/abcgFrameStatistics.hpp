@@ -0,0 +1,67 @@
+/**
+ * @file abcgFrameStatistics.hpp
+ * @brief Header file of abcg::FrameStatistics.
+ *
+ * Declaration of abcg::FrameStatistics.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_FRAME_STATISTICS_HPP_
+#define ABCG_FRAME_STATISTICS_HPP_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace abcg {
+class FrameStatistics;
+} // namespace abcg
+
+/**
+ * @brief Statistics of the frame times over a sliding window of frames.
+ *
+ * Unlike an average frame rate, percentiles and hitch counts reveal stutter:
+ * a single 50 ms frame among a hundred 16 ms frames barely changes the
+ * average, but shows up in the maximum and in the 99th percentile.
+ *
+ * All times are in seconds.
+ *
+ * @sa abcg::Window::getFrameStatistics.
+ * @sa abcg::WindowSettings::frameStatisticsSize.
+ */
+class abcg::FrameStatistics {
+public:
+  void addFrameTime(double frameTime);
+  void setWindowSize(std::size_t size);
+  void reset();
+
+  [[nodiscard]] std::size_t getWindowSize() const noexcept;
+  [[nodiscard]] std::size_t getFrameCount() const noexcept;
+  [[nodiscard]] std::vector<double> getFrameTimes() const;
+
+  [[nodiscard]] double getAverage() const noexcept;
+  [[nodiscard]] double getMaximum() const;
+  [[nodiscard]] double getPercentile(double percentile) const;
+  [[nodiscard]] std::size_t getHitchCount(double factor = 2.0) const;
+  [[nodiscard]] std::vector<std::size_t> getHistogram(std::size_t numBins,
+                                                      double maxTime) const;
+  void getHistogram(std::span<std::size_t> histogram, double maxTime) const;
+
+private:
+  [[nodiscard]] std::vector<double> const &getSortedFrameTimes() const;
+
+  std::vector<double> m_frameTimes;
+  std::size_t m_windowSize{300};
+  std::size_t m_offset{};
+  double m_sum{};
+
+  // Cache of the sorted frame times
+  mutable std::vector<double> m_sortedFrameTimes;
+  mutable bool m_sorted{true};
+};
+
+#endif
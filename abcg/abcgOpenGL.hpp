@@ -15,7 +15,14 @@
 
 #include "abcg.hpp"
 #include "abcgOpenGLImage.hpp"
+#include "abcgOpenGLProgram.hpp"
+#include "abcgOpenGLProgramBuildJob.hpp"
+#include "abcgOpenGLProgramCache.hpp"
+#include "abcgOpenGLProgramVariants.hpp"
 #include "abcgOpenGLShader.hpp"
+#include "abcgOpenGLStateCache.hpp"
+#include "abcgOpenGLStreamBuffer.hpp"
+#include "abcgOpenGLUniformBuffer.hpp"
 #include "abcgOpenGLWindow.hpp"
 
 #endif
@@ -0,0 +1,466 @@
+/**
+ * @file abcgOpenGLCapture.cpp
+ * @brief Definition of functions for capturing OpenGL calls to a file.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#if !defined(__EMSCRIPTEN__)
+
+#include "abcgOpenGLCapture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgOpenGLCounters.hpp"
+
+namespace {
+// How the data pointed to by a pointer argument is captured
+enum class PayloadType { Unknown, Bytes, CString, Strings, Offset };
+
+struct Payload {
+  PayloadType type{PayloadType::Unknown};
+  // Number of bytes, or number of strings if type is Strings
+  std::int64_t size{};
+};
+
+struct CapturedFunction {
+  std::string_view name;
+  bool written{};
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::ofstream captureStream;
+std::vector<CapturedFunction> capturedFunctions;
+std::unordered_map<void const *, std::uint16_t> functionIds;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+template <typename T> void write(T const &value) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  captureStream.write(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+void writeBytes(void const *data, std::size_t size) {
+  write(static_cast<std::uint64_t>(size));
+  captureStream.write(static_cast<char const *>(data),
+                      gsl::narrow<std::streamsize>(size));
+}
+
+void writeKind(abcg::OpenGLCaptureKind kind) { write(kind); }
+
+// Converts a size given as a signed argument, treating negative sizes as zero
+std::size_t toSize(std::int64_t size) {
+  return gsl::narrow<std::size_t>(std::max<std::int64_t>(size, 0));
+}
+
+// Returns the current pixel storage modes of texture uploads. They are queried
+// instead of tracked, as they may also be set by code that does not use the
+// function wrappers.
+abcg::OpenGLUnpackState getUnpackState(bool image3D) {
+  abcg::OpenGLUnpackState state;
+  ::glGetIntegerv(GL_UNPACK_ALIGNMENT, &state.alignment);
+  ::glGetIntegerv(GL_UNPACK_ROW_LENGTH, &state.rowLength);
+  ::glGetIntegerv(GL_UNPACK_SKIP_PIXELS, &state.skipPixels);
+  ::glGetIntegerv(GL_UNPACK_SKIP_ROWS, &state.skipRows);
+  if (image3D) {
+    ::glGetIntegerv(GL_UNPACK_IMAGE_HEIGHT, &state.imageHeight);
+    ::glGetIntegerv(GL_UNPACK_SKIP_IMAGES, &state.skipImages);
+  }
+  return state;
+}
+
+// Returns the number of values of the array parameter of glTexParameter*v,
+// glSamplerParameter*v and glClearBuffer*v
+std::int64_t getParameterCount(std::string_view name, GLenum pname) {
+  if (name.starts_with("glClearBuffer")) {
+    // Depth and stencil buffers have a single value
+    return pname == GL_COLOR ? 4 : 1;
+  }
+  switch (pname) {
+  case GL_TEXTURE_BORDER_COLOR:
+  case GL_TEXTURE_SWIZZLE_RGBA:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+// Returns how the pointer argument at the given index is captured
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+Payload getPayload(std::string_view name, std::size_t index,
+                   std::span<abcg::OpenGLCaptureValue const> args) {
+  auto const arg{[&args](std::size_t argIndex) {
+    return static_cast<std::int64_t>(args[argIndex].bits);
+  }};
+  auto const bytes{[](std::int64_t size) {
+    return Payload{.type = PayloadType::Bytes, .size = size};
+  }};
+  auto const pixels{[&arg, &bytes](std::size_t width, std::size_t height,
+                                   std::size_t depth, std::size_t format,
+                                   std::size_t type) {
+    // The pointer is an offset into the pixel unpack buffer, if one is bound
+    GLint unpackBuffer{};
+    ::glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+    if (unpackBuffer != 0) {
+      return Payload{.type = PayloadType::Offset};
+    }
+    auto const image3D{depth != 0};
+    return bytes(gsl::narrow<std::int64_t>(abcg::getOpenGLPixelDataSize(
+        gsl::narrow_cast<GLsizei>(arg(width)),
+        gsl::narrow_cast<GLsizei>(arg(height)),
+        gsl::narrow_cast<GLsizei>(image3D ? arg(depth) : 1),
+        gsl::narrow_cast<GLenum>(arg(format)),
+        gsl::narrow_cast<GLenum>(arg(type)), getUnpackState(image3D))));
+  }};
+  auto const digit{[](char character) {
+    return static_cast<std::int64_t>(character - '0');
+  }};
+
+  // Buffer and texture data
+  if ((name == "glBufferData" || name == "glBufferStorage") && index == 2)
+    return bytes(arg(1));
+  if (name == "glBufferSubData" && index == 3)
+    return bytes(arg(2));
+  // Indices of the width, height, depth (zero if 2D), format and type
+  if (name == "glTexImage2D" && index == 8)
+    return pixels(3, 4, 0, 6, 7);
+  if (name == "glTexSubImage2D" && index == 8)
+    return pixels(4, 5, 0, 6, 7);
+  if (name == "glTexImage3D" && index == 9)
+    return pixels(3, 4, 5, 7, 8);
+  if (name == "glTexSubImage3D" && index == 10)
+    return pixels(5, 6, 7, 8, 9);
+  if (name == "glCompressedTexImage2D" && index == 7)
+    return bytes(arg(6));
+  if (name == "glCompressedTexSubImage2D" && index == 8)
+    return bytes(arg(7));
+  if (name == "glCompressedTexImage3D" && index == 8)
+    return bytes(arg(7));
+  if (name == "glCompressedTexSubImage3D" && index == 10)
+    return bytes(arg(9));
+
+  // Uniforms and vertex attributes, e.g., glUniform4fv and glUniformMatrix3fv
+  if (name.starts_with("glUniformMatrix") && index == 3) {
+    auto const size{name.substr(15)};
+    auto const elements{size[1] == 'x' ? digit(size[0]) * digit(size[2])
+                                       : digit(size[0]) * digit(size[0])};
+    return bytes(arg(1) * elements * 4);
+  }
+  if (name.starts_with("glUniform") && name.ends_with("v") && index == 2) {
+    return bytes(arg(1) * digit(name[9]) * 4);
+  }
+  if (name.starts_with("glVertexAttrib") && name.ends_with("v") &&
+      index == 1) {
+    auto const components{name.starts_with("glVertexAttribI")
+                              ? digit(name[15])
+                              : digit(name[14])};
+    return bytes(components * 4);
+  }
+  if ((name.starts_with("glTexParameter") ||
+       name.starts_with("glSamplerParameter")) &&
+      index == 2) {
+    return bytes(getParameterCount(name, gsl::narrow_cast<GLenum>(arg(1))) *
+                 4);
+  }
+  if (name.starts_with("glClearBuffer") && index == 2) {
+    return bytes(getParameterCount(name, gsl::narrow_cast<GLenum>(arg(0))) *
+                 4);
+  }
+
+  // Arrays of names and enumerators
+  if (name.starts_with("glDelete") && index == 1)
+    return bytes(arg(0) * 4);
+  if (name == "glDrawBuffers" && index == 1)
+    return bytes(arg(0) * 4);
+  if (name.starts_with("glInvalidate") && index == 2)
+    return bytes(arg(1) * 4);
+  if (name == "glGetActiveUniformsiv" && index == 2)
+    return bytes(arg(1) * 4);
+  if (name == "glShaderBinary" && index == 1)
+    return bytes(arg(0) * 4);
+
+  // Binaries and strings
+  if (name == "glShaderBinary" && index == 3)
+    return bytes(arg(4));
+  if (name == "glProgramBinary" && index == 2)
+    return bytes(arg(3));
+  if ((name == "glShaderSource" || name == "glTransformFeedbackVaryings" ||
+       name == "glGetUniformIndices") &&
+      index == 2) {
+    return {.type = PayloadType::Strings, .size = arg(1)};
+  }
+  if ((name == "glBindAttribLocation" || name == "glBindFragDataLocation") &&
+      index == 2) {
+    return {.type = PayloadType::CString};
+  }
+  if ((name == "glGetAttribLocation" || name == "glGetUniformLocation" ||
+       name == "glGetUniformBlockIndex" || name == "glGetFragDataLocation") &&
+      index == 1) {
+    return {.type = PayloadType::CString};
+  }
+
+  // Offsets into the bound buffer objects
+  if (name == "glVertexAttribPointer" || name == "glVertexAttribIPointer" ||
+      name.starts_with("glDrawElements") || name == "glDrawRangeElements") {
+    return {.type = PayloadType::Offset};
+  }
+
+  return {};
+}
+
+void writeStrings(std::string_view name, std::int64_t count,
+                  std::span<abcg::OpenGLCaptureValue const> args) {
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto const *const *strings{
+      reinterpret_cast<GLchar const *const *>(args[2].bits)};
+  // glShaderSource may give the length of each string
+  auto const *lengths{name == "glShaderSource"
+                          ? reinterpret_cast<GLint const *>(args[3].bits)
+                          : nullptr};
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+  auto const stringCount{toSize(count)};
+  writeKind(abcg::OpenGLCaptureKind::Strings);
+  write(gsl::narrow<std::uint32_t>(stringCount));
+  for (auto const index : iter::range(stringCount)) {
+    auto const *string{std::span{strings, stringCount}[index]};
+    auto const length{
+        lengths != nullptr && std::span{lengths, stringCount}[index] >= 0
+            ? gsl::narrow<std::size_t>(std::span{lengths, stringCount}[index])
+            : std::strlen(string)};
+    write(gsl::narrow<std::uint32_t>(length));
+    captureStream.write(string, gsl::narrow<std::streamsize>(length));
+  }
+}
+
+void writeArgument(std::string_view name, std::size_t index,
+                   std::span<abcg::OpenGLCaptureValue const> args) {
+  using Type = abcg::OpenGLCaptureValue::Type;
+  using Kind = abcg::OpenGLCaptureKind;
+
+  auto const &value{args[index]};
+  switch (value.type) {
+  case Type::None:
+    writeKind(Kind::None);
+    return;
+  case Type::Integer:
+    writeKind(Kind::Integer);
+    write(value.bits);
+    return;
+  case Type::Float:
+    writeKind(Kind::Float);
+    write(value.bits);
+    return;
+  case Type::Sync:
+    writeKind(Kind::Sync);
+    write(value.bits);
+    return;
+  case Type::ConstPointer:
+  case Type::Pointer:
+    break;
+  }
+
+  auto const payload{getPayload(name, index, args)};
+  if (payload.type == PayloadType::Offset) {
+    writeKind(Kind::Offset);
+    write(value.bits);
+    return;
+  }
+  if (value.bits == 0) {
+    writeKind(Kind::None);
+    return;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  auto const *data{reinterpret_cast<char const *>(value.bits)};
+  switch (payload.type) {
+  case PayloadType::Bytes:
+    writeKind(Kind::Bytes);
+    writeBytes(data, toSize(payload.size));
+    return;
+  case PayloadType::CString:
+    writeKind(Kind::Bytes);
+    writeBytes(data, std::strlen(data) + 1);
+    return;
+  case PayloadType::Strings:
+    writeStrings(name, payload.size, args);
+    return;
+  case PayloadType::Offset:
+  case PayloadType::Unknown:
+    break;
+  }
+  writeKind(value.type == Type::Pointer ? Kind::Output : Kind::Unknown);
+}
+
+void writeResult(std::string_view name, abcg::OpenGLCaptureValue const &result,
+                 std::span<abcg::OpenGLCaptureValue const> args) {
+  using Type = abcg::OpenGLCaptureValue::Type;
+  using Kind = abcg::OpenGLCaptureKind;
+
+  // Names of the objects generated by glGen*, used by the replay to check that
+  // the same names are generated
+  if (name.starts_with("glGen") && name != "glGenerateMipmap" &&
+      args.size() == 2 && args[1].bits != 0) {
+    auto const count{toSize(static_cast<std::int64_t>(args[0].bits))};
+    writeKind(Kind::Bytes);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    writeBytes(reinterpret_cast<void const *>(args[1].bits),
+               count * sizeof(GLuint));
+    return;
+  }
+
+  switch (result.type) {
+  case Type::Integer:
+    writeKind(Kind::Integer);
+    write(result.bits);
+    return;
+  case Type::Sync:
+    writeKind(Kind::Sync);
+    write(result.bits);
+    return;
+  default:
+    writeKind(Kind::None);
+    return;
+  }
+}
+
+void buildFunctionTable() {
+  capturedFunctions.clear();
+  functionIds.clear();
+  // Functions not supported by the driver have null addresses in GLEW
+  auto const add{[](void const *address, std::string_view name) {
+    if (address != nullptr) {
+      functionIds.try_emplace(
+          address, gsl::narrow<std::uint16_t>(capturedFunctions.size()));
+    }
+    capturedFunctions.push_back({.name = name});
+  }};
+#define ABCG_ADD_FUNCTION(name)                                                \
+  add(abcg::getOpenGLFunctionAddress(::name), #name);
+  ABCG_OPENGL_CAPTURE_FUNCTIONS(ABCG_ADD_FUNCTION)
+#undef ABCG_ADD_FUNCTION
+}
+} // namespace
+
+/**
+ * @brief Starts capturing the calls of the OpenGL function wrappers to a file.
+ *
+ * Every call made through the wrappers of abcgOpenGLFunction.hpp is written
+ * to the file with its arguments, including the data uploaded to buffers and
+ * textures, and the source code of shaders. The file can be replayed with the
+ * `abcg_replay` tool.
+ *
+ * The calls must be captured from the creation of the OpenGL context so that
+ * the replay can recreate all objects. abcg::OpenGLWindow does this if
+ * abcg::WindowSettings::capturePath is set.
+ *
+ * @param path Path to the capture file.
+ * @param info Context of the captured calls.
+ *
+ * @throw abcg::RuntimeError if the file cannot be created.
+ *
+ * @remark OpenGL functions called directly (e.g., by the Dear ImGui backend)
+ * and data written to mapped buffers are not captured.
+ */
+void abcg::beginOpenGLCapture(std::filesystem::path const &path,
+                              OpenGLCaptureInfo const &info) {
+  endOpenGLCapture();
+
+  captureStream.open(path, std::ios::binary | std::ios::trunc);
+  if (!captureStream) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to create capture file {}", path.string()));
+  }
+  write(openGLCaptureMagic);
+  write(openGLCaptureVersion);
+  write(info);
+
+  buildFunctionTable();
+  openGLCaptureActive = true;
+}
+
+/**
+ * @brief Stops capturing the OpenGL calls and closes the capture file.
+ *
+ * This does nothing if no capture is active.
+ */
+void abcg::endOpenGLCapture() {
+  if (!captureStream.is_open()) {
+    return;
+  }
+  openGLCaptureActive = false;
+  write(OpenGLCaptureTag::End);
+  captureStream.close();
+  capturedFunctions.clear();
+  functionIds.clear();
+}
+
+/**
+ * @brief Returns whether the OpenGL calls are being captured.
+ */
+bool abcg::isOpenGLCaptureActive() noexcept { return openGLCaptureActive; }
+
+/**
+ * @brief Marks the beginning of a frame in the capture file.
+ *
+ * @param frame Index of the frame.
+ * @param measured Whether the calls of the frame are to be timed by the
+ * replay. The calls of frames that are not measured are only executed to set
+ * up the state of the following frames.
+ */
+void abcg::markOpenGLCaptureFrame(std::size_t frame, bool measured) {
+  if (!openGLCaptureActive) {
+    return;
+  }
+  write(OpenGLCaptureTag::Frame);
+  write(static_cast<std::uint64_t>(frame));
+  write(static_cast<std::uint8_t>(measured ? 1 : 0));
+}
+
+/**
+ * @brief Writes a call to the capture file.
+ *
+ * This is called by abcg::invokeGL after the function returns.
+ *
+ * @param function Address of the function, as returned by
+ * abcg::getOpenGLFunctionAddress.
+ * @param result Value returned by the function.
+ * @param args Arguments of the call.
+ */
+void abcg::captureOpenGLCall(void const *function,
+                             OpenGLCaptureValue const &result,
+                             std::span<OpenGLCaptureValue const> args) {
+  auto const iter{functionIds.find(function)};
+  if (iter == functionIds.end()) {
+    return;
+  }
+  auto const id{iter->second};
+  auto &captured{capturedFunctions.at(id)};
+
+  if (!captured.written) {
+    write(OpenGLCaptureTag::Function);
+    write(id);
+    write(gsl::narrow<std::uint16_t>(captured.name.size()));
+    captureStream.write(captured.name.data(),
+                        gsl::narrow<std::streamsize>(captured.name.size()));
+    captured.written = true;
+  }
+
+  write(OpenGLCaptureTag::Call);
+  write(id);
+  write(gsl::narrow<std::uint8_t>(args.size()));
+  for (auto const index : iter::range(args.size())) {
+    writeArgument(captured.name, index, args);
+  }
+  writeResult(captured.name, result, args);
+}
+
+#endif
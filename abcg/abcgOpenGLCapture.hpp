@@ -0,0 +1,278 @@
+/**
+ * @file abcgOpenGLCapture.hpp
+ * @brief Declaration of functions for capturing OpenGL calls to a file.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_CAPTURE_HPP_
+#define ABCG_OPENGL_CAPTURE_HPP_
+
+#if !defined(__EMSCRIPTEN__)
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+struct OpenGLCaptureInfo;
+struct OpenGLCaptureValue;
+enum class OpenGLCaptureTag : std::uint8_t;
+enum class OpenGLCaptureKind : std::uint8_t;
+void beginOpenGLCapture(std::filesystem::path const &path,
+                        OpenGLCaptureInfo const &info);
+void endOpenGLCapture();
+[[nodiscard]] bool isOpenGLCaptureActive() noexcept;
+void markOpenGLCaptureFrame(std::size_t frame, bool measured);
+void captureOpenGLCall(void const *function, OpenGLCaptureValue const &result,
+                       std::span<OpenGLCaptureValue const> args);
+template <typename TFun>
+[[nodiscard]] void const *getOpenGLFunctionAddress(TFun &&function) noexcept;
+
+/** @brief Identifies a capture file ("AGLC"). */
+inline constexpr std::uint32_t openGLCaptureMagic{0x434C4741};
+/** @brief Version of the format of capture files. */
+inline constexpr std::uint32_t openGLCaptureVersion{1};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/** @brief Whether the calls of the OpenGL function wrappers are captured. */
+inline bool openGLCaptureActive{};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+} // namespace abcg
+
+/**
+ * @brief Invokes `X(name)` for each OpenGL function that has a wrapper in
+ * abcgOpenGLFunction.hpp.
+ *
+ * This is used to map the functions to the names stored in capture files.
+ */
+#define ABCG_OPENGL_CAPTURE_FUNCTIONS(X) \
+  X(glActiveTexture) X(glAttachShader) X(glBeginQuery) \
+  X(glBeginTransformFeedback) X(glBindAttribLocation) X(glBindBuffer) \
+  X(glBindBufferBase) X(glBindBufferRange) X(glBindFragDataLocation) \
+  X(glBindFramebuffer) X(glBindRenderbuffer) X(glBindSampler) \
+  X(glBindTexture) X(glBindTransformFeedback) X(glBindVertexArray) \
+  X(glBlendColor) X(glBlendEquation) X(glBlendEquationSeparate) \
+  X(glBlendFunc) X(glBlendFuncSeparate) X(glBlitFramebuffer) X(glBufferData) \
+  X(glBufferStorage) X(glBufferSubData) X(glCheckFramebufferStatus) X(glClear) \
+  X(glClearBufferfi) X(glClearBufferfv) X(glClearBufferiv) \
+  X(glClearBufferuiv) X(glClearColor) X(glClearDepthf) X(glClearStencil) \
+  X(glClientWaitSync) X(glColorMask) X(glCompileShader) \
+  X(glCompressedTexImage2D) X(glCompressedTexImage3D) \
+  X(glCompressedTexSubImage2D) X(glCompressedTexSubImage3D) \
+  X(glCopyBufferSubData) X(glCopyTexImage2D) X(glCopyTexSubImage2D) \
+  X(glCopyTexSubImage3D) X(glCreateProgram) X(glCreateShader) X(glCullFace) \
+  X(glDeleteBuffers) X(glDeleteFramebuffers) X(glDeleteProgram) \
+  X(glDeleteQueries) X(glDeleteRenderbuffers) X(glDeleteSamplers) \
+  X(glDeleteShader) X(glDeleteSync) X(glDeleteTextures) \
+  X(glDeleteTransformFeedbacks) X(glDeleteVertexArrays) X(glDepthFunc) \
+  X(glDepthMask) X(glDepthRangef) X(glDetachShader) X(glDisable) \
+  X(glDisableVertexAttribArray) X(glDrawArrays) X(glDrawArraysInstanced) \
+  X(glDrawBuffers) X(glDrawElements) X(glDrawElementsInstanced) \
+  X(glDrawRangeElements) X(glEnable) X(glEnableVertexAttribArray) \
+  X(glEndQuery) X(glEndTransformFeedback) X(glFenceSync) X(glFinish) \
+  X(glFlush) X(glFlushMappedBufferRange) X(glFramebufferRenderbuffer) \
+  X(glFramebufferTexture) X(glFramebufferTexture2D) \
+  X(glFramebufferTextureLayer) X(glFrontFace) X(glGenBuffers) \
+  X(glGenFramebuffers) X(glGenQueries) X(glGenRenderbuffers) X(glGenSamplers) \
+  X(glGenTextures) X(glGenTransformFeedbacks) X(glGenVertexArrays) \
+  X(glGenerateMipmap) X(glGetActiveAttrib) X(glGetActiveUniform) \
+  X(glGetActiveUniformBlockName) X(glGetActiveUniformBlockiv) \
+  X(glGetActiveUniformsiv) X(glGetAttachedShaders) X(glGetAttribLocation) \
+  X(glGetBooleanv) X(glGetBufferParameteri64v) X(glGetBufferParameteriv) \
+  X(glGetBufferPointerv) X(glGetDoublev) X(glGetFloatv) \
+  X(glGetFragDataLocation) X(glGetFramebufferAttachmentParameteriv) \
+  X(glGetInteger64i_v) X(glGetInteger64v) X(glGetIntegeri_v) X(glGetIntegerv) \
+  X(glGetInternalformativ) X(glGetProgramBinary) X(glGetProgramInfoLog) \
+  X(glGetProgramiv) X(glGetQueryObjectui64v) X(glGetQueryObjectuiv) \
+  X(glGetQueryiv) X(glGetRenderbufferParameteriv) X(glGetSamplerParameterfv) \
+  X(glGetSamplerParameteriv) X(glGetShaderInfoLog) \
+  X(glGetShaderPrecisionFormat) X(glGetShaderSource) X(glGetShaderiv) \
+  X(glGetString) X(glGetStringi) X(glGetSynciv) X(glGetTexLevelParameterfv) \
+  X(glGetTexLevelParameteriv) X(glGetTexParameterfv) X(glGetTexParameteriv) \
+  X(glGetTransformFeedbackVarying) X(glGetUniformBlockIndex) \
+  X(glGetUniformIndices) X(glGetUniformLocation) X(glGetUniformfv) \
+  X(glGetUniformiv) X(glGetUniformuiv) X(glGetVertexAttribIiv) \
+  X(glGetVertexAttribIuiv) X(glGetVertexAttribPointerv) \
+  X(glGetVertexAttribfv) X(glGetVertexAttribiv) X(glHint) \
+  X(glInvalidateFramebuffer) X(glInvalidateSubFramebuffer) X(glIsBuffer) \
+  X(glIsEnabled) X(glIsFramebuffer) X(glIsProgram) X(glIsQuery) \
+  X(glIsRenderbuffer) X(glIsSampler) X(glIsShader) X(glIsSync) X(glIsTexture) \
+  X(glIsTransformFeedback) X(glIsVertexArray) X(glLineWidth) X(glLinkProgram) \
+  X(glMapBufferRange) X(glMaxShaderCompilerThreadsKHR) \
+  X(glPauseTransformFeedback) X(glPixelStorei) X(glPolygonOffset) \
+  X(glProgramBinary) X(glProgramParameteri) X(glQueryCounter) X(glReadBuffer) \
+  X(glReadPixels) X(glReleaseShaderCompiler) X(glRenderbufferStorage) \
+  X(glRenderbufferStorageMultisample) X(glResumeTransformFeedback) \
+  X(glSampleCoverage) X(glSamplerParameterf) X(glSamplerParameterfv) \
+  X(glSamplerParameteri) X(glSamplerParameteriv) X(glScissor) \
+  X(glShaderBinary) X(glShaderSource) X(glStencilFunc) \
+  X(glStencilFuncSeparate) X(glStencilMask) X(glStencilMaskSeparate) \
+  X(glStencilOp) X(glStencilOpSeparate) X(glTexImage2D) \
+  X(glTexImage2DMultisample) X(glTexImage3D) X(glTexParameterf) \
+  X(glTexParameterfv) X(glTexParameteri) X(glTexParameteriv) \
+  X(glTexStorage2D) X(glTexStorage3D) X(glTexSubImage2D) X(glTexSubImage3D) \
+  X(glTransformFeedbackVaryings) X(glUniform1f) X(glUniform1fv) \
+  X(glUniform1i) X(glUniform1iv) X(glUniform1ui) X(glUniform1uiv) \
+  X(glUniform2f) X(glUniform2fv) X(glUniform2i) X(glUniform2iv) \
+  X(glUniform2ui) X(glUniform2uiv) X(glUniform3f) X(glUniform3fv) \
+  X(glUniform3i) X(glUniform3iv) X(glUniform3ui) X(glUniform3uiv) \
+  X(glUniform4f) X(glUniform4fv) X(glUniform4i) X(glUniform4iv) \
+  X(glUniform4ui) X(glUniform4uiv) X(glUniformBlockBinding) \
+  X(glUniformMatrix2fv) X(glUniformMatrix2x3fv) X(glUniformMatrix2x4fv) \
+  X(glUniformMatrix3fv) X(glUniformMatrix3x2fv) X(glUniformMatrix3x4fv) \
+  X(glUniformMatrix4fv) X(glUniformMatrix4x2fv) X(glUniformMatrix4x3fv) \
+  X(glUnmapBuffer) X(glUseProgram) X(glValidateProgram) X(glVertexAttrib1f) \
+  X(glVertexAttrib1fv) X(glVertexAttrib2f) X(glVertexAttrib2fv) \
+  X(glVertexAttrib3f) X(glVertexAttrib3fv) X(glVertexAttrib4f) \
+  X(glVertexAttrib4fv) X(glVertexAttribDivisor) X(glVertexAttribI4i) \
+  X(glVertexAttribI4iv) X(glVertexAttribI4ui) X(glVertexAttribI4uiv) \
+  X(glVertexAttribIPointer) X(glVertexAttribPointer) X(glViewport) \
+  X(glWaitSync)
+
+/**
+ * @brief Context of the captured calls.
+ *
+ * This is stored in the header of the capture file so that the calls can be
+ * replayed in a similar context.
+ */
+struct abcg::OpenGLCaptureInfo {
+  /** @brief OpenGL context major version. */
+  std::int32_t majorVersion{};
+  /** @brief OpenGL context minor version. */
+  std::int32_t minorVersion{};
+  /** @brief Profile mask of the context (`SDL_GL_CONTEXT_PROFILE_*`). */
+  std::int32_t profileMask{};
+  /** @brief Width of the default framebuffer, in pixels. */
+  std::int32_t width{};
+  /** @brief Height of the default framebuffer, in pixels. */
+  std::int32_t height{};
+};
+
+/**
+ * @brief Tag of a record of a capture file.
+ */
+enum class abcg::OpenGLCaptureTag : std::uint8_t {
+  /** @brief Name of a function, followed by its 16-bit identifier and
+   * 16-bit name length. */
+  Function = 1,
+  /** @brief Call of a function, followed by the function identifier, the
+   * number of arguments, the arguments and the return value. */
+  Call,
+  /** @brief Beginning of a frame, followed by the 64-bit frame index and a
+   * byte that is 1 if the frame is to be measured in the replay. */
+  Frame,
+  /** @brief End of the capture. */
+  End
+};
+
+/**
+ * @brief Kind of a value stored in a capture file.
+ */
+enum class abcg::OpenGLCaptureKind : std::uint8_t {
+  /** @brief No value, or a null pointer. */
+  None,
+  /** @brief Integer or enumerator, stored as 64 bits. */
+  Integer,
+  /** @brief Floating-point value, stored as the bits of a `double`. */
+  Float,
+  /** @brief Pointer used as an offset into a buffer object (e.g., the
+   * `pointer` argument of `glVertexAttribPointer`), stored as 64 bits. */
+  Offset,
+  /** @brief Data pointed to by a pointer, stored as a 64-bit size followed
+   * by the data. */
+  Bytes,
+  /** @brief Array of strings, stored as a 32-bit count followed by the
+   * 32-bit length and the characters of each string. */
+  Strings,
+  /** @brief Pointer to storage written by OpenGL (e.g., the `params`
+   * argument of `glGetIntegerv`). */
+  Output,
+  /** @brief Sync object, stored as 64 bits. */
+  Sync,
+  /** @brief Pointer to data of unknown size. The data is not stored. */
+  Unknown
+};
+
+/**
+ * @brief Argument or return value of a captured call.
+ */
+struct abcg::OpenGLCaptureValue {
+  /** @brief Type of the value. */
+  enum class Type : std::uint8_t {
+    /** @brief No value. */
+    None,
+    /** @brief Integer or enumerator. */
+    Integer,
+    /** @brief Floating-point value. */
+    Float,
+    /** @brief Pointer to data read by OpenGL. */
+    ConstPointer,
+    /** @brief Pointer to storage written by OpenGL. */
+    Pointer,
+    /** @brief Sync object. */
+    Sync
+  };
+
+  /** @brief Type of the value. */
+  Type type{Type::None};
+  /** @brief Bits of the value. Signed integers are sign extended, floats are
+   * stored as doubles, and pointers as addresses. */
+  std::uint64_t bits{};
+
+  /**
+   * @brief Creates a value from an argument or return value of an OpenGL
+   * function.
+   *
+   * @param value Value to be stored.
+   */
+  template <typename T> static OpenGLCaptureValue make(T value) noexcept {
+    if constexpr (std::is_same_v<T, GLsync>) {
+      return {.type = Type::Sync,
+              // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+              .bits = reinterpret_cast<std::uintptr_t>(value)};
+    } else if constexpr (std::is_pointer_v<T>) {
+      auto const constant{std::is_const_v<std::remove_pointer_t<T>>};
+      return {.type = constant ? Type::ConstPointer : Type::Pointer,
+              // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+              .bits = reinterpret_cast<std::uintptr_t>(value)};
+    } else if constexpr (std::is_floating_point_v<T>) {
+      return {.type = Type::Float,
+              .bits = std::bit_cast<std::uint64_t>(static_cast<double>(value))};
+    } else if constexpr (std::is_signed_v<T>) {
+      return {.type = Type::Integer, .bits = static_cast<std::uint64_t>(
+                                         static_cast<std::int64_t>(value))};
+    } else {
+      return {.type = Type::Integer, .bits = static_cast<std::uint64_t>(value)};
+    }
+  }
+};
+
+/**
+ * @brief Returns the address of an OpenGL function, used to identify the
+ * function in abcg::captureOpenGLCall.
+ *
+ * @param function Function, or pointer to function.
+ */
+template <typename TFun>
+void const *abcg::getOpenGLFunctionAddress(TFun &&function) noexcept {
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  if constexpr (std::is_pointer_v<std::remove_cvref_t<TFun>>) {
+    return reinterpret_cast<void const *>(function);
+  } else {
+    return reinterpret_cast<void const *>(&function);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+#endif
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * @file abcgOpenGLCounters.cpp
+ * @brief Definition of abcg::OpenGLCounters members and related functions.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLCounters.hpp"
+
+#include <algorithm>
+
+namespace {
+// Number of components of a pixel transfer format
+std::uint64_t getComponentCount(GLenum format) noexcept {
+  switch (format) {
+  case GL_RED:
+  case GL_RED_INTEGER:
+  case GL_DEPTH_COMPONENT:
+  case GL_STENCIL_INDEX:
+    return 1;
+  case GL_RG:
+  case GL_RG_INTEGER:
+  case GL_DEPTH_STENCIL:
+    return 2;
+  case GL_RGB:
+  case GL_RGB_INTEGER:
+    return 3;
+  default:
+    return 4;
+  }
+}
+
+// Size of a pixel, in bytes, of a pixel transfer format and type
+std::uint64_t getPixelSize(GLenum format, GLenum type) noexcept {
+  switch (type) {
+  case GL_UNSIGNED_BYTE:
+  case GL_BYTE:
+    return getComponentCount(format);
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    return getComponentCount(format) * 2;
+  case GL_UNSIGNED_SHORT_5_6_5:
+  case GL_UNSIGNED_SHORT_4_4_4_4:
+  case GL_UNSIGNED_SHORT_5_5_5_1:
+    return 2;
+  case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+    return 8;
+  case GL_UNSIGNED_INT_2_10_10_10_REV:
+  case GL_UNSIGNED_INT_10F_11F_11F_REV:
+  case GL_UNSIGNED_INT_5_9_9_9_REV:
+  case GL_UNSIGNED_INT_24_8:
+    return 4;
+  default:
+    return getComponentCount(format) * 4;
+  }
+}
+} // namespace
+
+/**
+ * @brief Enables or disables the counters of OpenGL calls.
+ *
+ * The counters are reset in both cases. They are disabled by default and are
+ * enabled when the window is created if abcg::WindowSettings::frameCounters
+ * is `true`.
+ *
+ * @param enabled Whether the calls are counted.
+ */
+void abcg::setOpenGLCountersEnabled(bool enabled) noexcept {
+  openGLCounters.reset();
+  openGLCounters.enabled = enabled;
+}
+
+/**
+ * @brief Returns whether the counters of OpenGL calls are enabled.
+ */
+bool abcg::isOpenGLCountersEnabled() noexcept {
+  return openGLCounters.enabled;
+}
+
+/**
+ * @brief Returns the size of a tightly packed image in client memory.
+ *
+ * @param width Width of the image, in pixels.
+ * @param height Height of the image, in pixels.
+ * @param depth Depth of the image, in pixels.
+ * @param format Format of the pixel data.
+ * @param type Data type of the pixel data.
+ *
+ * @returns Size of the image, in bytes, or zero if a dimension is not
+ * positive.
+ */
+std::uint64_t abcg::getOpenGLPixelDataSize(GLsizei width, GLsizei height,
+                                           GLsizei depth, GLenum format,
+                                           GLenum type) noexcept {
+  return getOpenGLPixelDataSize(width, height, depth, format, type, {});
+}
+
+/**
+ * @brief Returns the number of bytes of client memory read by an upload of an
+ * image.
+ *
+ * This includes the padding at the end of each row, the pixels, rows and
+ * images skipped, and the rows and images of a larger enclosing image, as
+ * given by the pixel storage modes.
+ *
+ * @param width Width of the image, in pixels.
+ * @param height Height of the image, in pixels.
+ * @param depth Depth of the image, in pixels.
+ * @param format Format of the pixel data.
+ * @param type Data type of the pixel data.
+ * @param unpack Pixel storage modes of the upload.
+ *
+ * @returns Size, in bytes, from the start of the data to the end of the last
+ * pixel read, or zero if a dimension is not positive.
+ */
+std::uint64_t
+abcg::getOpenGLPixelDataSize(GLsizei width, GLsizei height, GLsizei depth,
+                             GLenum format, GLenum type,
+                             OpenGLUnpackState const &unpack) noexcept {
+  if (width <= 0 || height <= 0 || depth <= 0) {
+    return 0;
+  }
+  auto const toUnsigned{[](GLint value) {
+    return static_cast<std::uint64_t>(std::max(value, 0));
+  }};
+  auto const pixelSize{getPixelSize(format, type)};
+  auto const alignment{toUnsigned(std::max(unpack.alignment, 1))};
+  auto const rowLength{unpack.rowLength > 0 ? unpack.rowLength : width};
+  auto const imageHeight{unpack.imageHeight > 0 ? unpack.imageHeight : height};
+  // Each row starts at a multiple of the alignment
+  auto const rowSize{(toUnsigned(rowLength) * pixelSize + alignment - 1) /
+                     alignment * alignment};
+  auto const imageSize{rowSize * toUnsigned(imageHeight)};
+
+  auto const skipped{toUnsigned(unpack.skipImages) * imageSize +
+                     toUnsigned(unpack.skipRows) * rowSize +
+                     toUnsigned(unpack.skipPixels) * pixelSize};
+  // The last row is not padded
+  return skipped + (toUnsigned(depth) - 1) * imageSize +
+         (toUnsigned(height) - 1) * rowSize + toUnsigned(width) * pixelSize;
+}
+
+/**
+ * @brief Counts an upload of pixel data to a texture.
+ *
+ * @sa abcg::getOpenGLPixelDataSize.
+ *
+ * @param width Width of the image, in pixels.
+ * @param height Height of the image, in pixels.
+ * @param depth Depth of the image, in pixels.
+ * @param format Format of the pixel data.
+ * @param type Data type of the pixel data.
+ * @param data Pointer to the data. Calls with a null pointer only allocate
+ * storage and are not counted.
+ */
+void abcg::OpenGLCounters::countTextureUpload(GLsizei width, GLsizei height,
+                                              GLsizei depth, GLenum format,
+                                              GLenum type,
+                                              void const *data) noexcept {
+  if (!enabled || data == nullptr) {
+    return;
+  }
+  ++uploads;
+  bytesUploaded += getOpenGLPixelDataSize(width, height, depth, format, type);
+}
+
+/**
+ * @brief Sets all counters to zero.
+ */
+void abcg::OpenGLCounters::reset() noexcept {
+  calls = 0;
+  drawCalls = 0;
+  stateChanges = 0;
+  uploads = 0;
+  bytesUploaded = 0;
+  creations = 0;
+  deletions = 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file abcgOpenGLCounters.hpp
+ * @brief Header file of abcg::OpenGLCounters.
+ *
+ * Declaration of abcg::OpenGLCounters and related functions.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_COUNTERS_HPP_
+#define ABCG_OPENGL_COUNTERS_HPP_
+
+#include <cstdint>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+struct OpenGLCounters;
+struct OpenGLUnpackState;
+void setOpenGLCountersEnabled(bool enabled) noexcept;
+[[nodiscard]] bool isOpenGLCountersEnabled() noexcept;
+[[nodiscard]] std::uint64_t getOpenGLPixelDataSize(GLsizei width,
+                                                  GLsizei height, GLsizei depth,
+                                                  GLenum format,
+                                                  GLenum type) noexcept;
+[[nodiscard]] std::uint64_t
+getOpenGLPixelDataSize(GLsizei width, GLsizei height, GLsizei depth,
+                       GLenum format, GLenum type,
+                       OpenGLUnpackState const &unpack) noexcept;
+} // namespace abcg
+
+/**
+ * @brief Pixel storage modes that determine how pixel data is read from
+ * client memory (see `glPixelStorei`).
+ *
+ * The default values describe tightly packed data.
+ */
+struct abcg::OpenGLUnpackState {
+  /** @brief Value of `GL_UNPACK_ALIGNMENT`. */
+  GLint alignment{1};
+  /** @brief Value of `GL_UNPACK_ROW_LENGTH`. */
+  GLint rowLength{};
+  /** @brief Value of `GL_UNPACK_IMAGE_HEIGHT`. */
+  GLint imageHeight{};
+  /** @brief Value of `GL_UNPACK_SKIP_PIXELS`. */
+  GLint skipPixels{};
+  /** @brief Value of `GL_UNPACK_SKIP_ROWS`. */
+  GLint skipRows{};
+  /** @brief Value of `GL_UNPACK_SKIP_IMAGES`. */
+  GLint skipImages{};
+};
+
+/**
+ * @brief Number of calls made through the OpenGL function wrappers, by
+ * category.
+ *
+ * When the counters are enabled (see abcg::setOpenGLCountersEnabled), every
+ * call of an OpenGL function wrapper that reaches OpenGL is counted. Calls
+ * skipped by abcg::OpenGLStateCache are not counted.
+ *
+ * abcg::OpenGLWindow resets the counters at the end of each frame and
+ * reports their values in abcg::Window::getFrameCounters.
+ */
+struct abcg::OpenGLCounters {
+  /** @brief Whether the calls are counted. */
+  bool enabled{};
+  /** @brief Number of calls of any function. */
+  std::uint64_t calls{};
+  /** @brief Number of calls of `glDraw*`. */
+  std::uint64_t drawCalls{};
+  /** @brief Number of calls that bind objects or change the fixed-function
+   * state, such as `glBindBuffer`, `glUseProgram`, `glEnable` and
+   * `glViewport`. */
+  std::uint64_t stateChanges{};
+  /** @brief Number of calls that upload data to buffers or textures, such as
+   * `glBufferData`, `glBufferSubData` and `glTexImage2D`. */
+  std::uint64_t uploads{};
+  /** @brief Number of bytes uploaded by the calls counted in `uploads`. */
+  std::uint64_t bytesUploaded{};
+  /** @brief Number of objects created by `glGen*` and `glCreate*`. */
+  std::uint64_t creations{};
+  /** @brief Number of objects deleted by `glDelete*`. */
+  std::uint64_t deletions{};
+
+  /** @brief Counts a call of any function. */
+  void countCall() noexcept {
+    if (enabled)
+      ++calls;
+  }
+
+  /** @brief Counts a draw call. */
+  void countDraw() noexcept {
+    if (enabled)
+      ++drawCalls;
+  }
+
+  /** @brief Counts a state change. */
+  void countStateChange() noexcept {
+    if (enabled)
+      ++stateChanges;
+  }
+
+  /**
+   * @brief Counts an upload of data to a buffer or texture.
+   *
+   * @param bytes Number of bytes uploaded.
+   * @param data Pointer to the data. Calls with a null pointer only allocate
+   * storage and are not counted.
+   */
+  void countUpload(std::int64_t bytes, void const *data) noexcept {
+    if (enabled && data != nullptr) {
+      ++uploads;
+      bytesUploaded += static_cast<std::uint64_t>(bytes > 0 ? bytes : 0);
+    }
+  }
+
+  void countTextureUpload(GLsizei width, GLsizei height, GLsizei depth,
+                          GLenum format, GLenum type,
+                          void const *data) noexcept;
+
+  /**
+   * @brief Counts the creation of objects.
+   *
+   * @param count Number of objects created.
+   */
+  void countCreations(GLsizei count) noexcept {
+    if (enabled && count > 0)
+      creations += static_cast<std::uint64_t>(count);
+  }
+
+  /**
+   * @brief Counts the deletion of objects.
+   *
+   * @param count Number of objects deleted.
+   */
+  void countDeletions(GLsizei count) noexcept {
+    if (enabled && count > 0)
+      deletions += static_cast<std::uint64_t>(count);
+  }
+
+  void reset() noexcept;
+};
+
+namespace abcg {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/** @brief Counters of the calls made in the current frame. */
+inline OpenGLCounters openGLCounters{};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+} // namespace abcg
+
+#endif
@@ -12,6 +12,45 @@
 #include "abcgOpenGLError.hpp"
 
 #if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+#include <optional>
+#include <string>
+
+#include <fmt/core.h>
+
+namespace {
+// Error reported by the debug message callback
+struct DebugError {
+  std::string message;
+  // Location of the wrapper that was being called, if any
+  std::optional<abcg::source_location> sourceLocation;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+thread_local DebugError pendingDebugError;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Called synchronously by the driver in the thread that made the OpenGL call.
+// Exceptions cannot be thrown through the driver, so the error is recorded and
+// thrown by abcg::callGL when the call returns.
+void GLAPIENTRY debugMessageCallback(GLenum /*source*/, GLenum type,
+                                     GLuint /*id*/, GLenum /*severity*/,
+                                     GLsizei length, GLchar const *message,
+                                     void const * /*userParam*/) {
+  if (type != GL_DEBUG_TYPE_ERROR || abcg::openGLDebugErrorPending) {
+    return;
+  }
+  pendingDebugError.message =
+      length < 0 ? std::string{message}
+                 : std::string{message, static_cast<std::size_t>(length)};
+  if (abcg::openGLCallLocation != nullptr) {
+    pendingDebugError.sourceLocation = *abcg::openGLCallLocation;
+  } else {
+    pendingDebugError.sourceLocation.reset();
+  }
+  abcg::openGLDebugErrorPending = true;
+}
+} // namespace
+
 /**
  * @brief Checks OpenGL error status and throws on error with a log message.
  *
@@ -29,4 +68,85 @@ void abcg::checkGLError(source_location const &sourceLocation,
     throw abcg::OpenGLError(appendString, status, sourceLocation);
   }
 }
+
+/**
+ * @brief Reports OpenGL errors through the debug message callback instead of
+ * calling `glGetError` before and after each OpenGL function call.
+ *
+ * The callback is installed with `GL_DEBUG_OUTPUT_SYNCHRONOUS` enabled, so
+ * errors are reported in the thread and during the call of the function that
+ * caused them. The error is then thrown by the function wrapper as an
+ * abcg::OpenGLError, as in the default mode. Only messages of type
+ * `GL_DEBUG_TYPE_ERROR` are enabled.
+ *
+ * This requires a debug context (see abcg::OpenGLSettings::debugCallback) and
+ * OpenGL 4.3 or `GL_KHR_debug`.
+ *
+ * @returns `true` if the callback was installed, or `false` if debug output is
+ * not supported, in which case `glGetError` is still used.
+ */
+bool abcg::enableOpenGLDebugCallback() {
+  if (GLEW_VERSION_4_3 == 0 && GLEW_KHR_debug == 0) {
+    return false;
+  }
+
+  GLint flags{};
+  glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+  if ((static_cast<GLuint>(flags) & GL_CONTEXT_FLAG_DEBUG_BIT) == 0U) {
+    return false;
+  }
+
+  // Clear errors of previous calls
+  while (glGetError() != GL_NO_ERROR) {
+  }
+
+  glEnable(GL_DEBUG_OUTPUT);
+  glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr,
+                        GL_FALSE);
+  glDebugMessageControl(GL_DONT_CARE, GL_DEBUG_TYPE_ERROR, GL_DONT_CARE, 0,
+                        nullptr, GL_TRUE);
+  glDebugMessageCallback(debugMessageCallback, nullptr);
+
+  openGLDebugErrorPending = false;
+  openGLDebugCallbackEnabled = true;
+  return true;
+}
+
+/**
+ * @brief Removes the debug message callback and goes back to checking errors
+ * with `glGetError`.
+ */
+void abcg::disableOpenGLDebugCallback() {
+  if (!openGLDebugCallbackEnabled) {
+    return;
+  }
+  glDebugMessageCallback(nullptr, nullptr);
+  glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+  glDisable(GL_DEBUG_OUTPUT);
+  openGLDebugCallbackEnabled = false;
+  openGLDebugErrorPending = false;
+}
+
+/**
+ * @brief Throws the error reported by the debug message callback.
+ *
+ * @param sourceLocation Information about the source code of the wrapper that
+ * detected the error. The location recorded by the callback is used instead,
+ * if any.
+ * @param appendString A string to be appended to "OpenGL error " in the
+ * exception explanatory string.
+ *
+ * @throw abcg::Exception::OpenGLError.
+ */
+void abcg::throwOpenGLDebugError(source_location const &sourceLocation,
+                                 std::string_view const appendString) {
+  openGLDebugErrorPending = false;
+  auto const location{
+      pendingDebugError.sourceLocation.value_or(sourceLocation)};
+  auto const what{
+      fmt::format("{}: {}", appendString, pendingDebugError.message)};
+  // The error flag is still set when debug output is enabled
+  throw abcg::OpenGLError(what, glGetError(), location);
+}
 #endif
@@ -31,7 +31,10 @@ using source_location = std::source_location;
 #include <string_view>
 #include <type_traits>
 
+#include "abcgOpenGLCapture.hpp"
+#include "abcgOpenGLCounters.hpp"
 #include "abcgOpenGLExternal.hpp"
+#include "abcgOpenGLStateCache.hpp"
 
 #if defined(_MSC_VER)
 // Disable "unreachable code" warnings for the case callGl is not specialized
@@ -41,14 +44,104 @@ using source_location = std::source_location;
 #endif
 
 namespace abcg {
+/**
+ * @brief Calls an OpenGL function.
+ *
+ * The call is counted in abcg::openGLCounters if the counters are enabled,
+ * and written to the capture file if a capture is active (see
+ * abcg::beginOpenGLCapture).
+ *
+ * @tparam TFun Function typename.
+ * @tparam TArgs Variadic arguments typename.
+ *
+ * @param function Function to be called.
+ * @param args Variadic template arguments for the function.
+ *
+ * @return Value returned from function, or void.
+ */
+template <typename TFun, typename... TArgs>
+auto invokeGL(TFun &&function, TArgs &&...args) {
+  openGLCounters.countCall();
+#if !defined(__EMSCRIPTEN__)
+  if (openGLCaptureActive) {
+    // The call is captured after it returns so that the objects generated by
+    // glGen* are known
+    std::array<OpenGLCaptureValue, sizeof...(TArgs)> const values{
+        OpenGLCaptureValue::make(args)...};
+    if constexpr (!std::is_void_v<std::invoke_result_t<TFun, TArgs...>>) {
+      auto res{function(args...)};
+      captureOpenGLCall(getOpenGLFunctionAddress(function),
+                        OpenGLCaptureValue::make(res), values);
+      return res;
+    } else {
+      function(args...);
+      captureOpenGLCall(getOpenGLFunctionAddress(function), {}, values);
+      return;
+    }
+  }
+#endif
+  return std::forward<TFun>(function)(std::forward<TArgs>(args)...);
+}
+
 #if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
 
 void checkGLError(source_location const &sourceLocation,
                   std::string_view appendString);
 
+[[nodiscard]] bool enableOpenGLDebugCallback();
+void disableOpenGLDebugCallback();
+[[noreturn]] void throwOpenGLDebugError(source_location const &sourceLocation,
+                                        std::string_view appendString);
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/**
+ * @brief Whether OpenGL errors are reported by the debug message callback
+ * instead of `glGetError`.
+ *
+ * @sa abcg::enableOpenGLDebugCallback.
+ */
+inline bool openGLDebugCallbackEnabled{};
+/**
+ * @brief Source location of the OpenGL function wrapper being called by the
+ * current thread, or `nullptr` if no wrapper is being called.
+ */
+inline thread_local source_location const *openGLCallLocation{};
+/**
+ * @brief Whether the debug message callback has reported an error in the
+ * current thread that was not thrown yet.
+ */
+inline thread_local bool openGLDebugErrorPending{};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+/**
+ * @brief Sets abcg::openGLCallLocation for the lifetime of the object.
+ *
+ * The location is reset when the object is destroyed, also if the call
+ * throws.
+ */
+class OpenGLCallLocationScope {
+public:
+  explicit OpenGLCallLocationScope(
+      source_location const &sourceLocation) noexcept {
+    openGLCallLocation = &sourceLocation;
+  }
+  ~OpenGLCallLocationScope() { openGLCallLocation = nullptr; }
+  OpenGLCallLocationScope(OpenGLCallLocationScope const &) = delete;
+  OpenGLCallLocationScope &operator=(OpenGLCallLocationScope const &) = delete;
+  OpenGLCallLocationScope(OpenGLCallLocationScope &&) = delete;
+  OpenGLCallLocationScope &operator=(OpenGLCallLocationScope &&) = delete;
+};
+
 /**
  * @brief Checks for OpenGL errors before and after a function call.
  *
+ * If the debug message callback is enabled (see
+ * abcg::enableOpenGLDebugCallback), errors are reported synchronously by the
+ * callback during the call, and `glGetError` is not called unless an error
+ * has occurred.
+ *
+ * The function is called through abcg::invokeGL.
+ *
  * @tparam TFun Function typename.
  * @tparam TArgs Variadic arguments typename.
  *
@@ -61,15 +154,38 @@ void checkGLError(source_location const &sourceLocation,
 template <typename TFun, typename... TArgs>
 auto callGL(source_location const &sourceLocation, TFun &&function,
             TArgs &&...args) {
+  if (openGLDebugCallbackEnabled) {
+    // Errors caused by calls made outside the wrappers
+    if (openGLDebugErrorPending) {
+      throwOpenGLDebugError(sourceLocation, "BEFORE function call");
+    }
+    OpenGLCallLocationScope const callLocationScope{sourceLocation};
+    if constexpr (!std::is_void_v<std::invoke_result_t<TFun, TArgs...>>) {
+      auto &&res{invokeGL(std::forward<TFun>(function),
+                          std::forward<TArgs>(args)...)};
+      if (openGLDebugErrorPending) {
+        throwOpenGLDebugError(sourceLocation, "AFTER function call");
+      }
+      return res;
+    } else {
+      invokeGL(std::forward<TFun>(function), std::forward<TArgs>(args)...);
+      if (openGLDebugErrorPending) {
+        throwOpenGLDebugError(sourceLocation, "AFTER function call");
+      }
+      return;
+    }
+  }
+
   checkGLError(sourceLocation, "BEFORE function call");
   if constexpr (!std::is_void_v<std::invoke_result_t<TFun, TArgs...>>) {
     // Specialization for functions that do not return void
-    auto &&res{std::forward<TFun>(function)(std::forward<TArgs>(args)...)};
+    auto &&res{invokeGL(std::forward<TFun>(function),
+                        std::forward<TArgs>(args)...)};
     checkGLError(sourceLocation, "AFTER function call");
     return res;
   }
   // Specialization for functions that return void
-  std::forward<TFun>(function)(std::forward<TArgs>(args)...);
+  invokeGL(std::forward<TFun>(function), std::forward<TArgs>(args)...);
   checkGLError(sourceLocation, "AFTER function call");
 }
 
@@ -84,6 +200,8 @@ struct source_location {
 /**
  * @brief Calls a function with given arguments.
  *
+ * The function is called through abcg::invokeGL.
+ *
  * @tparam TFun Function typename.
  * @tparam TArgs Variadic arguments typename.
  *
@@ -97,11 +215,12 @@ auto callGL([[maybe_unused]] source_location, TFun &&function,
             TArgs &&...args) {
   if constexpr (!std::is_void_v<std::invoke_result_t<TFun, TArgs...>>) {
     // Specialization for functions that do not return void
-    auto &&res{std::forward<TFun>(function)(std::forward<TArgs>(args)...)};
+    auto &&res{invokeGL(std::forward<TFun>(function),
+                        std::forward<TArgs>(args)...)};
     return res;
   }
   // Specialization for functions that return void
-  std::forward<TFun>(function)(std::forward<TArgs>(args)...);
+  invokeGL(std::forward<TFun>(function), std::forward<TArgs>(args)...);
 }
 #endif
 
@@ -112,7 +231,13 @@ auto callGL([[maybe_unused]] source_location, TFun &&function,
 inline void glActiveTexture(
     GLenum texture,
     source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findActiveTextureUnit()};
+  if (cached != nullptr && *cached == texture - GL_TEXTURE0)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glActiveTexture, texture);
+  if (cached != nullptr)
+    *cached = texture - GL_TEXTURE0;
 }
 inline void glAttachShader(
     GLuint program, GLuint shader,
@@ -127,56 +252,84 @@ inline void glBindAttribLocation(
 inline void glBindBuffer(
     GLenum target, GLuint buffer,
     source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findBuffer(target)};
+  if (cached != nullptr && *cached == buffer)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindBuffer, target, buffer);
+  if (cached != nullptr)
+    *cached = buffer;
 }
 inline void glBindFramebuffer(
     GLenum target, GLuint framebuffer,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindFramebuffer, target, framebuffer);
 }
 inline void glBindRenderbuffer(
     GLenum target, GLuint renderbuffer,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindRenderbuffer, target, renderbuffer);
 }
 inline void glBindTexture(
     GLenum target, GLuint texture,
     source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findTexture(target)};
+  if (cached != nullptr && *cached == texture)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindTexture, target, texture);
+  if (cached != nullptr)
+    *cached = texture;
 }
 inline void glBlendColor(
     GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBlendColor, red, green, blue, alpha);
 }
 inline void glBlendEquation(GLenum mode, source_location const &sourceLocation =
                                              source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBlendEquation, mode);
 }
 inline void glBlendEquationSeparate(
     GLenum modeRGB, GLenum modeAlpha,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBlendEquationSeparate, modeRGB, modeAlpha);
 }
 inline void glBlendFunc(
     GLenum sfactor, GLenum dfactor,
     source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findBlendFunc()};
+  if (cached != nullptr && *cached == std::array{sfactor, dfactor})
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBlendFunc, sfactor, dfactor);
+  if (cached != nullptr)
+    *cached = {sfactor, dfactor};
 }
 inline void glBlendFuncSeparate(
     GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha,
     source_location const &sourceLocation = source_location::current()) {
+  if (auto *const cached{openGLStateCache.findBlendFunc()}; cached != nullptr)
+    cached->fill(OpenGLStateCache::unknown);
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBlendFuncSeparate, srcRGB, dstRGB, srcAlpha,
          dstAlpha);
 }
 inline void glBufferData(
     GLenum target, GLsizeiptr size, void const *data, GLenum usage,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(size, data);
   callGL(sourceLocation, ::glBufferData, target, size, data, usage);
 }
 inline void glBufferSubData(
     GLenum target, GLintptr offset, GLsizeiptr size, void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(size, data);
   callGL(sourceLocation, ::glBufferSubData, target, offset, size, data);
 }
 inline GLenum glCheckFramebufferStatus(
@@ -205,6 +358,7 @@ inline void glClearStencil(GLint s, source_location const &sourceLocation =
 inline void glColorMask(
     GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glColorMask, red, green, blue, alpha);
 }
 inline void glCompileShader(
@@ -216,6 +370,7 @@ inline void glCompressedTexImage2D(
     GLenum target, GLint level, GLenum internalformat, GLsizei width,
     GLsizei height, GLint border, GLsizei imageSize, void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(imageSize, data);
   callGL(sourceLocation, ::glCompressedTexImage2D, target, level,
          internalformat, width, height, border, imageSize, data);
 }
@@ -223,6 +378,7 @@ inline void glCompressedTexSubImage2D(
     GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
     GLsizei height, GLenum format, GLsizei imageSize, void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(imageSize, data);
   callGL(sourceLocation, ::glCompressedTexSubImage2D, target, level, xoffset,
          yoffset, width, height, format, imageSize, data);
 }
@@ -242,16 +398,19 @@ inline void glCopyTexSubImage2D(
 }
 inline GLuint glCreateProgram(
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(1);
   return callGL(sourceLocation, ::glCreateProgram);
 }
 inline GLuint glCreateShader(
     GLenum shaderType,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(1);
   return callGL(sourceLocation, ::glCreateShader, shaderType);
 }
 inline void
 glCullFace(GLenum mode,
            source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   return callGL(sourceLocation, ::glCullFace, mode);
 }
 inline void glDeleteBuffers(
@@ -259,13 +418,16 @@ inline void glDeleteBuffers(
     source_location const &sourceLocation = source_location::current()) {
   if (buffers == nullptr || *buffers == 0)
     return;
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteBuffers, n, buffers);
+  openGLStateCache.forgetBuffers(n, buffers);
 }
 inline void glDeleteFramebuffers(
     GLsizei n, GLuint const *framebuffers,
     source_location const &sourceLocation = source_location::current()) {
   if (framebuffers == nullptr || *framebuffers == 0)
     return;
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteFramebuffers, n, framebuffers);
 }
 inline void glDeleteProgram(
@@ -273,13 +435,16 @@ inline void glDeleteProgram(
     source_location const &sourceLocation = source_location::current()) {
   if (program == 0)
     return;
+  openGLCounters.countDeletions(1);
   callGL(sourceLocation, ::glDeleteProgram, program);
+  openGLStateCache.forgetProgram(program);
 }
 inline void glDeleteRenderbuffers(
     GLsizei n, GLuint *renderbuffers,
     source_location const &sourceLocation = source_location::current()) {
   if (renderbuffers == nullptr || *renderbuffers == 0)
     return;
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteRenderbuffers, n, renderbuffers);
 }
 inline void glDeleteShader(
@@ -287,6 +452,7 @@ inline void glDeleteShader(
     source_location const &sourceLocation = source_location::current()) {
   if (shader == 0)
     return;
+  openGLCounters.countDeletions(1);
   callGL(sourceLocation, ::glDeleteShader, shader);
 }
 inline void glDeleteTextures(
@@ -294,14 +460,18 @@ inline void glDeleteTextures(
     source_location const &sourceLocation = source_location::current()) {
   if (textures == nullptr || *textures == 0)
     return;
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteTextures, n, textures);
+  openGLStateCache.forgetTextures(n, textures);
 }
 inline void glDepthFunc(GLenum func, source_location const &sourceLocation =
                                          source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glDepthFunc, func);
 }
 inline void glDepthMask(GLboolean flag, source_location const &sourceLocation =
                                             source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glDepthMask, flag);
 }
 inline void glDepthRangef(
@@ -317,7 +487,13 @@ inline void glDetachShader(
 inline void
 glDisable(GLenum cap,
           source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findCapability(cap)};
+  if (cached != nullptr && *cached == 0)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glDisable, cap);
+  if (cached != nullptr)
+    *cached = 0;
 }
 inline void glDisableVertexAttribArray(
     GLuint index,
@@ -327,17 +503,25 @@ inline void glDisableVertexAttribArray(
 inline void glDrawArrays(
     GLenum mode, GLint first, GLsizei count,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDraw();
   callGL(sourceLocation, ::glDrawArrays, mode, first, count);
 }
 inline void glDrawElements(
     GLenum mode, GLsizei count, GLenum type, void const *indices,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDraw();
   callGL(sourceLocation, ::glDrawElements, mode, count, type, indices);
 }
 inline void
 glEnable(GLenum cap,
          source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findCapability(cap)};
+  if (cached != nullptr && *cached == 1)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glEnable, cap);
+  if (cached != nullptr)
+    *cached = 1;
 }
 inline void glEnableVertexAttribArray(
     GLuint index,
@@ -368,11 +552,13 @@ inline void glFramebufferTexture2D(
 }
 inline void glFrontFace(GLenum mode, source_location const &sourceLocation =
                                          source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glFrontFace, mode);
 }
 inline void glGenBuffers(
     GLsizei n, GLuint *buffers,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenBuffers, n, buffers);
 }
 inline void glGenerateMipmap(
@@ -383,16 +569,19 @@ inline void glGenerateMipmap(
 inline void glGenFramebuffers(
     GLsizei n, GLuint *ids,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenFramebuffers, n, ids);
 }
 inline void glGenRenderbuffers(
     GLsizei n, GLuint *renderbuffers,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenRenderbuffers, n, renderbuffers);
 }
 inline void glGenTextures(
     GLsizei n, GLuint *textures,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenTextures, n, textures);
 }
 inline void glGetActiveAttrib(
@@ -612,6 +801,7 @@ inline void glSampleCoverage(
 inline void
 glScissor(GLint x, GLint y, GLsizei width, GLsizei height,
           source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glScissor, x, y, width, height);
 }
 inline void glShaderBinary(
@@ -629,36 +819,43 @@ inline void glShaderSource(
 inline void glStencilFunc(
     GLenum func, GLint ref, GLuint mask,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glStencilFunc, func, ref, mask);
 }
 inline void glStencilFuncSeparate(
     GLenum face, GLenum func, GLint ref, GLuint mask,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glStencilFuncSeparate, face, func, ref, mask);
 }
 inline void glStencilMask(GLuint mask, source_location const &sourceLocation =
                                            source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glStencilMask, mask);
 }
 inline void glStencilMaskSeparate(
     GLenum face, GLuint mask,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glStencilMaskSeparate, face, mask);
 }
 inline void glStencilOp(
     GLenum fail, GLenum zfail, GLenum zpass,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glStencilOp, fail, zfail, zpass);
 }
 inline void glStencilOpSeparate(
     GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glStencilOpSeparate, face, sfail, dpfail, dppass);
 }
 inline void glTexImage2D(
     GLenum target, GLint level, GLint internalformat, GLsizei width,
     GLsizei height, GLint border, GLenum format, GLenum type, void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countTextureUpload(width, height, 1, format, type, data);
   callGL(sourceLocation, ::glTexImage2D, target, level, internalformat, width,
          height, border, format, type, data);
 }
@@ -687,6 +884,7 @@ inline void glTexSubImage2D(
     GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
     GLsizei height, GLenum format, GLenum type, void const *pixels,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countTextureUpload(width, height, 1, format, type, pixels);
   callGL(sourceLocation, ::glTexSubImage2D, target, level, xoffset, yoffset,
          width, height, format, type, pixels);
 }
@@ -790,7 +988,13 @@ inline void glUniformMatrix4fv(
 }
 inline void glUseProgram(GLuint program, source_location const &sourceLocation =
                                              source_location::current()) {
+  auto *const cached{openGLStateCache.findProgram()};
+  if (cached != nullptr && *cached == program)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glUseProgram, program);
+  if (cached != nullptr)
+    *cached = program;
 }
 inline void glValidateProgram(
     GLuint program,
@@ -847,6 +1051,7 @@ inline void glVertexAttribPointer(
 inline void
 glViewport(GLint x, GLint y, GLsizei width, GLsizei height,
            source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glViewport, x, y, width, height);
 }
 
@@ -860,6 +1065,7 @@ inline void glDrawRangeElements(
     GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type,
     void const *indices,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDraw();
   callGL(sourceLocation, ::glDrawRangeElements, mode, start, end, count, type,
          indices);
 }
@@ -868,6 +1074,7 @@ inline void glTexImage3D(
     GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type,
     void const *pixels,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countTextureUpload(width, height, depth, format, type, pixels);
   callGL(sourceLocation, ::glTexImage3D, target, level, internalformat, width,
          height, depth, border, format, type, pixels);
 }
@@ -876,6 +1083,7 @@ inline void glTexSubImage3D(
     GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type,
     void const *pixels,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countTextureUpload(width, height, depth, format, type, pixels);
   callGL(sourceLocation, ::glTexSubImage3D, target, level, xoffset, yoffset,
          zoffset, width, height, depth, format, type, pixels);
 }
@@ -891,6 +1099,7 @@ inline void glCompressedTexImage3D(
     GLsizei height, GLsizei depth, GLint border, GLsizei imageSize,
     void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(imageSize, data);
   callGL(sourceLocation, ::glCompressedTexImage3D, target, level,
          internalformat, width, height, depth, border, imageSize, data);
 }
@@ -899,17 +1108,20 @@ inline void glCompressedTexSubImage3D(
     GLsizei width, GLsizei height, GLsizei depth, GLenum format,
     GLsizei imageSize, void const *data,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(imageSize, data);
   callGL(sourceLocation, ::glCompressedTexSubImage3D, target, level, xoffset,
          yoffset, zoffset, width, height, depth, format, imageSize, data);
 }
 inline void glGenQueries(
     GLsizei n, GLuint *ids,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenQueries, n, ids);
 }
 inline void glDeleteQueries(
     GLsizei n, GLuint const *ids,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteQueries, n, ids);
 }
 inline GLboolean
@@ -1022,16 +1234,29 @@ inline void glFlushMappedBufferRange(
 inline void glBindVertexArray(
     GLuint array,
     source_location const &sourceLocation = source_location::current()) {
+  auto *const cached{openGLStateCache.findVertexArray()};
+  if (cached != nullptr && *cached == array)
+    return;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindVertexArray, array);
+  if (cached != nullptr) {
+    *cached = array;
+    // The element array buffer binding is part of the vertex array state
+    *openGLStateCache.findBuffer(GL_ELEMENT_ARRAY_BUFFER) =
+        OpenGLStateCache::unknown;
+  }
 }
 inline void glDeleteVertexArrays(
     GLsizei n, GLuint const *arrays,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteVertexArrays, n, arrays);
+  openGLStateCache.forgetVertexArrays(n, arrays);
 }
 inline void glGenVertexArrays(
     GLsizei n, GLuint *arrays,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenVertexArrays, n, arrays);
 }
 inline GLboolean glIsVertexArray(
@@ -1057,12 +1282,22 @@ inline void glBindBufferRange(
     GLenum target, GLuint index, GLuint buffer, GLintptr offset,
     GLsizeiptr size,
     source_location const &sourceLocation = source_location::current()) {
+  // Also binds the buffer to the generic binding point of the target
+  if (auto *const cached{openGLStateCache.findBuffer(target)};
+      cached != nullptr)
+    *cached = OpenGLStateCache::unknown;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindBufferRange, target, index, buffer, offset,
          size);
 }
 inline void glBindBufferBase(
     GLenum target, GLuint index, GLuint buffer,
     source_location const &sourceLocation = source_location::current()) {
+  // Also binds the buffer to the generic binding point of the target
+  if (auto *const cached{openGLStateCache.findBuffer(target)};
+      cached != nullptr)
+    *cached = OpenGLStateCache::unknown;
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindBufferBase, target, index, buffer);
 }
 inline void glTransformFeedbackVaryings(
@@ -1240,6 +1475,7 @@ inline void glUniformBlockBinding(
 inline void glDrawArraysInstanced(
     GLenum mode, GLint first, GLsizei count, GLsizei instancecount,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDraw();
   callGL(sourceLocation, ::glDrawArraysInstanced, mode, first, count,
          instancecount);
 }
@@ -1247,12 +1483,14 @@ inline void glDrawElementsInstanced(
     GLenum mode, GLsizei count, GLenum type, void const *indices,
     GLsizei instancecount,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDraw();
   callGL(sourceLocation, ::glDrawElementsInstanced, mode, count, type, indices,
          instancecount);
 }
 inline GLsync glFenceSync(
     GLenum condition, GLbitfield flags,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(1);
   return callGL(sourceLocation, ::glFenceSync, condition, flags);
 }
 inline GLboolean
@@ -1262,6 +1500,7 @@ glIsSync(GLsync sync,
 }
 inline void glDeleteSync(GLsync sync, source_location const &sourceLocation =
                                           source_location::current()) {
+  openGLCounters.countDeletions(1);
   callGL(sourceLocation, ::glDeleteSync, sync);
 }
 inline GLenum glClientWaitSync(
@@ -1297,11 +1536,13 @@ inline void glGetBufferParameteri64v(
 inline void glGenSamplers(
     GLsizei count, GLuint *samplers,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(count);
   callGL(sourceLocation, ::glGenSamplers, count, samplers);
 }
 inline void glDeleteSamplers(
     GLsizei count, GLuint const *samplers,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDeletions(count);
   callGL(sourceLocation, ::glDeleteSamplers, count, samplers);
 }
 inline GLboolean glIsSampler(
@@ -1312,6 +1553,7 @@ inline GLboolean glIsSampler(
 inline void glBindSampler(
     GLuint unit, GLuint sampler,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindSampler, unit, sampler);
 }
 inline void glSamplerParameteri(
@@ -1352,16 +1594,19 @@ inline void glVertexAttribDivisor(
 inline void glBindTransformFeedback(
     GLenum target, GLuint id,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countStateChange();
   callGL(sourceLocation, ::glBindTransformFeedback, target, id);
 }
 inline void glDeleteTransformFeedbacks(
     GLsizei n, GLuint const *ids,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countDeletions(n);
   callGL(sourceLocation, ::glDeleteTransformFeedbacks, n, ids);
 }
 inline void glGenTransformFeedbacks(
     GLsizei n, GLuint *ids,
     source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countCreations(n);
   callGL(sourceLocation, ::glGenTransformFeedbacks, n, ids);
 }
 inline GLboolean glIsTransformFeedback(
@@ -1479,6 +1724,39 @@ inline void glGetDoublev(
   callGL(sourceLocation, ::glGetDoublev, pname, params);
 }
 #endif
+
+#if !defined(__EMSCRIPTEN__)
+
+// OpenGL 3.3+ function definitions
+
+inline void glQueryCounter(
+    GLuint id, GLenum target,
+    source_location const &sourceLocation = source_location::current()) {
+  callGL(sourceLocation, ::glQueryCounter, id, target);
+}
+inline void glGetQueryObjectui64v(
+    GLuint id, GLenum pname, GLuint64 *params,
+    source_location const &sourceLocation = source_location::current()) {
+  callGL(sourceLocation, ::glGetQueryObjectui64v, id, pname, params);
+}
+
+// OpenGL 4.4+ function definitions
+
+inline void glBufferStorage(
+    GLenum target, GLsizeiptr size, void const *data, GLbitfield flags,
+    source_location const &sourceLocation = source_location::current()) {
+  openGLCounters.countUpload(size, data);
+  callGL(sourceLocation, ::glBufferStorage, target, size, data, flags);
+}
+
+// GL_KHR_parallel_shader_compile function definitions
+
+inline void glMaxShaderCompilerThreadsKHR(
+    GLuint count,
+    source_location const &sourceLocation = source_location::current()) {
+  callGL(sourceLocation, ::glMaxShaderCompilerThreadsKHR, count);
+}
+#endif
 // NOLINTEND(readability-identifier-length)
 
 } // namespace abcg
@@ -0,0 +1,173 @@
+/**
+ * @file abcgOpenGLGPUTimer.cpp
+ * @brief Definition of abcg::OpenGLGPUTimer members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLGPUTimer.hpp"
+
+#include <span>
+
+#include "abcgOpenGLExternal.hpp"
+
+/**
+ * @brief Checks whether timer queries are supported by the current context.
+ *
+ * This must be called after the OpenGL context is created.
+ */
+void abcg::OpenGLGPUTimer::create() {
+#if defined(__EMSCRIPTEN__)
+  m_supported = false;
+#else
+  m_supported = GLEW_ARB_timer_query != 0;
+#endif
+}
+
+/**
+ * @brief Releases the query objects.
+ */
+void abcg::OpenGLGPUTimer::destroy() {
+#if !defined(__EMSCRIPTEN__)
+  for (auto &frame : m_frames) {
+    for (auto const &scope : frame.scopes) {
+      ::glDeleteQueries(1, &scope.beginQuery);
+      ::glDeleteQueries(1, &scope.endQuery);
+    }
+    frame = {};
+  }
+#endif
+  m_openScopes.clear();
+  m_results.clear();
+}
+
+/**
+ * @brief Begins a new frame.
+ *
+ * Reads the results of the frame that used the same set of queries, if they
+ * are available.
+ */
+void abcg::OpenGLGPUTimer::beginFrame() {
+  if (!m_supported)
+    return;
+
+  auto &frame{m_frames.at(m_currentFrame)};
+  if (frame.pending) {
+    readResults(frame);
+  }
+  frame.numScopes = 0;
+  m_openScopes.clear();
+}
+
+/**
+ * @brief Ends the current frame.
+ *
+ * Scopes that are still open are discarded.
+ */
+void abcg::OpenGLGPUTimer::endFrame() {
+  if (!m_supported)
+    return;
+
+  auto &frame{m_frames.at(m_currentFrame)};
+  if (!m_openScopes.empty()) {
+    frame.numScopes = m_openScopes.front();
+    m_openScopes.clear();
+  }
+  frame.pending = frame.numScopes > 0;
+  m_currentFrame = (m_currentFrame + 1) % m_frames.size();
+}
+
+/**
+ * @brief Begins a timed scope.
+ *
+ * Scopes can be nested, and must be closed with abcg::OpenGLGPUTimer::end in
+ * the same frame.
+ *
+ * @param name Name of the scope. Must be a string literal.
+ */
+void abcg::OpenGLGPUTimer::begin([[maybe_unused]] char const *name) {
+  if (!m_supported)
+    return;
+
+#if !defined(__EMSCRIPTEN__)
+  auto &frame{m_frames.at(m_currentFrame)};
+  if (frame.numScopes == frame.scopes.size()) {
+    Scope scope{};
+    ::glGenQueries(1, &scope.beginQuery);
+    ::glGenQueries(1, &scope.endQuery);
+    frame.scopes.push_back(scope);
+  }
+
+  auto &scope{frame.scopes.at(frame.numScopes)};
+  scope.name = name;
+  ::glQueryCounter(scope.beginQuery, GL_TIMESTAMP);
+  m_openScopes.push_back(frame.numScopes);
+  ++frame.numScopes;
+#endif
+}
+
+/**
+ * @brief Ends the innermost timed scope.
+ */
+void abcg::OpenGLGPUTimer::end() {
+  if (!m_supported || m_openScopes.empty())
+    return;
+
+#if !defined(__EMSCRIPTEN__)
+  auto const &frame{m_frames.at(m_currentFrame)};
+  ::glQueryCounter(frame.scopes.at(m_openScopes.back()).endQuery,
+                   GL_TIMESTAMP);
+#endif
+  m_openScopes.pop_back();
+}
+
+/**
+ * @brief Returns whether timer queries are supported.
+ */
+bool abcg::OpenGLGPUTimer::isSupported() const noexcept {
+  return m_supported;
+}
+
+/**
+ * @brief Returns the GPU times of the most recent frame whose results are
+ * available.
+ *
+ * @returns Reference to the GPU times, in the order the scopes were begun.
+ */
+std::vector<abcg::GPUTime> const &
+abcg::OpenGLGPUTimer::getResults() const noexcept {
+  return m_results;
+}
+
+void abcg::OpenGLGPUTimer::readResults(Frame &frame) {
+  frame.pending = false;
+
+#if !defined(__EMSCRIPTEN__)
+  auto const scopes{std::span{frame.scopes}.first(frame.numScopes)};
+
+  // If the results are not ready yet, the frame is dropped rather than
+  // waiting for the GPU
+  for (auto const &scope : scopes) {
+    GLuint available{};
+    ::glGetQueryObjectuiv(scope.endQuery, GL_QUERY_RESULT_AVAILABLE,
+                          &available);
+    if (available == GL_FALSE)
+      return;
+  }
+
+  m_results.clear();
+  for (auto const &scope : scopes) {
+    GLuint64 beginTime{};
+    GLuint64 endTime{};
+    ::glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &beginTime);
+    ::glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &endTime);
+    m_results.push_back(
+        {.name = scope.name,
+         .milliseconds =
+             gsl::narrow_cast<double>(endTime - beginTime) * 1e-6});
+  }
+#endif
+}
@@ -0,0 +1,80 @@
+/**
+ * @file abcgOpenGLGPUTimer.hpp
+ * @brief Header file of abcg::OpenGLGPUTimer.
+ *
+ * Declaration of abcg::OpenGLGPUTimer.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_GPU_TIMER_HPP_
+#define ABCG_OPENGL_GPU_TIMER_HPP_
+
+#include <array>
+#include <vector>
+
+#include "abcgOpenGLExternal.hpp"
+#include "abcgWindow.hpp"
+
+namespace abcg {
+class OpenGLGPUTimer;
+} // namespace abcg
+
+/**
+ * @brief Measures the GPU time of scopes of OpenGL commands.
+ *
+ * Each scope is delimited by two `GL_TIMESTAMP` queries issued with
+ * `glQueryCounter`, so scopes can be nested. The queries of a frame are read
+ * only when the same set of queries is reused three frames later, so reading
+ * the results never stalls the pipeline.
+ *
+ * The queries are issued with the OpenGL functions directly, not with the
+ * function wrappers of ABCg, so they are neither counted in the frame counters
+ * nor written to OpenGL captures (see abcg::beginOpenGLCapture).
+ *
+ * Timer queries are not supported in WebGL and OpenGL ES. In that case, all
+ * member functions do nothing and abcg::OpenGLGPUTimer::getResults returns an
+ * empty vector.
+ *
+ * @sa abcg::OpenGLWindow::getGPUTimer.
+ */
+class abcg::OpenGLGPUTimer {
+public:
+  void create();
+  void destroy();
+
+  void beginFrame();
+  void endFrame();
+
+  void begin(char const *name);
+  void end();
+
+  [[nodiscard]] bool isSupported() const noexcept;
+  [[nodiscard]] std::vector<GPUTime> const &getResults() const noexcept;
+
+private:
+  struct Scope {
+    char const *name{};
+    GLuint beginQuery{};
+    GLuint endQuery{};
+  };
+
+  struct Frame {
+    std::vector<Scope> scopes;
+    std::size_t numScopes{};
+    bool pending{};
+  };
+
+  void readResults(Frame &frame);
+
+  std::array<Frame, 3> m_frames{};
+  std::size_t m_currentFrame{};
+  std::vector<std::size_t> m_openScopes;
+  std::vector<GPUTime> m_results;
+  bool m_supported{};
+};
+
+#endif
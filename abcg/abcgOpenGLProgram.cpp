@@ -0,0 +1,369 @@
+/**
+ * @file abcgOpenGLProgram.cpp
+ * @brief Definition of abcg::OpenGLProgram members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProgram.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "abcgOpenGLFunction.hpp"
+#include "abcgOpenGLShader.hpp"
+
+/**
+ * @brief Builds the program from a list of shaders and queries its interface.
+ *
+ * The previous program, if any, is deleted.
+ *
+ * @param pathsOrSources Paths or source codes of the shaders, as given to
+ * abcg::createOpenGLProgram.
+ *
+ * @throw abcg::RuntimeError if a shader could not be compiled or the program
+ * could not be linked.
+ */
+void abcg::OpenGLProgram::create(
+    std::vector<ShaderSource> const &pathsOrSources) {
+  create(createOpenGLProgram(pathsOrSources));
+}
+
+/**
+ * @brief Takes ownership of a linked program and queries its interface.
+ *
+ * The previous program, if any, is deleted. This can be used with programs
+ * built by abcg::OpenGLProgramBuildJob.
+ *
+ * @param program ID of a linked program object.
+ */
+void abcg::OpenGLProgram::create(GLuint program) {
+  destroy();
+  m_program = program;
+  reflect();
+}
+
+/**
+ * @brief Deletes the program and clears the reflection data.
+ */
+void abcg::OpenGLProgram::destroy() {
+  if (m_program != 0) {
+    glDeleteProgram(m_program);
+    m_program = 0;
+  }
+  m_uniformLocations.clear();
+  m_attribLocations.clear();
+  m_uniformBlocks.clear();
+  m_uniforms.clear();
+}
+
+/**
+ * @brief Installs the program as part of the current rendering state.
+ */
+void abcg::OpenGLProgram::use() const { glUseProgram(m_program); }
+
+/**
+ * @brief Returns the ID of the program object.
+ */
+GLuint abcg::OpenGLProgram::getId() const noexcept { return m_program; }
+
+/**
+ * @brief Returns the location of an active uniform variable.
+ *
+ * @param name Name of the uniform variable.
+ *
+ * @returns Location of the uniform variable, or -1 if there is no active
+ * uniform variable with that name outside a uniform block.
+ */
+GLint abcg::OpenGLProgram::getUniformLocation(std::string_view name) const {
+  auto const iter{m_uniformLocations.find(name)};
+  return iter == m_uniformLocations.end() ? -1 : iter->second;
+}
+
+/**
+ * @brief Returns the location of an active vertex attribute.
+ *
+ * @param name Name of the attribute.
+ *
+ * @returns Location of the attribute, or -1 if there is no active attribute
+ * with that name.
+ */
+GLint abcg::OpenGLProgram::getAttribLocation(std::string_view name) const {
+  auto const iter{m_attribLocations.find(name)};
+  return iter == m_attribLocations.end() ? -1 : iter->second;
+}
+
+/**
+ * @brief Returns the index of an active uniform block.
+ *
+ * @param name Name of the uniform block.
+ *
+ * @returns Index of the uniform block, or `GL_INVALID_INDEX` if there is no
+ * active uniform block with that name.
+ */
+GLuint abcg::OpenGLProgram::getUniformBlockIndex(std::string_view name) const {
+  auto const iter{m_uniformBlocks.find(name)};
+  return iter == m_uniformBlocks.end() ? GL_INVALID_INDEX : iter->second.index;
+}
+
+/**
+ * @brief Returns the minimum size, in bytes, of the buffer backing an active
+ * uniform block.
+ *
+ * @param name Name of the uniform block.
+ *
+ * @returns Value of `GL_UNIFORM_BLOCK_DATA_SIZE`, or 0 if there is no active
+ * uniform block with that name.
+ */
+GLint abcg::OpenGLProgram::getUniformBlockSize(std::string_view name) const {
+  auto const iter{m_uniformBlocks.find(name)};
+  return iter == m_uniformBlocks.end() ? 0 : iter->second.size;
+}
+
+/**
+ * @brief Assigns a binding point to an active uniform block.
+ *
+ * The uniform block reads from the uniform buffer bound to that binding point
+ * (e.g., with abcg::OpenGLUniformBuffer::create). This does nothing if there is
+ * no active uniform block with the given name.
+ *
+ * @param name Name of the uniform block.
+ * @param binding Index of the uniform buffer binding point.
+ */
+void abcg::OpenGLProgram::setUniformBlockBinding(std::string_view name,
+                                                 GLuint binding) const {
+  if (auto const index{getUniformBlockIndex(name)}; index != GL_INVALID_INDEX) {
+    glUniformBlockBinding(m_program, index, binding);
+  }
+}
+
+void abcg::OpenGLProgram::reflect() {
+  auto const getProgramParameter{[this](GLenum pname) {
+    GLint value{};
+    glGetProgramiv(m_program, pname, &value);
+    return value;
+  }};
+
+  auto const addUniform{[this](std::string const &uniformName) {
+    auto const location{glGetUniformLocation(m_program, uniformName.c_str())};
+    if (location < 0)
+      return; // Member of a uniform block
+    m_uniformLocations.try_emplace(uniformName, location);
+    m_uniforms.push_back(
+        {.location = location, .value = {}, .hasValue = false});
+  }};
+
+  // Uniforms in the default uniform block
+  auto const numUniforms{getProgramParameter(GL_ACTIVE_UNIFORMS)};
+  std::vector<GLchar> name(gsl::narrow<std::size_t>(
+      std::max(getProgramParameter(GL_ACTIVE_UNIFORM_MAX_LENGTH), 1)));
+  for (auto const index : iter::range(numUniforms)) {
+    GLsizei length{};
+    GLint size{};
+    GLenum type{};
+    glGetActiveUniform(m_program, gsl::narrow<GLuint>(index),
+                       gsl::narrow<GLsizei>(name.size()), &length, &size,
+                       &type, name.data());
+    std::string const activeName{name.data(),
+                                 gsl::narrow<std::size_t>(length)};
+
+    if (activeName.ends_with("[0]")) {
+      // Register each element and the array name, which refers to the first
+      // element
+      auto const baseName{activeName.substr(0, activeName.size() - 3)};
+      for (auto const element : iter::range(size)) {
+        addUniform(fmt::format("{}[{}]", baseName, element));
+      }
+      if (auto const location{getUniformLocation(activeName)};
+          location >= 0) {
+        m_uniformLocations.try_emplace(baseName, location);
+      }
+    } else {
+      addUniform(activeName);
+    }
+  }
+  std::ranges::sort(m_uniforms, {}, &Uniform::location);
+
+  // Vertex attributes
+  auto const numAttribs{getProgramParameter(GL_ACTIVE_ATTRIBUTES)};
+  name.resize(gsl::narrow<std::size_t>(
+      std::max(getProgramParameter(GL_ACTIVE_ATTRIBUTE_MAX_LENGTH), 1)));
+  for (auto const index : iter::range(numAttribs)) {
+    GLsizei length{};
+    GLint size{};
+    GLenum type{};
+    glGetActiveAttrib(m_program, gsl::narrow<GLuint>(index),
+                      gsl::narrow<GLsizei>(name.size()), &length, &size, &type,
+                      name.data());
+    std::string attribName{name.data(), gsl::narrow<std::size_t>(length)};
+    auto const location{glGetAttribLocation(m_program, attribName.c_str())};
+    if (location >= 0) {
+      m_attribLocations.try_emplace(std::move(attribName), location);
+    }
+  }
+
+  // Uniform blocks
+  auto const numBlocks{getProgramParameter(GL_ACTIVE_UNIFORM_BLOCKS)};
+  name.resize(gsl::narrow<std::size_t>(std::max(
+      getProgramParameter(GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH), 1)));
+  for (auto const index : iter::range(numBlocks)) {
+    auto const blockIndex{gsl::narrow<GLuint>(index)};
+    GLsizei length{};
+    glGetActiveUniformBlockName(m_program, blockIndex,
+                                gsl::narrow<GLsizei>(name.size()), &length,
+                                name.data());
+    GLint size{};
+    glGetActiveUniformBlockiv(m_program, blockIndex,
+                              GL_UNIFORM_BLOCK_DATA_SIZE, &size);
+    m_uniformBlocks.try_emplace(
+        std::string{name.data(), gsl::narrow<std::size_t>(length)},
+        UniformBlock{.index = blockIndex, .size = size});
+  }
+}
+
+// Stores the value of a uniform and returns whether it must be uploaded
+bool abcg::OpenGLProgram::updateCache(GLint location, void const *value,
+                                      std::size_t size) {
+  if (location < 0)
+    return false;
+
+  auto const iter{
+      std::ranges::lower_bound(m_uniforms, location, {}, &Uniform::location)};
+  if (iter == m_uniforms.end() || iter->location != location ||
+      size > iter->value.size())
+    return true;
+
+  if (iter->hasValue && std::memcmp(iter->value.data(), value, size) == 0)
+    return false;
+
+  std::memcpy(iter->value.data(), value, size);
+  iter->hasValue = true;
+  return true;
+}
+
+/**
+ * @brief Sets the value of a `float` uniform variable.
+ *
+ * The value is not uploaded if it is equal to the last value set through this
+ * object.
+ *
+ * @param location Location of the uniform variable.
+ * @param value New value.
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, GLfloat value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform1f(location, value);
+}
+
+/**
+ * @brief Sets the value of an `int`, `bool` or sampler uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, GLint value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform1i(location, value);
+}
+
+/**
+ * @brief Sets the value of a `uint` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, GLuint value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform1ui(location, value);
+}
+
+/**
+ * @brief Sets the value of a `vec2` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::vec2 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform2fv(location, 1, &value.x);
+}
+
+/**
+ * @brief Sets the value of a `vec3` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::vec3 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform3fv(location, 1, &value.x);
+}
+
+/**
+ * @brief Sets the value of a `vec4` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::vec4 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform4fv(location, 1, &value.x);
+}
+
+/**
+ * @brief Sets the value of an `ivec2` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::ivec2 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform2iv(location, 1, &value.x);
+}
+
+/**
+ * @brief Sets the value of an `ivec3` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::ivec3 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform3iv(location, 1, &value.x);
+}
+
+/**
+ * @brief Sets the value of an `ivec4` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::ivec4 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniform4iv(location, 1, &value.x);
+}
+
+/**
+ * @brief Sets the value of a `mat2` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::mat2 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+/**
+ * @brief Sets the value of a `mat3` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::mat3 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]);
+}
+
+/**
+ * @brief Sets the value of a `mat4` uniform variable.
+ *
+ * @copydetails abcg::OpenGLProgram::setUniform(GLint, GLfloat)
+ */
+void abcg::OpenGLProgram::setUniform(GLint location, glm::mat4 const &value) {
+  if (updateCache(location, &value, sizeof(value)))
+    glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]);
+}
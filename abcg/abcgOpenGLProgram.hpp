@@ -0,0 +1,136 @@
+/**
+ * @file abcgOpenGLProgram.hpp
+ * @brief Header file of abcg::OpenGLProgram.
+ *
+ * Declaration of abcg::OpenGLProgram.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROGRAM_HPP_
+#define ABCG_OPENGL_PROGRAM_HPP_
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLExternal.hpp"
+#include "abcgShader.hpp"
+
+namespace abcg {
+class OpenGLProgram;
+} // namespace abcg
+
+/**
+ * @brief OpenGL program object with cached reflection data.
+ *
+ * The active uniforms, vertex attributes and uniform blocks of the program are
+ * queried once after the program is linked and stored in hash tables, so
+ * looking up a location by name does not call OpenGL. Each element of a
+ * uniform array is registered with its own name (e.g., `lights[1]`).
+ *
+ * The `setUniform` functions keep a copy of the last value uploaded to each
+ * uniform and skip the upload if the new value is equal:
+ * @code
+ * void Window::onCreate() {
+ *   m_program.create({{.source = vertexShader, .stage = abcg::ShaderStage::Vertex},
+ *                     {.source = fragmentShader, .stage = abcg::ShaderStage::Fragment}});
+ *   m_scaleLocation = m_program.getUniformLocation("scale");
+ * }
+ *
+ * void Window::onPaint() {
+ *   m_program.use();
+ *   m_program.setUniform(m_scaleLocation, 0.5f);
+ *   m_program.setUniform("color", glm::vec4{1.0f});
+ *   ...
+ * }
+ * @endcode
+ *
+ * @remark The `setUniform` functions upload to the program currently in use,
+ * which must be this program. Uniform values set by other means (e.g., with
+ * `glUniform*`) are not seen by the cache.
+ */
+class abcg::OpenGLProgram {
+public:
+  void create(std::vector<ShaderSource> const &pathsOrSources);
+  void create(GLuint program);
+  void destroy();
+
+  void use() const;
+
+  [[nodiscard]] GLuint getId() const noexcept;
+  [[nodiscard]] GLint getUniformLocation(std::string_view name) const;
+  [[nodiscard]] GLint getAttribLocation(std::string_view name) const;
+  [[nodiscard]] GLuint getUniformBlockIndex(std::string_view name) const;
+  [[nodiscard]] GLint getUniformBlockSize(std::string_view name) const;
+  void setUniformBlockBinding(std::string_view name, GLuint binding) const;
+
+  void setUniform(GLint location, GLfloat value);
+  void setUniform(GLint location, GLint value);
+  void setUniform(GLint location, GLuint value);
+  void setUniform(GLint location, glm::vec2 const &value);
+  void setUniform(GLint location, glm::vec3 const &value);
+  void setUniform(GLint location, glm::vec4 const &value);
+  void setUniform(GLint location, glm::ivec2 const &value);
+  void setUniform(GLint location, glm::ivec3 const &value);
+  void setUniform(GLint location, glm::ivec4 const &value);
+  void setUniform(GLint location, glm::mat2 const &value);
+  void setUniform(GLint location, glm::mat3 const &value);
+  void setUniform(GLint location, glm::mat4 const &value);
+
+  /**
+   * @brief Sets the value of a uniform variable given by its name.
+   *
+   * @param name Name of the uniform variable.
+   * @param value New value.
+   */
+  template <typename T>
+  void setUniform(std::string_view name, T const &value) {
+    setUniform(getUniformLocation(name), value);
+  }
+
+private:
+  struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const noexcept {
+      return std::hash<std::string_view>{}(str);
+    }
+  };
+
+  template <typename T>
+  using NameMap =
+      std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+  struct Uniform {
+    GLint location{-1};
+    std::array<std::byte, sizeof(glm::mat4)> value{};
+    bool hasValue{};
+  };
+
+  struct UniformBlock {
+    GLuint index{};
+    GLint size{};
+  };
+
+  void reflect();
+  [[nodiscard]] bool updateCache(GLint location, void const *value,
+                                 std::size_t size);
+
+  GLuint m_program{};
+
+  NameMap<GLint> m_uniformLocations;
+  NameMap<GLint> m_attribLocations;
+  NameMap<UniformBlock> m_uniformBlocks;
+  // Sorted by location
+  std::vector<Uniform> m_uniforms;
+};
+
+#endif
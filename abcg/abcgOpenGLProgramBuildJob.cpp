@@ -0,0 +1,244 @@
+/**
+ * @file abcgOpenGLProgramBuildJob.cpp
+ * @brief Definition of abcg::OpenGLProgramBuildJob members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProgramBuildJob.hpp"
+
+#include <algorithm>
+
+#include <gsl/gsl>
+
+#include "abcgException.hpp"
+#include "abcgOpenGLFunction.hpp"
+#include "abcgOpenGLProgramCache.hpp"
+#include "abcgTrace.hpp"
+
+/**
+ * @brief Constructs an empty build job.
+ *
+ * @param maxCompilerThreads Maximum number of background threads used by the
+ * driver to compile shaders, passed to `glMaxShaderCompilerThreadsKHR` at the
+ * first submission. The default value lets the driver choose the number of
+ * threads.
+ */
+abcg::OpenGLProgramBuildJob::OpenGLProgramBuildJob(GLuint maxCompilerThreads)
+    : m_maxCompilerThreads{maxCompilerThreads} {}
+
+/**
+ * @brief Submits a program to be built.
+ *
+ * The compilation of the shaders is triggered immediately. The callback is
+ * invoked by abcg::OpenGLProgramBuildJob::poll when the program is linked.
+ *
+ * @param pathsOrSources Paths or source codes of the shaders to be compiled
+ * and linked to the program.
+ * @param callback Function called when the program is ready.
+ * @param throwOnError Whether `poll` throws exceptions on compile/link errors
+ * of this program. If `false`, the callback receives 0 on error.
+ *
+ * @throw abcg::RuntimeError if the shader could not be read from file.
+ */
+void abcg::OpenGLProgramBuildJob::submit(
+    std::vector<ShaderSource> const &pathsOrSources, Callback const &callback,
+    bool throwOnError) {
+  TraceScope const traceScope{"OpenGLProgramBuildJob::submit", "shader"};
+
+#if !defined(__EMSCRIPTEN__)
+  if (!m_maxCompilerThreadsSet) {
+    if (isParallelCompileSupported()) {
+      abcg::glMaxShaderCompilerThreadsKHR(m_maxCompilerThreads);
+    }
+    m_maxCompilerThreadsSet = true;
+  }
+#endif
+
+  auto const sources{readOpenGLShaderSources(pathsOrSources)};
+
+  Build build;
+  build.useCache = isOpenGLProgramCacheEnabled();
+  build.throwOnError = throwOnError;
+  build.callback = callback;
+  if (build.useCache) {
+    build.hash = hashOpenGLProgram(sources);
+    build.program = loadOpenGLProgramBinary(build.hash);
+    if (build.program != 0) {
+      build.state = State::Ready;
+      m_builds.push_back(std::move(build));
+      return;
+    }
+  }
+
+  build.shaders = triggerOpenGLShaderCompile(sources);
+  build.state = State::Compiling;
+  m_builds.push_back(std::move(build));
+}
+
+/**
+ * @brief Advances the builds that have finished a stage and invokes the
+ * callbacks of the programs that are ready.
+ *
+ * Callbacks may submit new programs.
+ *
+ * @throw abcg::RuntimeError if the compilation or linking of a program
+ * submitted with `throwOnError` set to `true` has failed. The other programs
+ * remain pending.
+ *
+ * @return `true` if there are no more pending programs; `false` otherwise.
+ */
+bool abcg::OpenGLProgramBuildJob::poll() {
+  TraceScope const traceScope{"OpenGLProgramBuildJob::poll", "shader"};
+
+  for (std::size_t index{}; index < m_builds.size();) {
+    if (!isComplete(m_builds.at(index))) {
+      ++index;
+      continue;
+    }
+
+    // The build is removed before advancing so that it is not released again
+    // by cancel if an exception is thrown
+    auto const position{m_builds.begin() + gsl::narrow<std::ptrdiff_t>(index)};
+    auto build{std::move(*position)};
+    m_builds.erase(position);
+
+    advance(build);
+
+    if (build.state != State::Ready) {
+      m_builds.insert(m_builds.begin() + gsl::narrow<std::ptrdiff_t>(index),
+                      std::move(build));
+      ++index;
+      continue;
+    }
+
+    if (build.callback) {
+      build.callback(build.program);
+    }
+  }
+
+  return isDone();
+}
+
+/**
+ * @brief Releases the shader and program objects of the pending programs.
+ *
+ * The callbacks of the pending programs are not invoked. This must be called
+ * before the OpenGL context is destroyed (e.g., in `onDestroy`) if there are
+ * pending programs.
+ */
+void abcg::OpenGLProgramBuildJob::cancel() {
+  for (auto const &build : m_builds) {
+    for (auto const &shader : build.shaders) {
+      abcg::glDeleteShader(shader.shader);
+    }
+    if (build.program != 0) {
+      abcg::glDeleteProgram(build.program);
+    }
+  }
+  m_builds.clear();
+}
+
+/**
+ * @brief Returns whether there are no pending programs.
+ */
+bool abcg::OpenGLProgramBuildJob::isDone() const noexcept {
+  return m_builds.empty();
+}
+
+/**
+ * @brief Returns the number of pending programs.
+ */
+std::size_t abcg::OpenGLProgramBuildJob::getPendingCount() const noexcept {
+  return m_builds.size();
+}
+
+/**
+ * @brief Returns whether the driver compiles shaders in background threads.
+ *
+ * This is `true` if `GL_KHR_parallel_shader_compile` is supported. It is
+ * always `false` in WebGL.
+ */
+bool abcg::OpenGLProgramBuildJob::isParallelCompileSupported() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  return GLEW_KHR_parallel_shader_compile != 0;
+#endif
+}
+
+bool abcg::OpenGLProgramBuildJob::isComplete(Build const &build) {
+#if defined(__EMSCRIPTEN__)
+  (void)build;
+  return true;
+#else
+  if (build.state == State::Ready || !isParallelCompileSupported()) {
+    return true;
+  }
+
+  GLint status{};
+  if (build.state == State::Compiling) {
+    return std::ranges::all_of(build.shaders, [&status](auto const &shader) {
+      abcg::glGetShaderiv(shader.shader, GL_COMPLETION_STATUS_KHR, &status);
+      return status == GL_TRUE;
+    });
+  }
+  abcg::glGetProgramiv(build.program, GL_COMPLETION_STATUS_KHR, &status);
+  return status == GL_TRUE;
+#endif
+}
+
+void abcg::OpenGLProgramBuildJob::advance(Build &build) {
+  if (build.state == State::Compiling) {
+    // On error, the shaders are deleted
+    if (!checkOpenGLShaderCompile(build.shaders, build.throwOnError)) {
+      build.shaders.clear();
+      build.state = State::Ready;
+      return;
+    }
+
+    build.program = abcg::glCreateProgram();
+    if (build.program == 0) {
+      for (auto const &shader : build.shaders) {
+        abcg::glDeleteShader(shader.shader);
+      }
+      build.shaders.clear();
+      build.state = State::Ready;
+      if (build.throwOnError) {
+        throw abcg::RuntimeError("Failed to create program");
+      }
+      return;
+    }
+
+    for (auto const &shader : build.shaders) {
+      abcg::glAttachShader(build.program, shader.shader);
+    }
+#if !defined(__EMSCRIPTEN__)
+    if (build.useCache) {
+      abcg::glProgramParameteri(build.program,
+                                GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+    abcg::glLinkProgram(build.program);
+    for (auto const &shader : build.shaders) {
+      abcg::glDetachShader(build.program, shader.shader);
+      abcg::glDeleteShader(shader.shader);
+    }
+    build.shaders.clear();
+    build.state = State::Linking;
+    return;
+  }
+
+  if (build.state == State::Linking) {
+    // On error, the program is deleted
+    if (!checkOpenGLShaderLink(build.program, build.throwOnError)) {
+      build.program = 0;
+    } else if (build.useCache) {
+      saveOpenGLProgramBinary(build.program, build.hash);
+    }
+    build.state = State::Ready;
+  }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file abcgOpenGLProgramBuildJob.hpp
+ * @brief Header file of abcg::OpenGLProgramBuildJob.
+ *
+ * Declaration of abcg::OpenGLProgramBuildJob.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROGRAM_BUILD_JOB_HPP_
+#define ABCG_OPENGL_PROGRAM_BUILD_JOB_HPP_
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "abcgOpenGLShader.hpp"
+
+namespace abcg {
+class OpenGLProgramBuildJob;
+} // namespace abcg
+
+/**
+ * @brief Builds OpenGL programs without blocking the rendering loop.
+ *
+ * Programs are submitted with abcg::OpenGLProgramBuildJob::submit, which
+ * triggers the compilation of the shaders and returns immediately. Each call
+ * to abcg::OpenGLProgramBuildJob::poll (e.g., once per frame in `onUpdate`)
+ * advances the programs whose compilation or linking has finished and invokes
+ * the callback of each program that is ready.
+ *
+ * If `GL_KHR_parallel_shader_compile` is supported, the driver compiles and
+ * links in background threads and the status is polled with
+ * `GL_COMPLETION_STATUS_KHR`, so that `poll` never blocks. Otherwise, `poll`
+ * waits for the completion of at most one compile and one link stage per
+ * program.
+ *
+ * Programs found in the program binary cache (see
+ * abcg::isOpenGLProgramCacheEnabled) are ready at the first call to `poll`.
+ *
+ * Example:
+ * @code
+ * void Window::onCreate() {
+ *   m_buildJob.submit({{.source = "a.vert", .stage = abcg::ShaderStage::Vertex},
+ *                      {.source = "a.frag", .stage = abcg::ShaderStage::Fragment}},
+ *                     [&](GLuint program) { m_program = program; });
+ * }
+ *
+ * void Window::onUpdate() { m_buildJob.poll(); }
+ *
+ * void Window::onPaint() {
+ *   if (!m_buildJob.isDone()) {
+ *     // Render a loading screen...
+ *   }
+ * }
+ *
+ * void Window::onDestroy() { m_buildJob.cancel(); }
+ * @endcode
+ */
+class abcg::OpenGLProgramBuildJob {
+public:
+  /**
+   * @brief Function called when a program is ready.
+   *
+   * The argument is the ID of the linked program object, or 0 if the build
+   * failed and the program was submitted with `throwOnError` set to `false`.
+   */
+  using Callback = std::function<void(GLuint)>;
+
+  explicit OpenGLProgramBuildJob(
+      GLuint maxCompilerThreads = std::numeric_limits<GLuint>::max());
+
+  void submit(std::vector<ShaderSource> const &pathsOrSources,
+              Callback const &callback, bool throwOnError = true);
+  bool poll();
+  void cancel();
+
+  [[nodiscard]] bool isDone() const noexcept;
+  [[nodiscard]] std::size_t getPendingCount() const noexcept;
+
+  [[nodiscard]] static bool isParallelCompileSupported();
+
+private:
+  enum class State { Compiling, Linking, Ready };
+
+  struct Build {
+    State state{};
+    std::vector<OpenGLShader> shaders;
+    GLuint program{};
+    std::size_t hash{};
+    bool useCache{};
+    bool throwOnError{};
+    Callback callback;
+  };
+
+  [[nodiscard]] static bool isComplete(Build const &build);
+  void advance(Build &build);
+
+  std::vector<Build> m_builds;
+  GLuint m_maxCompilerThreads{};
+  bool m_maxCompilerThreadsSet{};
+};
+
+#endif
@@ -0,0 +1,280 @@
+/**
+ * @file abcgOpenGLProgramCache.cpp
+ * @brief Definition of helper functions for caching OpenGL program binaries.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProgramCache.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+
+#include "abcgExternal.hpp"
+#include "abcgOpenGLFunction.hpp"
+#include "abcgTrace.hpp"
+#include "abcgUtil.hpp"
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::optional<std::filesystem::path> cacheDirectory;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Header of a cache file. The program binary follows the header.
+struct CacheFileHeader {
+  std::uint32_t magic{};
+  std::uint32_t binaryFormat{};
+  std::uint64_t hash{};
+};
+
+constexpr std::uint32_t cacheFileMagic{0x42504741}; // "AGPB"
+
+std::filesystem::path getDefaultCacheDirectory() {
+  if (auto const *directory{SDL_getenv("ABCG_PROGRAM_CACHE")};
+      directory != nullptr) {
+    return directory;
+  }
+  std::error_code error;
+  auto const tempDirectory{std::filesystem::temp_directory_path(error)};
+  if (error) {
+    return {};
+  }
+  return tempDirectory / "abcg" / "program_cache";
+}
+
+#if !defined(__EMSCRIPTEN__)
+std::filesystem::path getCacheFilePath(std::size_t hash) {
+  return abcg::getOpenGLProgramCacheDirectory() /
+         fmt::format("{:016x}.bin", hash);
+}
+
+void removeCacheFile(std::filesystem::path const &path) {
+  std::error_code error;
+  std::filesystem::remove(path, error);
+}
+
+std::string getString(GLenum name) {
+  auto const *string{abcg::glGetString(name)};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  return string == nullptr ? "" : reinterpret_cast<char const *>(string);
+}
+
+bool isBinaryFormatSupported(GLenum binaryFormat) {
+  GLint numFormats{};
+  abcg::glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  if (numFormats <= 0) {
+    return false;
+  }
+  std::vector<GLint> formats(gsl::narrow<std::size_t>(numFormats));
+  abcg::glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data());
+  return std::ranges::find(formats, gsl::narrow_cast<GLint>(binaryFormat)) !=
+         formats.end();
+}
+#endif
+} // namespace
+
+/**
+ * @brief Sets the directory where OpenGL program binaries are cached.
+ *
+ * By default, the cache directory is given by the environment variable
+ * `ABCG_PROGRAM_CACHE` or, if it is not set, by `abcg/program_cache` in the
+ * temporary directory of the system.
+ *
+ * @param directory Path to the cache directory. An empty path disables the
+ * cache.
+ */
+void abcg::setOpenGLProgramCacheDirectory(
+    std::filesystem::path const &directory) {
+  cacheDirectory = directory;
+}
+
+/**
+ * @brief Returns the directory where OpenGL program binaries are cached.
+ *
+ * @returns Path to the cache directory, or an empty path if the cache is
+ * disabled.
+ */
+std::filesystem::path abcg::getOpenGLProgramCacheDirectory() {
+  if (!cacheDirectory.has_value()) {
+    cacheDirectory = getDefaultCacheDirectory();
+  }
+  return *cacheDirectory;
+}
+
+/**
+ * @brief Returns whether program binaries can be cached with the current
+ * OpenGL context.
+ *
+ * The cache requires `GL_ARB_get_program_binary` with at least one binary
+ * format, and a non-empty cache directory. It is always disabled in WebGL and
+ * while OpenGL calls are captured.
+ */
+bool abcg::isOpenGLProgramCacheEnabled() {
+#if defined(__EMSCRIPTEN__)
+  return false;
+#else
+  // Binaries are specific to the driver and could not be replayed elsewhere
+  if (isOpenGLCaptureActive()) {
+    return false;
+  }
+  if (GLEW_ARB_get_program_binary == 0 ||
+      getOpenGLProgramCacheDirectory().empty()) {
+    return false;
+  }
+  GLint numFormats{};
+  abcg::glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+  return numFormats > 0;
+#endif
+}
+
+/**
+ * @brief Creates a hash value that identifies the binary of a program.
+ *
+ * @param sources Shader source codes (not paths) and stages of the program.
+ *
+ * @returns Hash of the source codes, stages, and vendor, renderer and version
+ * strings of the current OpenGL context.
+ */
+std::size_t abcg::hashOpenGLProgram(std::vector<ShaderSource> const &sources) {
+  std::size_t hash{};
+  for (auto const &source : sources) {
+    hashCombineSeed(hash, source.source, source.stage);
+  }
+#if !defined(__EMSCRIPTEN__)
+  hashCombineSeed(hash, getString(GL_VENDOR), getString(GL_RENDERER),
+                  getString(GL_VERSION));
+#endif
+  return hash;
+}
+
+/**
+ * @brief Creates a program object from a cached program binary.
+ *
+ * Binaries rejected by the driver (e.g., after a driver update) are removed
+ * from the cache.
+ *
+ * @param hash Hash returned by abcg::hashOpenGLProgram.
+ *
+ * @returns ID of the linked program object, or 0 if the binary is not in the
+ * cache or was rejected.
+ */
+GLuint abcg::loadOpenGLProgramBinary(std::size_t hash) {
+#if defined(__EMSCRIPTEN__)
+  (void)hash;
+  return 0;
+#else
+  if (!isOpenGLProgramCacheEnabled()) {
+    return 0;
+  }
+
+  auto const path{getCacheFilePath(hash)};
+  std::ifstream stream{path, std::ios::binary};
+  if (!stream) {
+    return 0;
+  }
+
+  TraceScope const traceScope{"loadOpenGLProgramBinary", "shader"};
+
+  CacheFileHeader header{};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+  auto const headerRead{stream.good()};
+  std::vector<char> const binary{std::istreambuf_iterator<char>{stream}, {}};
+  stream.close();
+
+  if (!headerRead || header.magic != cacheFileMagic || header.hash != hash ||
+      binary.empty() || !isBinaryFormatSupported(header.binaryFormat)) {
+    removeCacheFile(path);
+    return 0;
+  }
+
+  auto const program{abcg::glCreateProgram()};
+  if (program == 0) {
+    return 0;
+  }
+
+  abcg::glProgramBinary(program, header.binaryFormat, binary.data(),
+                        gsl::narrow<GLsizei>(binary.size()));
+
+  GLint linkStatus{};
+  abcg::glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+  if (linkStatus == GL_FALSE) {
+    abcg::glDeleteProgram(program);
+    removeCacheFile(path);
+    return 0;
+  }
+
+  return program;
+#endif
+}
+
+/**
+ * @brief Stores the binary of a linked program object in the cache.
+ *
+ * The program should be linked with `GL_PROGRAM_BINARY_RETRIEVABLE_HINT` set
+ * to `GL_TRUE`. Failures to write to the cache are ignored.
+ *
+ * @param program ID of the linked program object.
+ * @param hash Hash returned by abcg::hashOpenGLProgram.
+ */
+void abcg::saveOpenGLProgramBinary(GLuint program, std::size_t hash) {
+#if defined(__EMSCRIPTEN__)
+  (void)program;
+  (void)hash;
+#else
+  if (program == 0 || !isOpenGLProgramCacheEnabled()) {
+    return;
+  }
+
+  GLint length{};
+  abcg::glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  TraceScope const traceScope{"saveOpenGLProgramBinary", "shader"};
+
+  std::vector<char> binary(gsl::narrow<std::size_t>(length));
+  GLenum binaryFormat{};
+  abcg::glGetProgramBinary(program, length, &length, &binaryFormat,
+                           binary.data());
+  binary.resize(gsl::narrow<std::size_t>(length));
+
+  auto const path{getCacheFilePath(hash)};
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  if (error) {
+    return;
+  }
+
+  // Write to a temporary file first so that other processes never read a
+  // partially written binary
+  auto const temporaryPath{getTemporaryFilePath(path)};
+  {
+    std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+    CacheFileHeader const header{.magic = cacheFileMagic,
+                                 .binaryFormat = binaryFormat,
+                                 .hash = hash};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    stream.write(binary.data(), gsl::narrow<std::streamsize>(binary.size()));
+    if (!stream) {
+      stream.close();
+      removeCacheFile(temporaryPath);
+      return;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    removeCacheFile(temporaryPath);
+  }
+#endif
+}
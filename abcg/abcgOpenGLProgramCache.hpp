@@ -0,0 +1,30 @@
+/**
+ * @file abcgOpenGLProgramCache.hpp
+ * @brief Declaration of helper functions for caching OpenGL program binaries.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROGRAM_CACHE_HPP_
+#define ABCG_OPENGL_PROGRAM_CACHE_HPP_
+
+#include <filesystem>
+#include <vector>
+
+#include "abcgOpenGLExternal.hpp"
+#include "abcgShader.hpp"
+
+namespace abcg {
+void setOpenGLProgramCacheDirectory(std::filesystem::path const &directory);
+[[nodiscard]] std::filesystem::path getOpenGLProgramCacheDirectory();
+[[nodiscard]] bool isOpenGLProgramCacheEnabled();
+[[nodiscard]] std::size_t
+hashOpenGLProgram(std::vector<ShaderSource> const &sources);
+[[nodiscard]] GLuint loadOpenGLProgramBinary(std::size_t hash);
+void saveOpenGLProgramBinary(GLuint program, std::size_t hash);
+} // namespace abcg
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file abcgOpenGLProgramReloader.cpp
+ * @brief Definition of abcg::OpenGLProgramReloader members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProgramReloader.hpp"
+
+#include <algorithm>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgOpenGLFunction.hpp"
+#include "abcgShaderPreprocessor.hpp"
+
+/**
+ * @brief Registers a program to be rebuilt when its shader files change.
+ *
+ * If the program is already registered, its shaders are replaced.
+ *
+ * @param program Reference to the variable that holds the ID of the program.
+ * @param pathsOrSources Paths or source codes of the shaders of the program,
+ * as given to abcg::createOpenGLProgram. Only the paths are watched.
+ * @param onReload Function called after the program is replaced.
+ */
+void abcg::OpenGLProgramReloader::add(
+    GLuint &program, std::vector<ShaderSource> const &pathsOrSources,
+    Callback const &onReload) {
+  remove(program);
+
+  Entry entry{.program = &program,
+              .pathsOrSources = pathsOrSources,
+              .files = {},
+              .onReload = onReload};
+  for (auto const &pathOrSource : pathsOrSources) {
+    std::error_code error;
+    if (std::filesystem::is_regular_file(pathOrSource.source, error)) {
+      entry.files.emplace_back(pathOrSource.source);
+    }
+  }
+  m_entries.push_back(std::move(entry));
+}
+
+/**
+ * @brief Stops watching a program.
+ *
+ * The program is not deleted. Builds in progress of this program are
+ * discarded.
+ *
+ * @param program Reference to the variable given to
+ * abcg::OpenGLProgramReloader::add.
+ */
+void abcg::OpenGLProgramReloader::remove(GLuint const &program) {
+  std::erase_if(m_entries, [&program](auto const &entry) {
+    return entry.program == &program;
+  });
+}
+
+/**
+ * @brief Rebuilds the programs that use any of the given files, including
+ * files included with `#include`.
+ *
+ * The builds run in the background and are advanced by
+ * abcg::OpenGLProgramReloader::update.
+ *
+ * @param changedFiles Paths of the modified files.
+ */
+void abcg::OpenGLProgramReloader::reload(
+    std::vector<std::filesystem::path> const &changedFiles) {
+  // The affected programs are found before invalidating the cache, which holds
+  // the include graph
+  std::vector<Entry const *> affectedEntries;
+  for (auto const &entry : m_entries) {
+    if (std::ranges::any_of(entry.files, [&changedFiles](auto const &file) {
+          return ShaderPreprocessor::dependsOn(file, changedFiles);
+        })) {
+      affectedEntries.push_back(&entry);
+    }
+  }
+
+  for (auto const &file : changedFiles) {
+    ShaderPreprocessor::invalidate(file);
+  }
+
+  for (auto const *entryPtr : affectedEntries) {
+    auto const &entry{*entryPtr};
+    try {
+      m_buildJob.submit(entry.pathsOrSources, [this, target = entry.program](
+                                                  GLuint newProgram) {
+        auto const entryIter{
+            std::ranges::find(m_entries, target, &Entry::program)};
+        if (entryIter == m_entries.end()) {
+          // Removed while building
+          abcg::glDeleteProgram(newProgram);
+          return;
+        }
+        abcg::glDeleteProgram(*target);
+        *target = newProgram;
+        fmt::print("Program reloaded\n");
+        // Copied because the callback may register programs
+        if (auto const onReload{entryIter->onReload}; onReload) {
+          onReload(newProgram);
+        }
+      });
+    } catch (abcg::RuntimeError const &exception) {
+      fmt::print("Failed to reload program: {}\n", exception.what());
+    }
+  }
+}
+
+/**
+ * @brief Advances the builds in progress and replaces the programs that are
+ * ready.
+ *
+ * This must be called regularly (e.g., once per frame). It does nothing if
+ * there are no builds in progress.
+ */
+void abcg::OpenGLProgramReloader::update() {
+  while (!m_buildJob.isDone()) {
+    try {
+      m_buildJob.poll();
+      break;
+    } catch (abcg::RuntimeError const &exception) {
+      // Keep the old program and advance the remaining builds
+      fmt::print("Failed to reload program: {}\n", exception.what());
+    }
+  }
+}
+
+/**
+ * @brief Discards the builds in progress and unregisters all programs.
+ *
+ * This must be called before the OpenGL context is destroyed.
+ */
+void abcg::OpenGLProgramReloader::destroy() {
+  m_buildJob.cancel();
+  m_entries.clear();
+}
@@ -0,0 +1,85 @@
+/**
+ * @file abcgOpenGLProgramReloader.hpp
+ * @brief Header file of abcg::OpenGLProgramReloader.
+ *
+ * Declaration of abcg::OpenGLProgramReloader.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROGRAM_RELOADER_HPP_
+#define ABCG_OPENGL_PROGRAM_RELOADER_HPP_
+
+#include <filesystem>
+#include <functional>
+#include <vector>
+
+#include "abcgOpenGLProgramBuildJob.hpp"
+
+namespace abcg {
+class OpenGLProgramReloader;
+} // namespace abcg
+
+/**
+ * @brief Rebuilds OpenGL programs when their shader files are modified.
+ *
+ * Each registered program is identified by a reference to the variable that
+ * holds its ID. When a shader file of the program is modified, the program is
+ * rebuilt in the background with abcg::OpenGLProgramBuildJob. If the build
+ * succeeds, the old program is deleted and the variable is updated with the ID
+ * of the new program. If it fails, the errors are printed and the old program
+ * is kept.
+ *
+ * abcg::OpenGLWindow feeds the reloader with the files reported by its file
+ * watcher when abcg::WindowSettings::hotReload is enabled:
+ * @code
+ * void Window::onCreate() {
+ *   auto const &assetsPath{abcg::Application::getAssetsPath()};
+ *   m_program = abcg::createOpenGLProgram(
+ *       {{.source = assetsPath + "a.vert", .stage = abcg::ShaderStage::Vertex},
+ *        {.source = assetsPath + "a.frag", .stage = abcg::ShaderStage::Fragment}});
+ *   getProgramReloader().add(m_program,
+ *       {{.source = assetsPath + "a.vert", .stage = abcg::ShaderStage::Vertex},
+ *        {.source = assetsPath + "a.frag", .stage = abcg::ShaderStage::Fragment}},
+ *       [&](GLuint program) {
+ *         m_colorLocation = abcg::glGetUniformLocation(program, "color");
+ *       });
+ * }
+ * @endcode
+ *
+ * @remark The variables must outlive the reloader or be removed with
+ * abcg::OpenGLProgramReloader::remove.
+ */
+class abcg::OpenGLProgramReloader {
+public:
+  /**
+   * @brief Function called after a program is replaced, with the ID of the new
+   * program.
+   *
+   * This can be used to query the uniform locations again.
+   */
+  using Callback = std::function<void(GLuint)>;
+
+  void add(GLuint &program, std::vector<ShaderSource> const &pathsOrSources,
+           Callback const &onReload = {});
+  void remove(GLuint const &program);
+  void reload(std::vector<std::filesystem::path> const &changedFiles);
+  void update();
+  void destroy();
+
+private:
+  struct Entry {
+    GLuint *program{};
+    std::vector<ShaderSource> pathsOrSources;
+    std::vector<std::filesystem::path> files;
+    Callback onReload;
+  };
+
+  std::vector<Entry> m_entries;
+  OpenGLProgramBuildJob m_buildJob;
+};
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file abcgOpenGLProgramVariants.cpp
+ * @brief Definition of abcg::OpenGLProgramVariants members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLProgramVariants.hpp"
+
+#include <algorithm>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgOpenGLShader.hpp"
+#include "abcgShaderPreprocessor.hpp"
+#include "abcgUtil.hpp"
+
+/**
+ * @brief Reads the shaders and declares the features of the variants.
+ *
+ * No program is built until a variant is requested with
+ * abcg::OpenGLProgramVariants::get. Variants built previously are destroyed.
+ *
+ * @param pathsOrSources Paths or source codes of the shaders, as given to
+ * abcg::createOpenGLProgram.
+ * @param features Names of the macros that are defined when the corresponding
+ * bit of the variant mask is set. At most 32 features are supported.
+ *
+ * @throw abcg::RuntimeError if a shader could not be read or there are more
+ * than 32 features.
+ */
+void abcg::OpenGLProgramVariants::create(
+    std::vector<ShaderSource> const &pathsOrSources,
+    std::vector<std::string> features) {
+  destroy();
+
+  if (features.size() > 32) {
+    throw abcg::RuntimeError(
+        fmt::format("Too many shader features ({})", features.size()));
+  }
+
+  m_sources = readOpenGLShaderSources(pathsOrSources);
+  m_features = std::move(features);
+  m_sourceHash = 0;
+  for (auto const &source : m_sources) {
+    hashCombineSeed(m_sourceHash, source.source, source.stage);
+  }
+}
+
+/**
+ * @brief Deletes all variants built so far.
+ */
+void abcg::OpenGLProgramVariants::destroy() {
+  for (auto &[key, program] : m_variants) {
+    program.destroy();
+  }
+  m_variants.clear();
+}
+
+/**
+ * @brief Returns a variant, building it if needed.
+ *
+ * @param mask Bit mask of the enabled features. Bit `i` enables the `i`-th
+ * feature given to abcg::OpenGLProgramVariants::create.
+ *
+ * @throw abcg::RuntimeError if the mask enables undeclared features, or the
+ * variant could not be built.
+ *
+ * @returns Reference to the program of the variant. The reference remains
+ * valid until abcg::OpenGLProgramVariants::destroy is called.
+ */
+abcg::OpenGLProgram &abcg::OpenGLProgramVariants::get(std::uint32_t mask) {
+  auto const key{hashCombine(m_sourceHash, mask)};
+  if (auto const iter{m_variants.find(key)}; iter != m_variants.end()) {
+    return iter->second;
+  }
+
+  if (m_features.size() < 32 && (mask >> m_features.size()) != 0) {
+    throw abcg::RuntimeError(
+        fmt::format("Invalid shader variant mask {:#x}", mask));
+  }
+
+  std::vector<std::string> defines;
+  for (auto const index : iter::range(m_features.size())) {
+    if ((mask & (1U << index)) != 0) {
+      defines.push_back(m_features.at(index));
+    }
+  }
+
+  auto sources{m_sources};
+  for (auto &source : sources) {
+    source.source = ShaderPreprocessor::insertDefines(source.source, defines);
+  }
+
+  OpenGLProgram program;
+  program.create(sources);
+  return m_variants.try_emplace(key, program).first->second;
+}
+
+/**
+ * @brief Returns the mask that enables the given features.
+ *
+ * @param features Names of the features.
+ *
+ * @throw abcg::RuntimeError if a feature was not declared.
+ */
+std::uint32_t abcg::OpenGLProgramVariants::getMask(
+    std::vector<std::string_view> const &features) const {
+  std::uint32_t mask{};
+  for (auto const &feature : features) {
+    auto const iter{std::ranges::find(m_features, feature)};
+    if (iter == m_features.end()) {
+      throw abcg::RuntimeError(
+          fmt::format("Unknown shader feature {}", feature));
+    }
+    mask |= 1U << gsl::narrow<std::uint32_t>(iter - m_features.begin());
+  }
+  return mask;
+}
+
+/**
+ * @brief Returns the names of the features.
+ */
+std::vector<std::string> const &
+abcg::OpenGLProgramVariants::getFeatures() const noexcept {
+  return m_features;
+}
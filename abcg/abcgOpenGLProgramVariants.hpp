@@ -0,0 +1,79 @@
+/**
+ * @file abcgOpenGLProgramVariants.hpp
+ * @brief Header file of abcg::OpenGLProgramVariants.
+ *
+ * Declaration of abcg::OpenGLProgramVariants.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_PROGRAM_VARIANTS_HPP_
+#define ABCG_OPENGL_PROGRAM_VARIANTS_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "abcgOpenGLProgram.hpp"
+
+namespace abcg {
+class OpenGLProgramVariants;
+} // namespace abcg
+
+/**
+ * @brief Variants of an OpenGL program built from the same shaders with
+ * different sets of preprocessor definitions.
+ *
+ * The shaders are declared once together with a list of feature names. A
+ * variant is requested with a bit mask in which bit `i` enables the `i`-th
+ * feature. The enabled features are defined with `#define` directives inserted
+ * after the `#version` directive of each shader:
+ * @code
+ * // In the shader:
+ * // #ifdef USE_TEXTURE
+ * //   outColor = texture(diffuseTex, fragTexCoord);
+ * // #endif
+ *
+ * void Window::onCreate() {
+ *   m_variants.create(
+ *       {{.source = path + "model.vert", .stage = abcg::ShaderStage::Vertex},
+ *        {.source = path + "model.frag", .stage = abcg::ShaderStage::Fragment}},
+ *       {"USE_TEXTURE", "SRGB"});
+ * }
+ *
+ * void Window::onPaint() {
+ *   auto &program{m_variants.get(m_variants.getMask({"USE_TEXTURE"}))};
+ *   program.use();
+ *   ...
+ * }
+ * @endcode
+ *
+ * Variants are built the first time they are requested and are kept until
+ * abcg::OpenGLProgramVariants::destroy is called. Each variant is also stored
+ * in the program binary cache (see abcg::isOpenGLProgramCacheEnabled), so it
+ * is not compiled again in later runs.
+ */
+class abcg::OpenGLProgramVariants {
+public:
+  void create(std::vector<ShaderSource> const &pathsOrSources,
+              std::vector<std::string> features);
+  void destroy();
+
+  [[nodiscard]] OpenGLProgram &get(std::uint32_t mask);
+  [[nodiscard]] std::uint32_t
+  getMask(std::vector<std::string_view> const &features) const;
+  [[nodiscard]] std::vector<std::string> const &getFeatures() const noexcept;
+
+private:
+  std::vector<ShaderSource> m_sources;
+  std::vector<std::string> m_features;
+  std::size_t m_sourceHash{};
+  std::unordered_map<std::size_t, OpenGLProgram> m_variants;
+};
+
+#endif
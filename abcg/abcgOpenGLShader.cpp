@@ -22,6 +22,9 @@
 #include <vector>
 
 #include "abcgException.hpp"
+#include "abcgOpenGLProgramCache.hpp"
+#include "abcgShaderPreprocessor.hpp"
+#include "abcgTrace.hpp"
 
 static void printShaderInfoLog(GLuint const shader, std::string_view prefix) {
   GLint infoLogLength{};
@@ -77,25 +80,6 @@ static void printProgramInfoLog(GLuint const program) {
   }
 };
 
-// If filenameOrText is a filename, returns the contents of the file (assumed
-// to be in text format). Otherwise, returns filenameOrText.
-[[nodiscard]] static std::string toSource(std::string_view filenameOrText) {
-  static const std::size_t maxPathSize{260};
-  if (filenameOrText.size() > maxPathSize ||
-      !std::filesystem::exists(filenameOrText)) {
-    return filenameOrText.data();
-  }
-  std::stringstream source;
-  if (std::ifstream stream(filenameOrText.data()); stream) {
-    source << stream.rdbuf();
-    stream.close();
-  } else {
-    throw abcg::RuntimeError(
-        fmt::format("Failed to read file {}", filenameOrText));
-  }
-  return source.str();
-}
-
 // Compiles a shader and returns immediately (i.e. don't wait until completion).
 // Returns the shader ID of the compiled shader.
 [[nodiscard]] static abcg::OpenGLShader
@@ -143,6 +127,27 @@ static void deleteShaders(std::vector<abcg::OpenGLShader> const &shaderIDs) {
   }
 }
 
+/**
+ * @brief Reads the source codes of a group of shaders.
+ *
+ * @param pathsOrSources Paths or source codes of the shaders.
+ *
+ * @throw abcg::RuntimeError if the shader could not be read from file.
+ *
+ * @return Source codes and stages of the shaders.
+ */
+std::vector<abcg::ShaderSource>
+abcg::readOpenGLShaderSources(std::vector<ShaderSource> const &pathsOrSources) {
+  std::vector<ShaderSource> sources;
+  sources.reserve(pathsOrSources.size());
+  for (auto const &pathOrSource : pathsOrSources) {
+    sources.push_back(
+        {.source = ShaderPreprocessor::readSource(pathOrSource.source),
+         .stage = pathOrSource.stage});
+  }
+  return sources;
+}
+
 /**
  * @brief Creates a program object from a group of shader paths or source codes.
  *
@@ -150,6 +155,12 @@ static void deleteShaders(std::vector<abcg::OpenGLShader> const &shaderIDs) {
  * linked to the program.
  * @param throwOnError Whether to throw exceptions on compile/link errors.
  *
+ * If the program binary cache is enabled (see
+ * abcg::isOpenGLProgramCacheEnabled), the program is loaded from a binary
+ * cached by a previous build of the same sources on the same driver. If there
+ * is no such binary, or if it is rejected by the driver, the shaders are
+ * compiled and linked from source and the resulting binary is cached.
+ *
  * @throw abcg::RuntimeError if the shader could not be read from file, or if
  * the program could not be created, or if the compilation of any shader has
  * failed, or if the linking has failed.
@@ -159,11 +170,17 @@ static void deleteShaders(std::vector<abcg::OpenGLShader> const &shaderIDs) {
 GLuint
 abcg::createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
                           bool throwOnError) {
-  std::vector<ShaderSource> sources;
-  sources.reserve(pathsOrSources.size());
-  for (auto const &pathOrSource : pathsOrSources) {
-    sources.push_back(
-        {.source = toSource(pathOrSource.source), .stage = pathOrSource.stage});
+  TraceScope const traceScope{"createOpenGLProgram", "shader"};
+
+  auto const sources{readOpenGLShaderSources(pathsOrSources)};
+
+  auto const useCache{isOpenGLProgramCacheEnabled()};
+  auto const programHash{useCache ? hashOpenGLProgram(sources) : 0};
+  if (useCache) {
+    if (auto const program{loadOpenGLProgramBinary(programHash)};
+        program != 0) {
+      return program;
+    }
   }
 
   std::vector<OpenGLShader> compiledShaders;
@@ -189,6 +206,13 @@ abcg::createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
     glAttachShader(shaderProgram, shader.shader);
   }
 
+#if !defined(__EMSCRIPTEN__)
+  if (useCache) {
+    glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                        GL_TRUE);
+  }
+#endif
+
   glLinkProgram(shaderProgram);
 
   for (auto const &shader : compiledShaders) {
@@ -209,6 +233,10 @@ abcg::createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
     return 0U;
   }
 
+  if (useCache) {
+    saveOpenGLProgramBinary(shaderProgram, programHash);
+  }
+
   return shaderProgram;
 }
 
@@ -237,12 +265,9 @@ abcg::createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
  */
 std::vector<abcg::OpenGLShader> abcg::triggerOpenGLShaderCompile(
     std::vector<ShaderSource> const &pathsOrSources) {
-  std::vector<ShaderSource> sources;
-  sources.reserve(pathsOrSources.size());
-  for (auto const &pathOrSource : pathsOrSources) {
-    sources.push_back(
-        {.source = toSource(pathOrSource.source), .stage = pathOrSource.stage});
-  }
+  TraceScope const traceScope{"triggerOpenGLShaderCompile", "shader"};
+
+  auto const sources{readOpenGLShaderSources(pathsOrSources)};
 
   std::vector<OpenGLShader> compiledShaders;
   compiledShaders.reserve(sources.size());
@@ -31,6 +31,8 @@ struct abcg::OpenGLShader {
 };
 
 namespace abcg {
+[[nodiscard]] std::vector<ShaderSource>
+readOpenGLShaderSources(std::vector<ShaderSource> const &pathsOrSources);
 [[nodiscard]] GLuint
 createOpenGLProgram(std::vector<ShaderSource> const &pathsOrSources,
                     bool throwOnError = true);
@@ -0,0 +1,137 @@
+/**
+ * @file abcgOpenGLStateCache.cpp
+ * @brief Definition of abcg::OpenGLStateCache members and related functions.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLStateCache.hpp"
+
+#include <algorithm>
+#include <span>
+
+namespace {
+// Sets the slots that hold one of the deleted names to a new value
+template <std::size_t N>
+void replaceNames(std::array<GLuint, N> &slots,
+                  std::span<GLuint const> deletedNames, GLuint value) {
+  for (auto &slot : slots) {
+    if (slot != 0 && std::ranges::find(deletedNames, slot) !=
+                         deletedNames.end()) {
+      slot = value;
+    }
+  }
+}
+
+std::span<GLuint const> makeSpan(GLsizei count, GLuint const *names) {
+  if (count <= 0 || names == nullptr) {
+    return {};
+  }
+  return {names, static_cast<std::size_t>(count)};
+}
+} // namespace
+
+/**
+ * @brief Enables or disables the cache of OpenGL state.
+ *
+ * The cache is reset in both cases. It is disabled by default and is enabled
+ * when the window is created if abcg::OpenGLSettings::stateCache is `true`.
+ *
+ * @param enabled Whether the cache is enabled.
+ */
+void abcg::setOpenGLStateCacheEnabled(bool enabled) noexcept {
+  openGLStateCache.reset();
+  openGLStateCache.enabled = enabled;
+}
+
+/**
+ * @brief Returns whether the cache of OpenGL state is enabled.
+ */
+bool abcg::isOpenGLStateCacheEnabled() noexcept {
+  return openGLStateCache.enabled;
+}
+
+/**
+ * @brief Marks all cached OpenGL state as unknown.
+ *
+ * This must be called after OpenGL functions are called directly instead of
+ * through the abcg wrappers, so that the next state changes are not skipped.
+ */
+void abcg::invalidateOpenGLStateCache() noexcept { openGLStateCache.reset(); }
+
+/**
+ * @brief Marks all state as unknown.
+ */
+void abcg::OpenGLStateCache::reset() noexcept {
+  program = unknown;
+  vertexArray = unknown;
+  buffers = filled<bufferTargets.size()>();
+  activeTextureUnit = unknown;
+  textures = filledTextures();
+  capabilityStates = filled<capabilities.size()>();
+  blendFunc = filled<2>();
+}
+
+/**
+ * @brief Updates the cache after a program is deleted.
+ *
+ * A program in use is only deleted when it is no longer in use, so its name
+ * cannot be reused. It is marked as unknown to be conservative.
+ *
+ * @param name Name of the deleted program.
+ */
+void abcg::OpenGLStateCache::forgetProgram(GLuint name) noexcept {
+  if (name != 0 && program == name) {
+    program = unknown;
+  }
+}
+
+/**
+ * @brief Updates the cache after vertex array objects are deleted.
+ *
+ * Deleting the bound vertex array object binds the default one.
+ *
+ * @param count Number of deleted objects.
+ * @param names Names of the deleted objects.
+ */
+void abcg::OpenGLStateCache::forgetVertexArrays(GLsizei count,
+                                                GLuint const *names) noexcept {
+  auto const deletedNames{makeSpan(count, names)};
+  if (vertexArray != 0 &&
+      std::ranges::find(deletedNames, vertexArray) != deletedNames.end()) {
+    vertexArray = 0;
+    // The element array buffer binding is part of the vertex array state
+    buffers.at(indexOf(bufferTargets, GL_ELEMENT_ARRAY_BUFFER)) = unknown;
+  }
+}
+
+/**
+ * @brief Updates the cache after buffer objects are deleted.
+ *
+ * Deleting a bound buffer binds zero to the target.
+ *
+ * @param count Number of deleted objects.
+ * @param names Names of the deleted objects.
+ */
+void abcg::OpenGLStateCache::forgetBuffers(GLsizei count,
+                                           GLuint const *names) noexcept {
+  replaceNames(buffers, makeSpan(count, names), 0);
+}
+
+/**
+ * @brief Updates the cache after texture objects are deleted.
+ *
+ * Deleting a bound texture binds zero to the target in every texture unit.
+ *
+ * @param count Number of deleted objects.
+ * @param names Names of the deleted objects.
+ */
+void abcg::OpenGLStateCache::forgetTextures(GLsizei count,
+                                            GLuint const *names) noexcept {
+  for (auto &unitTextures : textures) {
+    replaceNames(unitTextures, makeSpan(count, names), 0);
+  }
+}
@@ -0,0 +1,218 @@
+/**
+ * @file abcgOpenGLStateCache.hpp
+ * @brief Header file of abcg::OpenGLStateCache.
+ *
+ * Declaration of abcg::OpenGLStateCache and related functions.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_STATE_CACHE_HPP_
+#define ABCG_OPENGL_STATE_CACHE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+class OpenGLStateCache;
+void setOpenGLStateCacheEnabled(bool enabled) noexcept;
+[[nodiscard]] bool isOpenGLStateCacheEnabled() noexcept;
+void invalidateOpenGLStateCache() noexcept;
+} // namespace abcg
+
+/**
+ * @brief Shadow copy of the OpenGL state set by the OpenGL function wrappers.
+ *
+ * When the cache is enabled (see abcg::setOpenGLStateCacheEnabled), the
+ * wrappers of `glUseProgram`, `glBindVertexArray`, `glBindBuffer`,
+ * `glActiveTexture`, `glBindTexture`, `glEnable`, `glDisable` and
+ * `glBlendFunc` skip calls that would not change the current state.
+ *
+ * The cache only sees the state changed through the wrappers. After OpenGL is
+ * called directly (e.g., by a third-party library), the cache must be reset
+ * with abcg::invalidateOpenGLStateCache. This is done automatically after the
+ * UI is rendered.
+ *
+ * @remark The cache assumes that a single OpenGL context is used.
+ */
+class abcg::OpenGLStateCache {
+public:
+  /** @brief Value of a state that is not known. */
+  static constexpr GLuint unknown{std::numeric_limits<GLuint>::max()};
+  /** @brief Number of texture units whose bindings are tracked. */
+  static constexpr std::size_t maxTextureUnits{32};
+  /** @brief Buffer binding targets that are tracked. */
+  static constexpr std::array bufferTargets{
+      GLenum{GL_ARRAY_BUFFER},        GLenum{GL_ELEMENT_ARRAY_BUFFER},
+      GLenum{GL_UNIFORM_BUFFER},      GLenum{GL_COPY_READ_BUFFER},
+      GLenum{GL_COPY_WRITE_BUFFER},   GLenum{GL_PIXEL_PACK_BUFFER},
+      GLenum{GL_PIXEL_UNPACK_BUFFER}, GLenum{GL_TRANSFORM_FEEDBACK_BUFFER}};
+  /** @brief Texture binding targets that are tracked. */
+  static constexpr std::array textureTargets{
+      GLenum{GL_TEXTURE_2D}, GLenum{GL_TEXTURE_CUBE_MAP},
+      GLenum{GL_TEXTURE_3D}, GLenum{GL_TEXTURE_2D_ARRAY}};
+  /** @brief Capabilities that are tracked. */
+  static constexpr std::array capabilities{
+      GLenum{GL_BLEND},
+      GLenum{GL_CULL_FACE},
+      GLenum{GL_DEPTH_TEST},
+      GLenum{GL_DITHER},
+      GLenum{GL_POLYGON_OFFSET_FILL},
+      GLenum{GL_PRIMITIVE_RESTART_FIXED_INDEX},
+      GLenum{GL_RASTERIZER_DISCARD},
+      GLenum{GL_SAMPLE_ALPHA_TO_COVERAGE},
+      GLenum{GL_SAMPLE_COVERAGE},
+      GLenum{GL_SCISSOR_TEST},
+      GLenum{GL_STENCIL_TEST}};
+
+  /** @brief Whether the cache is enabled. */
+  bool enabled{};
+  /** @brief Program in use. */
+  GLuint program{unknown};
+  /** @brief Bound vertex array object. */
+  GLuint vertexArray{unknown};
+  /** @brief Buffer bound to each target of `bufferTargets`. */
+  std::array<GLuint, bufferTargets.size()> buffers{
+      filled<bufferTargets.size()>()};
+  /** @brief Index of the active texture unit. */
+  GLuint activeTextureUnit{unknown};
+  /** @brief Texture bound to each target of `textureTargets`, per unit. */
+  std::array<std::array<GLuint, textureTargets.size()>, maxTextureUnits>
+      textures{filledTextures()};
+  /** @brief State of each capability of `capabilities` (1 if enabled, 0 if
+   * disabled). */
+  std::array<GLuint, capabilities.size()> capabilityStates{
+      filled<capabilities.size()>()};
+  /** @brief Source and destination factors set by `glBlendFunc`. */
+  std::array<GLuint, 2> blendFunc{filled<2>()};
+
+  /**
+   * @brief Returns the slot of the program in use.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled.
+   */
+  [[nodiscard]] GLuint *findProgram() noexcept {
+    return enabled ? &program : nullptr;
+  }
+
+  /**
+   * @brief Returns the slot of the bound vertex array object.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled.
+   */
+  [[nodiscard]] GLuint *findVertexArray() noexcept {
+    return enabled ? &vertexArray : nullptr;
+  }
+
+  /**
+   * @brief Returns the slot of the buffer bound to a target.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled or the target is not tracked.
+   */
+  [[nodiscard]] GLuint *findBuffer(GLenum target) noexcept {
+    auto const index{indexOf(bufferTargets, target)};
+    return enabled && index < buffers.size() ? &buffers.at(index) : nullptr;
+  }
+
+  /**
+   * @brief Returns the slot of the active texture unit.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled.
+   */
+  [[nodiscard]] GLuint *findActiveTextureUnit() noexcept {
+    return enabled ? &activeTextureUnit : nullptr;
+  }
+
+  /**
+   * @brief Returns the slot of the texture bound to a target of the active
+   * texture unit.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled, the active texture unit is not known or the target is not
+   * tracked.
+   */
+  [[nodiscard]] GLuint *findTexture(GLenum target) noexcept {
+    auto const index{indexOf(textureTargets, target)};
+    if (!enabled || activeTextureUnit >= maxTextureUnits ||
+        index >= textureTargets.size()) {
+      return nullptr;
+    }
+    return &textures.at(activeTextureUnit).at(index);
+  }
+
+  /**
+   * @brief Returns the slot of the state of a capability.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled or the capability is not tracked.
+   */
+  [[nodiscard]] GLuint *findCapability(GLenum cap) noexcept {
+    auto const index{indexOf(capabilities, cap)};
+    return enabled && index < capabilityStates.size()
+               ? &capabilityStates.at(index)
+               : nullptr;
+  }
+
+  /**
+   * @brief Returns the slot of the blend factors.
+   *
+   * @returns Pointer to the cached value, or `nullptr` if the cache is
+   * disabled.
+   */
+  [[nodiscard]] std::array<GLuint, 2> *findBlendFunc() noexcept {
+    return enabled ? &blendFunc : nullptr;
+  }
+
+  void reset() noexcept;
+  void forgetProgram(GLuint name) noexcept;
+  void forgetVertexArrays(GLsizei count, GLuint const *names) noexcept;
+  void forgetBuffers(GLsizei count, GLuint const *names) noexcept;
+  void forgetTextures(GLsizei count, GLuint const *names) noexcept;
+
+private:
+  template <std::size_t N>
+  static constexpr std::array<GLuint, N> filled() noexcept {
+    std::array<GLuint, N> values{};
+    values.fill(unknown);
+    return values;
+  }
+
+  static constexpr std::array<std::array<GLuint, textureTargets.size()>,
+                              maxTextureUnits>
+  filledTextures() noexcept {
+    std::array<std::array<GLuint, textureTargets.size()>, maxTextureUnits>
+        values{};
+    values.fill(filled<textureTargets.size()>());
+    return values;
+  }
+
+  template <std::size_t N>
+  static constexpr std::size_t indexOf(std::array<GLenum, N> const &values,
+                                       GLenum value) noexcept {
+    for (std::size_t index{}; index < N; ++index) {
+      if (values[index] == value) {
+        return index;
+      }
+    }
+    return N;
+  }
+};
+
+namespace abcg {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+/** @brief Shadow copy of the state of the current OpenGL context. */
+inline OpenGLStateCache openGLStateCache{};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+} // namespace abcg
+
+#endif
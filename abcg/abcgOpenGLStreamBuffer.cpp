@@ -0,0 +1,227 @@
+/**
+ * @file abcgOpenGLStreamBuffer.cpp
+ * @brief Definition of abcg::OpenGLStreamBuffer members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgOpenGLStreamBuffer.hpp"
+
+#include <cstring>
+
+#include "abcgBlockLayout.hpp"
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgOpenGLFunction.hpp"
+
+namespace {
+// Maximum time waited for a fence in each call of glClientWaitSync
+constexpr GLuint64 fenceTimeout{1'000'000'000}; // 1 s
+
+abcg::OpenGLStreamBuffer::Mode getSupportedMode() {
+#if defined(__EMSCRIPTEN__)
+  // WebGL does not support mapping buffers. The emulation of glMapBufferRange
+  // by Emscripten copies the data with glBufferSubData anyway, and it does not
+  // accept GL_MAP_UNSYNCHRONIZED_BIT.
+  return abcg::OpenGLStreamBuffer::Mode::SubData;
+#else
+  // Data written to mapped buffers is not captured
+  if (abcg::isOpenGLCaptureActive()) {
+    return abcg::OpenGLStreamBuffer::Mode::SubData;
+  }
+  if (GLEW_VERSION_4_4 != 0 || GLEW_ARB_buffer_storage != 0) {
+    return abcg::OpenGLStreamBuffer::Mode::Persistent;
+  }
+  return abcg::OpenGLStreamBuffer::Mode::Mapped;
+#endif
+}
+} // namespace
+
+/**
+ * @brief Creates the buffer object.
+ *
+ * The buffer object is not bound to any target. Uploads use the
+ * `GL_COPY_WRITE_BUFFER` target so that the bindings of the vertex array
+ * object in use are not changed.
+ *
+ * This must be called after the OpenGL context is created.
+ *
+ * @param regionSize Size of the region of each frame, in bytes. The size of
+ * the buffer object is abcg::OpenGLStreamBuffer::regionCount times this size.
+ *
+ * @throw abcg::RuntimeError if the persistent mapping fails.
+ */
+void abcg::OpenGLStreamBuffer::create(std::size_t regionSize) {
+  destroy();
+
+  m_mode = getSupportedMode();
+  m_regionSize = regionSize;
+  auto const size{gsl::narrow<GLsizeiptr>(m_regionSize * regionCount)};
+
+  abcg::glGenBuffers(1, &m_buffer);
+  abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+#if !defined(__EMSCRIPTEN__)
+  if (m_mode == Mode::Persistent) {
+    GLbitfield const flags{GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                           GL_MAP_COHERENT_BIT};
+    abcg::glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, flags);
+    m_mapped = static_cast<std::byte *>(
+        abcg::glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (m_mapped == nullptr) {
+      destroy();
+      throw abcg::RuntimeError("Failed to map stream buffer");
+    }
+    return;
+  }
+#endif
+  abcg::glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+  abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+/**
+ * @brief Unmaps and deletes the buffer object and the fences.
+ */
+void abcg::OpenGLStreamBuffer::destroy() {
+  for (auto &fence : m_fences) {
+    if (fence != nullptr) {
+      abcg::glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  if (m_mapped != nullptr) {
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    abcg::glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_mapped = nullptr;
+  }
+  abcg::glDeleteBuffers(1, &m_buffer);
+  m_buffer = 0;
+  m_region = 0;
+  m_head = 0;
+}
+
+/**
+ * @brief Moves to the region of the next frame.
+ *
+ * This must be called once per frame, before the first push of the frame. A
+ * fence is inserted after the commands issued since the previous call, which
+ * may read the data of the previous region. If the next region is still being
+ * read by the GPU, this waits for its fence (persistent mapping) or orphans the
+ * storage of the buffer (unsynchronized mapping).
+ */
+void abcg::OpenGLStreamBuffer::beginFrame() {
+  if (m_buffer == 0)
+    return;
+
+  if (m_mode != Mode::SubData && m_head > 0) {
+    auto &fence{m_fences.at(m_region)};
+    if (fence != nullptr) {
+      abcg::glDeleteSync(fence);
+    }
+    fence = abcg::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  m_region = (m_region + 1) % regionCount;
+  m_head = 0;
+  waitForRegion();
+}
+
+/**
+ * @brief Appends data to the region of the current frame.
+ *
+ * @param data Pointer to the data to be written.
+ * @param size Size of the data, in bytes.
+ * @param alignment Alignment of the offset of the data in the buffer object,
+ * in bytes (e.g., `GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT` for uniform blocks).
+ *
+ * @returns Offset of the data in the buffer object, in bytes. It can be used
+ * as the offset of a draw call, or as the offset of `glBindBufferRange`.
+ *
+ * @throw abcg::RuntimeError if the data does not fit in the region, or if the
+ * buffer cannot be mapped.
+ */
+std::size_t abcg::OpenGLStreamBuffer::push(void const *data, std::size_t size,
+                                           std::size_t alignment) {
+  auto const regionStart{m_region * m_regionSize};
+  auto const offset{alignBlockOffset(regionStart + m_head, alignment)};
+  if (offset + size > regionStart + m_regionSize) {
+    throw abcg::RuntimeError(
+        fmt::format("Stream buffer region of {} bytes is full", m_regionSize));
+  }
+  m_head = offset + size - regionStart;
+
+  switch (m_mode) {
+  case Mode::Persistent:
+    std::memcpy(std::next(m_mapped, gsl::narrow<std::ptrdiff_t>(offset)), data,
+                size);
+    // Writes to the mapped memory are not seen by the function wrappers
+    openGLCounters.countUpload(gsl::narrow<std::int64_t>(size), data);
+    break;
+  case Mode::Mapped: {
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    // The range is not read by the GPU, as its region is protected by a fence
+    auto *mapped{abcg::glMapBufferRange(
+        GL_COPY_WRITE_BUFFER, gsl::narrow<GLintptr>(offset),
+        gsl::narrow<GLsizeiptr>(size),
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+            GL_MAP_UNSYNCHRONIZED_BIT)};
+    if (mapped == nullptr) {
+      abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+      throw abcg::RuntimeError("Failed to map stream buffer");
+    }
+    std::memcpy(mapped, data, size);
+    abcg::glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    openGLCounters.countUpload(gsl::narrow<std::int64_t>(size), data);
+    break;
+  }
+  case Mode::SubData:
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    abcg::glBufferSubData(GL_COPY_WRITE_BUFFER, gsl::narrow<GLintptr>(offset),
+                          gsl::narrow<GLsizeiptr>(size), data);
+    abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    break;
+  }
+  return offset;
+}
+
+// Ensures that the GPU has finished reading the current region
+void abcg::OpenGLStreamBuffer::waitForRegion() {
+  auto &fence{m_fences.at(m_region)};
+  if (fence == nullptr)
+    return;
+
+  if (m_mode == Mode::Persistent) {
+    auto status{GLenum{GL_TIMEOUT_EXPIRED}};
+    while (status == GL_TIMEOUT_EXPIRED) {
+      status = abcg::glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      fenceTimeout);
+    }
+  } else if (abcg::glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+    // Orphaning the storage is cheaper than stalling
+    orphan();
+    return;
+  }
+  abcg::glDeleteSync(fence);
+  fence = nullptr;
+}
+
+// Replaces the storage of the buffer object, so that none of its regions is
+// being read by the GPU
+void abcg::OpenGLStreamBuffer::orphan() {
+  for (auto &fence : m_fences) {
+    if (fence != nullptr) {
+      abcg::glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+  abcg::glBufferData(GL_COPY_WRITE_BUFFER,
+                     gsl::narrow<GLsizeiptr>(m_regionSize * regionCount),
+                     nullptr, GL_STREAM_DRAW);
+  abcg::glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
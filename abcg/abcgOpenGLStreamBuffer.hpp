@@ -0,0 +1,142 @@
+/**
+ * @file abcgOpenGLStreamBuffer.hpp
+ * @brief Header file of abcg::OpenGLStreamBuffer.
+ *
+ * Declaration of abcg::OpenGLStreamBuffer.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_STREAM_BUFFER_HPP_
+#define ABCG_OPENGL_STREAM_BUFFER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "abcgOpenGLExternal.hpp"
+
+namespace abcg {
+class OpenGLStreamBuffer;
+} // namespace abcg
+
+/**
+ * @brief Buffer object for data that is written every frame, such as dynamic
+ * vertex data.
+ *
+ * The buffer is split into three regions, one per frame. Data is appended to
+ * the region of the current frame with abcg::OpenGLStreamBuffer::push, which
+ * returns the offset of the data in the buffer object. Before a region is
+ * reused, a fence ensures that the GPU has finished reading it. This avoids
+ * creating buffers or reallocating their storage in the frame loop:
+ * @code
+ * void Window::onCreate() {
+ *   ...
+ *   m_streamBuffer.create(64 * 1024);
+ *   abcg::glGenVertexArrays(1, &m_VAO);
+ *   abcg::glBindVertexArray(m_VAO);
+ *   abcg::glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer.getId());
+ *   abcg::glEnableVertexAttribArray(0);
+ *   abcg::glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+ *   abcg::glBindVertexArray(0);
+ * }
+ *
+ * void Window::onPaint() {
+ *   m_streamBuffer.beginFrame();
+ *   auto const offset{m_streamBuffer.push(std::span{m_positions})};
+ *   abcg::glBindVertexArray(m_VAO);
+ *   abcg::glDrawArrays(GL_POINTS, offset / sizeof(glm::vec2),
+ *                      m_positions.size());
+ *   ...
+ * }
+ * @endcode
+ *
+ * The buffer is written in one of the following ways (see
+ * abcg::OpenGLStreamBuffer::Mode):
+ *
+ * - If `glBufferStorage` is supported (OpenGL 4.4 or
+ * `GL_ARB_buffer_storage`), the storage is mapped once with a persistent and
+ * coherent mapping, and the data is copied directly to the mapped memory.
+ * - Otherwise (e.g., OpenGL ES 3.0), each push maps the range to be written
+ * with `glMapBufferRange` without synchronization. If the region to be reused
+ * is still being read by the GPU, the storage is orphaned instead of waiting
+ * for the fence.
+ * - In WebGL 2.0, which does not support mapping buffers, and while OpenGL
+ * calls are being captured (see abcg::beginOpenGLCapture), the data is
+ * uploaded with `glBufferSubData`.
+ */
+class abcg::OpenGLStreamBuffer {
+public:
+  /** @brief How the data is written to the buffer object. */
+  enum class Mode {
+    /** @brief Persistent and coherent mapping of the whole buffer. */
+    Persistent,
+    /** @brief Unsynchronized mapping of each range written. */
+    Mapped,
+    /** @brief Upload with `glBufferSubData`. */
+    SubData
+  };
+
+  /** @brief Number of regions of the buffer, i.e., the number of frames that
+   * can be in flight. */
+  static constexpr std::size_t regionCount{3};
+
+  void create(std::size_t regionSize);
+  void destroy();
+
+  void beginFrame();
+
+  [[nodiscard]] std::size_t push(void const *data, std::size_t size,
+                                 std::size_t alignment = 16);
+
+  /**
+   * @brief Appends an array of elements to the region of the current frame.
+   *
+   * The offset is aligned to the size of the element, so that
+   * `offset / sizeof(T)` is the index of the first element in the buffer
+   * object (e.g., the `first` argument of `glDrawArrays`).
+   *
+   * @param data Elements to be written.
+   *
+   * @returns Offset of the first element in the buffer object, in bytes.
+   *
+   * @throw abcg::RuntimeError if the data does not fit in the region.
+   */
+  template <typename T, std::size_t Extent>
+  [[nodiscard]] std::size_t push(std::span<T, Extent> data) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable types can be pushed");
+    return push(data.data(), data.size_bytes(), sizeof(T));
+  }
+
+  /**
+   * @brief Returns the ID of the buffer object.
+   */
+  [[nodiscard]] GLuint getId() const noexcept { return m_buffer; }
+
+  /**
+   * @brief Returns how the data is written to the buffer object.
+   */
+  [[nodiscard]] Mode getMode() const noexcept { return m_mode; }
+
+private:
+  void waitForRegion();
+  void orphan();
+
+  GLuint m_buffer{};
+  Mode m_mode{Mode::SubData};
+  std::size_t m_regionSize{};
+  std::size_t m_region{};
+  // Number of bytes written to the current region
+  std::size_t m_head{};
+  // Fence of the commands that read each region
+  std::array<GLsync, regionCount> m_fences{};
+  // Start of the persistent mapping
+  std::byte *m_mapped{};
+};
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file abcgOpenGLUniformBuffer.hpp
+ * @brief Header file of abcg::OpenGLUniformBuffer.
+ *
+ * Declaration and definition of abcg::OpenGLUniformBuffer.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_OPENGL_UNIFORM_BUFFER_HPP_
+#define ABCG_OPENGL_UNIFORM_BUFFER_HPP_
+
+#include <cstring>
+#include <type_traits>
+
+#include "abcgBlockLayout.hpp"
+#include "abcgOpenGLFunction.hpp"
+
+namespace abcg {
+template <typename T> class OpenGLUniformBuffer;
+} // namespace abcg
+
+/**
+ * @brief Uniform buffer object that holds a uniform block.
+ *
+ * The contents of the block are given by a C++ struct whose layout should be
+ * checked against the std140 rules with abcg::isStd140. The whole block is
+ * uploaded with a single `glBufferSubData` call, and only when its value
+ * changes:
+ * @code
+ * struct ObjectBlock {
+ *   glm::vec4 color;
+ *   float scale;
+ * };
+ * static_assert(abcg::isStd140<ObjectBlock>(
+ *     ABCG_BLOCK_FIELD(ObjectBlock, color),
+ *     ABCG_BLOCK_FIELD(ObjectBlock, scale)));
+ *
+ * void Window::onCreate() {
+ *   ...
+ *   m_program.setUniformBlockBinding("Object", 0);
+ *   m_objectBuffer.create(0);
+ * }
+ *
+ * void Window::onPaint() {
+ *   m_program.use();
+ *   m_objectBuffer.update({.color = {1, 1, 1, 1}, .scale = 0.5f});
+ *   ...
+ * }
+ * @endcode
+ *
+ * The buffer holds a single block, so updating it between draw calls of the
+ * same frame may stall until the GPU has finished the previous draws. For data
+ * that changes per draw, append the blocks to an abcg::OpenGLStreamBuffer with
+ * the alignment `GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT` and bind each one with
+ * `glBindBufferRange`.
+ *
+ * @tparam T Trivially copyable struct that mirrors the uniform block.
+ */
+template <typename T> class abcg::OpenGLUniformBuffer {
+  static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>,
+                "Uniform blocks must be trivially copyable standard-layout "
+                "types");
+
+public:
+  /**
+   * @brief Creates the buffer object and binds it to a uniform buffer binding
+   * point.
+   *
+   * The contents of the buffer are undefined until
+   * abcg::OpenGLUniformBuffer::update is called.
+   *
+   * @param binding Index of the binding point.
+   */
+  void create(GLuint binding) {
+    destroy();
+    m_binding = binding;
+
+    abcg::glGenBuffers(1, &m_buffer);
+    abcg::glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    // Blocks are rounded up to a multiple of 16 bytes in the std140 layout
+    abcg::glBufferData(GL_UNIFORM_BUFFER, alignBlockOffset(sizeof(T), 16),
+                       nullptr, GL_DYNAMIC_DRAW);
+    abcg::glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    bind();
+  }
+
+  /**
+   * @brief Deletes the buffer object.
+   */
+  void destroy() {
+    abcg::glDeleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+    m_hasData = false;
+  }
+
+  /**
+   * @brief Binds the buffer to its binding point.
+   *
+   * This is only needed if another buffer was bound to the same binding point
+   * after abcg::OpenGLUniformBuffer::create.
+   */
+  void bind() const {
+    abcg::glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_buffer);
+  }
+
+  /**
+   * @brief Uploads the contents of the uniform block.
+   *
+   * The upload is skipped if the contents are equal to the last uploaded
+   * contents.
+   *
+   * @param data New contents of the block.
+   */
+  void update(T const &data) {
+    if (m_hasData && std::memcmp(&m_data, &data, sizeof(T)) == 0)
+      return;
+    std::memcpy(&m_data, &data, sizeof(T));
+    m_hasData = true;
+
+    abcg::glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    abcg::glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+    abcg::glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  }
+
+  /**
+   * @brief Returns the ID of the buffer object.
+   */
+  [[nodiscard]] GLuint getId() const noexcept { return m_buffer; }
+
+  /**
+   * @brief Returns the index of the binding point.
+   */
+  [[nodiscard]] GLuint getBinding() const noexcept { return m_binding; }
+
+private:
+  GLuint m_buffer{};
+  GLuint m_binding{};
+  T m_data{};
+  bool m_hasData{};
+};
+
+#endif
@@ -17,6 +17,7 @@
 
 #include "abcgEmbeddedFonts.hpp"
 #include "abcgException.hpp"
+#include "abcgProfiler.hpp"
 #include "abcgWindow.hpp"
 
 /**
@@ -57,7 +58,12 @@ void abcg::OpenGLWindow::saveScreenshotPNG(std::string_view filename) const {
 
   auto const numPixels{gsl::narrow<std::size_t>(size.x * size.y * channels)};
   std::vector<unsigned char> pixels(numPixels);
-  glReadBuffer(m_openGLSettings.doubleBuffering ? GL_BACK : GL_FRONT);
+  if (m_headlessFBO != 0) {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_headlessFBO);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+  } else {
+    glReadBuffer(m_openGLSettings.doubleBuffering ? GL_BACK : GL_FRONT);
+  }
   glReadPixels(0, 0, size.x, size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
 
   // Flip upside down
@@ -132,31 +138,7 @@ void abcg::OpenGLWindow::onPaint() {
 void abcg::OpenGLWindow::onPaintUI() {
   // FPS counter
   if (abcg::Window::getWindowSettings().showFPS) {
-    auto fps{ImGui::GetIO().Framerate};
-
-    static auto offset{0UL};
-    static auto refreshTime{ImGui::GetTime()};
-    static std::array<float, 150> frames{};
-
-    while (refreshTime < ImGui::GetTime()) {
-      auto const refreshFrequency{60.0};
-      frames.at(offset) = fps;
-      offset = (offset + 1) % frames.size();
-      refreshTime += (1.0 / refreshFrequency);
-    }
-
-    ImGui::SetNextWindowPos(ImVec2(5, 5));
-    ImGui::Begin("FPS", nullptr,
-                 ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs |
-                     ImGuiWindowFlags_NoBringToFrontOnFocus |
-                     ImGuiWindowFlags_NoFocusOnAppearing);
-    auto const label{fmt::format("avg {:.1f} FPS", fps)};
-    ImGui::PlotLines("", frames.data(), gsl::narrow<int>(frames.size()),
-                     gsl::narrow<int>(offset), label.c_str(), 0.0f,
-                     // *std::ranges::max_element(frames) * 2,
-                     *std::max_element(frames.begin(), frames.end()) * 2,
-                     ImVec2(gsl::narrow<float>(frames.size()), 50));
-    ImGui::End();
+    abcg::Window::paintFPSCounter();
   }
 
   // Fullscreen button
@@ -206,13 +188,31 @@ void abcg::OpenGLWindow::onResize([[maybe_unused]] glm::ivec2 const &size) {}
 /**
  * @brief Custom handler called for each frame before painting.
  *
- * This virtual function is called just before abcg::VulkanWindow::onPaint, even
- * if the window is minimized.
+ * This virtual function is called just before abcg::VulkanWindow::onPaint. It
+ * is not called while the window is hidden or minimized.
  *
  * Override it for custom behavior. By default, it does nothing.
  */
 void abcg::OpenGLWindow::onUpdate() {}
 
+/**
+ * @brief Custom handler called at a fixed rate.
+ *
+ * This virtual function is called zero or more times per frame, just before
+ * abcg::OpenGLWindow::onUpdate, so that it is called on average once every
+ * abcg::WindowSettings::fixedTimeStep seconds. It is not called if
+ * abcg::WindowSettings::fixedTimeStep is zero.
+ *
+ * Use it to advance simulations that must be independent of the frame rate.
+ * When rendering, abcg::Window::getFixedUpdateAlpha can be used to
+ * interpolate between the two latest simulation states.
+ *
+ * Override it for custom behavior. By default, it does nothing.
+ *
+ * @param timeStep Fixed time step, in seconds.
+ */
+void abcg::OpenGLWindow::onFixedUpdate([[maybe_unused]] double timeStep) {}
+
 /**
  * @brief Custom handler for cleaning up OpenGL resources.
  *
@@ -222,25 +222,60 @@ void abcg::OpenGLWindow::onUpdate() {}
  */
 void abcg::OpenGLWindow::onDestroy() {}
 
+/**
+ * @brief Returns the GPU timer of the window.
+ *
+ * Use it in abcg::OpenGLWindow::onPaint to measure the GPU time of custom
+ * scopes, e.g.:
+ *
+ * @code
+ * getGPUTimer().begin("Shadow pass");
+ * // ...
+ * getGPUTimer().end();
+ * @endcode
+ *
+ * The built-in scopes are "onPaint" and "UI".
+ *
+ * @returns Reference to the abcg::OpenGLGPUTimer object.
+ */
+abcg::OpenGLGPUTimer &abcg::OpenGLWindow::getGPUTimer() noexcept {
+  return m_GPUTimer;
+}
+
+/**
+ * @brief Returns the program reloader of the window.
+ *
+ * Programs registered in the reloader are rebuilt when their shader files are
+ * modified, if abcg::WindowSettings::hotReload is `true`. The programs are
+ * replaced just before abcg::OpenGLWindow::onUpdate.
+ *
+ * @returns Reference to the abcg::OpenGLProgramReloader object.
+ */
+abcg::OpenGLProgramReloader &abcg::OpenGLWindow::getProgramReloader() noexcept {
+  return m_programReloader;
+}
+
+/**
+ * @copydoc abcg::Window::getGPUTimes
+ */
+std::vector<abcg::GPUTime> const &abcg::OpenGLWindow::getGPUTimes() const {
+  return m_GPUTimer.getResults();
+}
+
+/**
+ * @copydoc abcg::Window::getFrameCounters
+ */
+std::vector<abcg::FrameCounter> const &
+abcg::OpenGLWindow::getFrameCounters() const {
+  return m_frameCounters;
+}
+
 void abcg::OpenGLWindow::handleEvent(SDL_Event const &event) {
   if (event.window.windowID != abcg::Window::getSDLWindowID())
     return;
 
   if (event.type == SDL_WINDOWEVENT) {
     switch (event.window.event) {
-    case SDL_WINDOWEVENT_HIDDEN:
-      m_hidden = true;
-      break;
-    case SDL_WINDOWEVENT_SHOWN:
-    case SDL_WINDOWEVENT_EXPOSED:
-      m_hidden = false;
-      break;
-    case SDL_WINDOWEVENT_MINIMIZED:
-      m_minimized = true;
-      break;
-    case SDL_WINDOWEVENT_RESTORED:
-      m_minimized = false;
-      break;
     case SDL_WINDOWEVENT_SIZE_CHANGED:
     case SDL_WINDOWEVENT_RESIZED: {
       onResize(getWindowSize());
@@ -253,6 +288,11 @@ void abcg::OpenGLWindow::handleEvent(SDL_Event const &event) {
   onEvent(event);
 }
 
+void abcg::OpenGLWindow::filesChanged(
+    std::vector<std::filesystem::path> const &files) {
+  m_programReloader.reload(files);
+}
+
 void abcg::OpenGLWindow::create() {
 #if defined(__EMSCRIPTEN__)
   if (!m_openGLSettings.doubleBuffering) {
@@ -296,22 +336,29 @@ void abcg::OpenGLWindow::create() {
   m_GLSLVersion =
       fmt::format("#version {:d}{:02d}", majorVersion, minorVersion * 10);
 
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  int const debugFlag{m_openGLSettings.debugCallback ? SDL_GL_CONTEXT_DEBUG_FLAG
+                                                     : 0};
+#else
+  int const debugFlag{};
+#endif
+
   switch (profile) {
   case OpenGLProfile::Core:
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS,
-                        SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG);
+                        SDL_GL_CONTEXT_FORWARD_COMPATIBLE_FLAG | debugFlag);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
                         SDL_GL_CONTEXT_PROFILE_CORE);
     m_GLSLVersion += " core";
     break;
   case OpenGLProfile::Compatibility:
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, debugFlag);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK,
                         SDL_GL_CONTEXT_PROFILE_COMPATIBILITY);
     m_GLSLVersion += " compatibility";
     break;
   case OpenGLProfile::ES:
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, 0);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, debugFlag);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
     m_GLSLVersion += " es";
     break;
@@ -324,6 +371,11 @@ void abcg::OpenGLWindow::create() {
   SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, m_openGLSettings.depthBufferSize);
   SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, m_openGLSettings.stencilBufferSize);
 
+  if (abcg::Window::getWindowSettings().headless) {
+    // The offscreen framebuffer is not multisampled
+    m_openGLSettings.samples = 0;
+  }
+
   if (m_openGLSettings.samples > 0) {
     // Enable multisampling
     SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
@@ -368,11 +420,42 @@ void abcg::OpenGLWindow::create() {
   fmt::print("Using GLEW.....: {}\n", glewGetString(GLEW_VERSION));
 #endif
 
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+  if (m_openGLSettings.debugCallback && !enableOpenGLDebugCallback()) {
+    fmt::print("Warning: OpenGL debug output not supported, using "
+               "glGetError instead\n");
+  }
+#endif
+
   fmt::print("OpenGL vendor..: {}\n", glGetString(GL_VENDOR));
   fmt::print("OpenGL renderer: {}\n", glGetString(GL_RENDERER));
   fmt::print("OpenGL version.: {}\n", glGetString(GL_VERSION));
   fmt::print("GLSL version...: {}\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
 
+#if !defined(__EMSCRIPTEN__)
+  if (auto const &capturePath{abcg::Window::getWindowSettings().capturePath};
+      !capturePath.empty()) {
+    OpenGLCaptureInfo info{};
+    SDL_GL_GetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, &info.majorVersion);
+    SDL_GL_GetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, &info.minorVersion);
+    SDL_GL_GetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, &info.profileMask);
+    auto const windowSize{getWindowSize()};
+    info.width = windowSize.x;
+    info.height = windowSize.y;
+    beginOpenGLCapture(capturePath, info);
+    fmt::print("Capturing OpenGL calls to {}\n", capturePath);
+  }
+#endif
+
+  setOpenGLStateCacheEnabled(m_openGLSettings.stateCache);
+  setOpenGLCountersEnabled(abcg::Window::getWindowSettings().frameCounters);
+
+  if (abcg::Window::getWindowSettings().headless) {
+    createHeadlessFramebuffer();
+  }
+
+  m_GPUTimer.create();
+
   /*
   // Print out extensions
   GLint numExtensions{};
@@ -419,13 +502,29 @@ void abcg::OpenGLWindow::create() {
 }
 
 void abcg::OpenGLWindow::paint() {
-  onUpdate();
+#if !defined(__EMSCRIPTEN__)
+  updateCapture();
+#endif
 
-  if (m_hidden || m_minimized)
-    return;
+  m_programReloader.update();
+
+  {
+    ABCG_PROFILE_SCOPE("onUpdate");
+    onUpdate();
+  }
 
   SDL_GL_MakeCurrent(abcg::Window::getSDLWindow(), m_GLContext);
 
+  if (m_headlessFBO != 0) {
+    if (getWindowSize() != m_headlessSize) {
+      createHeadlessFramebuffer();
+      onResize(getWindowSize());
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, m_headlessFBO);
+  }
+
+  m_GPUTimer.beginFrame();
+
 #if defined(__EMSCRIPTEN__)
   // Force window size in windowed mode
   EmscriptenFullscreenChangeEvent fullscreenStatus{};
@@ -441,38 +540,173 @@ void abcg::OpenGLWindow::paint() {
   ImGui_ImplSDL2_NewFrame();
   ImGui::NewFrame();
 
-  onPaintUI();
+  {
+    ABCG_PROFILE_SCOPE("onPaintUI");
+    onPaintUI();
+  }
 
-  ImGui::Render();
+#if defined(ABCG_PROFILER)
+  if (abcg::Window::getWindowSettings().showProfiler) {
+    Profiler::paintUI();
+  }
+#endif
 
-  onPaint();
+  {
+    ABCG_PROFILE_SCOPE("ImGui::Render");
+    ImGui::Render();
+  }
 
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-  if (m_openGLSettings.doubleBuffering) {
+  {
+    ABCG_PROFILE_SCOPE("onPaint");
+    m_GPUTimer.begin("onPaint");
+    onPaint();
+    m_GPUTimer.end();
+  }
+
+  {
+    ABCG_PROFILE_SCOPE("ImGui_ImplOpenGL3_RenderDrawData");
+    m_GPUTimer.begin("UI");
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    // The ImGui backend calls OpenGL directly
+    invalidateOpenGLStateCache();
+    m_GPUTimer.end();
+  }
+
+  m_GPUTimer.endFrame();
+  updateFrameCounters();
+
+  ABCG_PROFILE_SCOPE("Swap");
+  if (m_headlessFBO != 0) {
+    // Nothing to present. Wait for the frame to complete so that the GPU does
+    // not fall behind.
+    glFinish();
+  } else if (m_openGLSettings.doubleBuffering) {
     SDL_GL_SwapWindow(abcg::Window::getSDLWindow());
   } else {
     glFinish();
   }
 }
 
+void abcg::OpenGLWindow::fixedUpdate(double timeStep) {
+  ABCG_PROFILE_SCOPE("onFixedUpdate");
+  onFixedUpdate(timeStep);
+}
+
 void abcg::OpenGLWindow::destroy() {
   onDestroy();
 
+  m_programReloader.destroy();
+  m_GPUTimer.destroy();
+  destroyHeadlessFramebuffer();
+
   if (ImGui::GetCurrentContext() != nullptr) {
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
   }
   if (m_GLContext != nullptr) {
+#if !defined(NDEBUG) && !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+    disableOpenGLDebugCallback();
+#endif
+#if !defined(__EMSCRIPTEN__)
+    endOpenGLCapture();
+#endif
+    setOpenGLStateCacheEnabled(false);
+    setOpenGLCountersEnabled(false);
     SDL_GL_DeleteContext(m_GLContext);
     m_GLContext = nullptr;
   }
 }
 
 [[nodiscard]] glm::ivec2 abcg::OpenGLWindow::getWindowSize() const {
+  if (auto const &windowSettings{abcg::Window::getWindowSettings()};
+      windowSettings.headless) {
+    return {windowSettings.width, windowSettings.height};
+  }
+
   glm::ivec2 size{};
   if (auto *window{abcg::Window::getSDLWindow()}; window != nullptr) {
     SDL_GL_GetDrawableSize(window, &size.x, &size.y);
   }
   return size;
 }
+
+// Creates or resizes the framebuffer object that replaces the default
+// framebuffer in headless mode
+void abcg::OpenGLWindow::createHeadlessFramebuffer() {
+  m_headlessSize = getWindowSize();
+
+  if (m_headlessFBO == 0) {
+    glGenFramebuffers(1, &m_headlessFBO);
+    glGenRenderbuffers(1, &m_headlessColorRBO);
+    glGenRenderbuffers(1, &m_headlessDepthStencilRBO);
+  }
+
+  glBindRenderbuffer(GL_RENDERBUFFER, m_headlessColorRBO);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_headlessSize.x,
+                        m_headlessSize.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, m_headlessDepthStencilRBO);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_headlessSize.x,
+                        m_headlessSize.y);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, m_headlessFBO);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_RENDERBUFFER, m_headlessColorRBO);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                            GL_RENDERBUFFER, m_headlessDepthStencilRBO);
+
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    throw abcg::RuntimeError("Failed to create offscreen framebuffer");
+  }
+}
+
+void abcg::OpenGLWindow::destroyHeadlessFramebuffer() {
+  if (m_headlessFBO == 0)
+    return;
+
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glDeleteRenderbuffers(1, &m_headlessDepthStencilRBO);
+  glDeleteRenderbuffers(1, &m_headlessColorRBO);
+  glDeleteFramebuffers(1, &m_headlessFBO);
+  m_headlessDepthStencilRBO = 0;
+  m_headlessColorRBO = 0;
+  m_headlessFBO = 0;
+}
+
+#if !defined(__EMSCRIPTEN__)
+// Marks the beginning of a frame in the capture file, or ends the capture
+// after the last frame to be measured
+void abcg::OpenGLWindow::updateCapture() {
+  if (!isOpenGLCaptureActive()) {
+    return;
+  }
+  auto const &windowSettings{abcg::Window::getWindowSettings()};
+  auto const frame{abcg::Window::getFrameCount() - 1};
+  if (frame >=
+      windowSettings.captureFirstFrame + windowSettings.captureFrameCount) {
+    endOpenGLCapture();
+    fmt::print("OpenGL calls captured to {}\n", windowSettings.capturePath);
+    return;
+  }
+  markOpenGLCaptureFrame(frame, frame >= windowSettings.captureFirstFrame);
+}
+#endif
+
+// Stores the counts of the frame just painted and starts counting the next one
+void abcg::OpenGLWindow::updateFrameCounters() {
+  m_frameCounters.clear();
+  if (!isOpenGLCountersEnabled()) {
+    return;
+  }
+  m_frameCounters = {{.name = "GL calls", .value = openGLCounters.calls},
+                     {.name = "draw calls", .value = openGLCounters.drawCalls},
+                     {.name = "state changes",
+                      .value = openGLCounters.stateChanges},
+                     {.name = "uploads", .value = openGLCounters.uploads},
+                     {.name = "bytes uploaded",
+                      .value = openGLCounters.bytesUploaded},
+                     {.name = "creations", .value = openGLCounters.creations},
+                     {.name = "deletions", .value = openGLCounters.deletions}};
+  openGLCounters.reset();
+}
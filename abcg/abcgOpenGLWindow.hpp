@@ -17,6 +17,8 @@
 
 #include "abcgExternal.hpp"
 #include "abcgOpenGLFunction.hpp"
+#include "abcgOpenGLGPUTimer.hpp"
+#include "abcgOpenGLProgramReloader.hpp"
 #include "abcgWindow.hpp"
 
 namespace abcg {
@@ -77,6 +79,17 @@ struct abcg::OpenGLSettings {
   bool vSync{false};
   /** @brief Whether the output is double buffered. */
   bool doubleBuffering{true};
+  /** @brief Whether OpenGL errors are reported by a debug message callback
+   * instead of `glGetError` in debug builds.
+   *
+   * A debug context is requested, and the error checks of the OpenGL function
+   * wrappers become much cheaper. This falls back to `glGetError` if debug
+   * output is not supported. @sa abcg::enableOpenGLDebugCallback. */
+  bool debugCallback{false};
+  /** @brief Whether the OpenGL function wrappers skip redundant state changes.
+   *
+   * @sa abcg::OpenGLStateCache. */
+  bool stateCache{false};
 };
 
 /**
@@ -92,6 +105,7 @@ struct abcg::OpenGLSettings {
  * @sa abcg::OpenGLWindow::onPaintUI for UI rendering.
  * @sa abcg::OpenGLWindow::onResize for handling of window resize events.
  * @sa abcg::OpenGLWindow::onUpdate for commands to be called every frame.
+ * @sa abcg::OpenGLWindow::onFixedUpdate for commands to be called at a fixed rate.
  * @sa abcg::OpenGLWindow::onDestroy for cleaning up OpenGL resources.
 
  * @remark Objects of this type cannot be copied or copy-constructed.
@@ -102,6 +116,10 @@ public:
   void setOpenGLSettings(OpenGLSettings const &openGLSettings) noexcept;
   void saveScreenshotPNG(std::string_view filename) const;
 
+  [[nodiscard]] std::vector<GPUTime> const &getGPUTimes() const final;
+  [[nodiscard]] std::vector<FrameCounter> const &
+  getFrameCounters() const final;
+
 protected:
   virtual void onEvent(SDL_Event const &event);
   virtual void onCreate();
@@ -109,20 +127,40 @@ protected:
   virtual void onPaintUI();
   virtual void onResize(glm::ivec2 const &size);
   virtual void onUpdate();
+  virtual void onFixedUpdate(double timeStep);
   virtual void onDestroy();
 
+  [[nodiscard]] OpenGLGPUTimer &getGPUTimer() noexcept;
+  [[nodiscard]] OpenGLProgramReloader &getProgramReloader() noexcept;
+
 private:
   void handleEvent(SDL_Event const &event) final;
   void create() final;
   void paint() final;
+  void fixedUpdate(double timeStep) final;
   void destroy() final;
   [[nodiscard]] glm::ivec2 getWindowSize() const final;
+  void filesChanged(std::vector<std::filesystem::path> const &files) final;
+
+  void createHeadlessFramebuffer();
+  void destroyHeadlessFramebuffer();
+  void updateFrameCounters();
+#if !defined(__EMSCRIPTEN__)
+  void updateCapture();
+#endif
 
   OpenGLSettings m_openGLSettings;
   std::string m_GLSLVersion;
   SDL_GLContext m_GLContext{};
-  bool m_hidden{};
-  bool m_minimized{};
+  OpenGLGPUTimer m_GPUTimer;
+  OpenGLProgramReloader m_programReloader;
+  std::vector<FrameCounter> m_frameCounters;
+
+  // Offscreen framebuffer used as the default framebuffer in headless mode
+  GLuint m_headlessFBO{};
+  GLuint m_headlessColorRBO{};
+  GLuint m_headlessDepthStencilRBO{};
+  glm::ivec2 m_headlessSize{};
 };
 
 #endif
@@ -0,0 +1,376 @@
+/**
+ * @file abcgProfiler.cpp
+ * @brief Definition of abcg::Profiler and abcg::ProfileScope members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgProfiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "abcgExternal.hpp"
+
+namespace {
+// Single-producer, single-consumer lock-free ring buffer
+template <typename T, std::size_t Capacity> class RingBuffer {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  bool push(T const &item) {
+    auto const head{m_head.load(std::memory_order_relaxed)};
+    if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+      return false;
+    m_items.at(head & (Capacity - 1)) = item;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename Function> void drain(Function const &function) {
+    auto const tail{m_tail.load(std::memory_order_relaxed)};
+    auto const head{m_head.load(std::memory_order_acquire)};
+    for (auto index{tail}; index != head; ++index) {
+      function(m_items.at(index & (Capacity - 1)));
+    }
+    m_tail.store(head, std::memory_order_release);
+  }
+
+private:
+  std::array<T, Capacity> m_items{};
+  std::atomic<std::size_t> m_head{};
+  std::atomic<std::size_t> m_tail{};
+};
+
+struct ThreadBuffer {
+  RingBuffer<abcg::Profiler::Event, 4096> events;
+  std::uint32_t index{};
+  std::atomic<bool> inUse{true};
+};
+
+// Releases the buffer of a thread when the thread exits
+struct ThreadBufferHandle {
+  ThreadBufferHandle() = default;
+  ThreadBufferHandle(ThreadBufferHandle const &) = delete;
+  ThreadBufferHandle(ThreadBufferHandle &&) = delete;
+  ThreadBufferHandle &operator=(ThreadBufferHandle const &) = delete;
+  ThreadBufferHandle &operator=(ThreadBufferHandle &&) = delete;
+  ~ThreadBufferHandle() {
+    if (buffer != nullptr)
+      buffer->inUse.store(false, std::memory_order_release);
+  }
+
+  ThreadBuffer *buffer{};
+};
+
+struct ScopeHistory {
+  std::array<double, 120> totals{};
+  std::size_t offset{};
+  // Number of elements of totals that were written
+  std::size_t count{};
+  std::size_t calls{};
+  double frameTotal{};
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+thread_local ThreadBufferHandle threadBuffer;
+thread_local std::uint32_t scopeDepth{};
+
+std::int64_t frameBegin{};
+std::int64_t frameEnd{};
+std::uint32_t frameThread{};
+std::vector<abcg::Profiler::Event> frameEvents;
+std::unordered_map<std::string_view, ScopeHistory> histories;
+std::vector<abcg::Profiler::ScopeStatistics> statistics;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+ThreadBuffer &getThreadBuffer() {
+  if (threadBuffer.buffer == nullptr) {
+    std::scoped_lock const lock{registryMutex};
+    // Reuse the buffer of a thread that has exited
+    auto const unused{std::ranges::find_if(registry, [](auto const &buffer) {
+      return !buffer->inUse.load(std::memory_order_acquire);
+    })};
+    if (unused != registry.end()) {
+      (*unused)->inUse.store(true, std::memory_order_release);
+      threadBuffer.buffer = unused->get();
+    } else {
+      registry.push_back(std::make_unique<ThreadBuffer>());
+      registry.back()->index = gsl::narrow<std::uint32_t>(registry.size() - 1);
+      threadBuffer.buffer = registry.back().get();
+    }
+  }
+  return *threadBuffer.buffer;
+}
+
+ImU32 colorFromName(std::string_view name) {
+  auto const hash{std::hash<std::string_view>{}(name)};
+  auto const hue{gsl::narrow_cast<float>(hash % 360) / 360.0f};
+  ImVec4 color{0, 0, 0, 1};
+  ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.8f, color.x, color.y, color.z);
+  return ImGui::ColorConvertFloat4ToU32(color);
+}
+} // namespace
+
+/**
+ * @brief Marks the beginning of a frame.
+ *
+ * This is called by abcg::Window at the beginning of each frame. Scopes
+ * created until the matching call to abcg::Profiler::endFrame are nested in a
+ * scope named "Frame".
+ */
+void abcg::Profiler::beginFrame() {
+  frameBegin = now();
+  frameThread = getThreadBuffer().index;
+  ++scopeDepth;
+}
+
+/**
+ * @brief Marks the end of a frame.
+ *
+ * This is called by abcg::Window at the end of each frame. It collects the
+ * events recorded by all threads since the last call and updates the scope
+ * statistics.
+ */
+void abcg::Profiler::endFrame() {
+  frameEnd = now();
+  --scopeDepth;
+
+  frameEvents.clear();
+  frameEvents.push_back({.name = "Frame",
+                         .begin = frameBegin,
+                         .end = frameEnd,
+                         .depth = scopeDepth,
+                         .thread = frameThread});
+  {
+    std::scoped_lock const lock{registryMutex};
+    for (auto const &buffer : registry) {
+      buffer->events.drain(
+          [](Event const &event) { frameEvents.push_back(event); });
+    }
+  }
+
+  for (auto &[name, history] : histories) {
+    history.frameTotal = 0.0;
+    history.calls = 0;
+  }
+  for (auto const &event : frameEvents) {
+    auto &history{histories[event.name]};
+    history.frameTotal += gsl::narrow_cast<double>(event.end - event.begin) *
+                          1e-6; // Milliseconds
+    ++history.calls;
+  }
+
+  statistics.clear();
+  for (auto &[name, history] : histories) {
+    history.totals.at(history.offset) = history.frameTotal;
+    history.offset = (history.offset + 1) % history.totals.size();
+    history.count = std::min(history.count + 1, history.totals.size());
+
+    // The elements not written yet are zero
+    double sum{};
+    double maximum{};
+    for (auto const total : history.totals) {
+      sum += total;
+      maximum = std::max(maximum, total);
+    }
+    statistics.push_back(
+        {.name = name,
+         .last = history.frameTotal,
+         .average = sum / gsl::narrow_cast<double>(history.count),
+         .maximum = maximum,
+         .calls = history.calls});
+  }
+  std::ranges::sort(statistics, [](auto const &lhs, auto const &rhs) {
+    return lhs.average > rhs.average;
+  });
+}
+
+/**
+ * @brief Records a profiling event in the buffer of the calling thread.
+ *
+ * The event is discarded if the buffer is full.
+ *
+ * @param event Event to be recorded.
+ */
+void abcg::Profiler::record(Event const &event) {
+  auto &buffer{getThreadBuffer()};
+  auto eventWithThread{event};
+  eventWithThread.thread = buffer.index;
+  buffer.events.push(eventWithThread);
+}
+
+/**
+ * @brief Returns the current time of the profiler clock.
+ *
+ * @returns Time, in nanoseconds, of `std::chrono::steady_clock`.
+ */
+std::int64_t abcg::Profiler::now() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief Returns the index of the calling thread.
+ *
+ * Threads are numbered in the order they first record an event. The thread
+ * that runs the main loop usually has index 0.
+ *
+ * @returns Index of the thread, as stored in abcg::Profiler::Event::thread.
+ */
+std::uint32_t abcg::Profiler::getThreadIndex() {
+  return getThreadBuffer().index;
+}
+
+/**
+ * @brief Returns the events collected in the last call to
+ * abcg::Profiler::endFrame.
+ *
+ * @returns Reference to the vector of events of the last frame.
+ */
+std::vector<abcg::Profiler::Event> const &abcg::Profiler::getFrameEvents() {
+  return frameEvents;
+}
+
+/**
+ * @brief Returns the timing statistics of each scope name.
+ *
+ * @returns Reference to the vector of statistics, sorted in decreasing order of
+ * average time.
+ */
+std::vector<abcg::Profiler::ScopeStatistics> const &
+abcg::Profiler::getScopeStatistics() {
+  return statistics;
+}
+
+/**
+ * @brief Paints the profiler overlay with Dear ImGui.
+ *
+ * The overlay contains a flame graph of the scopes of the last frame recorded
+ * by the thread that runs the main loop, and a table with the statistics of
+ * each scope. It must be called between `ImGui::NewFrame` and
+ * `ImGui::Render`.
+ */
+void abcg::Profiler::paintUI() {
+  auto const windowFlags{ImGuiWindowFlags_NoFocusOnAppearing |
+                         ImGuiWindowFlags_NoBringToFrontOnFocus};
+  ImGui::SetNextWindowSize(ImVec2(480, 320), ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowPos(ImVec2(5, 100), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("Profiler", nullptr, windowFlags)) {
+    ImGui::End();
+    return;
+  }
+
+  // Flame graph
+  auto const frameDuration{
+      gsl::narrow_cast<float>(std::max(frameEnd - frameBegin, std::int64_t{1}))};
+  ImGui::Text("Frame: %.3f ms", gsl::narrow_cast<double>(frameDuration) * 1e-6);
+
+  std::uint32_t maxDepth{};
+  for (auto const &event : frameEvents) {
+    if (event.thread == frameThread)
+      maxDepth = std::max(maxDepth, event.depth);
+  }
+
+  auto const rowHeight{ImGui::GetTextLineHeight() + 4.0f};
+  auto const origin{ImGui::GetCursorScreenPos()};
+  auto const width{std::max(ImGui::GetContentRegionAvail().x, 1.0f)};
+  auto const height{rowHeight * gsl::narrow_cast<float>(maxDepth + 1)};
+  ImGui::InvisibleButton("##flamegraph", ImVec2(width, height));
+
+  auto *drawList{ImGui::GetWindowDrawList()};
+  auto const mouse{ImGui::GetIO().MousePos};
+  for (auto const &event : frameEvents) {
+    if (event.thread != frameThread)
+      continue;
+
+    auto const x0{origin.x +
+                  width * gsl::narrow_cast<float>(event.begin - frameBegin) /
+                      frameDuration};
+    auto const x1{origin.x +
+                  width * gsl::narrow_cast<float>(event.end - frameBegin) /
+                      frameDuration};
+    auto const y0{origin.y + rowHeight * gsl::narrow_cast<float>(event.depth)};
+    ImVec2 const min{std::max(x0, origin.x), y0};
+    ImVec2 const max{std::max(std::min(x1, origin.x + width), min.x + 1.0f),
+                     y0 + rowHeight - 1.0f};
+
+    drawList->AddRectFilled(min, max, colorFromName(event.name));
+    drawList->PushClipRect(min, max, true);
+    drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f),
+                      IM_COL32(0, 0, 0, 255), event.name);
+    drawList->PopClipRect();
+
+    if (ImGui::IsItemHovered() && mouse.x >= min.x && mouse.x < max.x &&
+        mouse.y >= min.y && mouse.y < max.y) {
+      ImGui::SetTooltip(
+          "%s: %.3f ms", event.name,
+          gsl::narrow_cast<double>(event.end - event.begin) * 1e-6);
+    }
+  }
+
+  // Table of scope statistics
+  auto const tableFlags{ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                        ImGuiTableFlags_ScrollY |
+                        ImGuiTableFlags_SizingStretchProp};
+  if (ImGui::BeginTable("##scopes", 5, tableFlags)) {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Scope");
+    ImGui::TableSetupColumn("Last (ms)");
+    ImGui::TableSetupColumn("Avg (ms)");
+    ImGui::TableSetupColumn("Max (ms)");
+    ImGui::TableSetupColumn("Calls");
+    ImGui::TableHeadersRow();
+    for (auto const &scope : statistics) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(scope.name.data(),
+                             scope.name.data() + scope.name.size());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", scope.last);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", scope.average);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", scope.maximum);
+      ImGui::TableNextColumn();
+      ImGui::Text("%zu", scope.calls);
+    }
+    ImGui::EndTable();
+  }
+
+  ImGui::End();
+}
+
+/**
+ * @brief Begins a profiling scope.
+ *
+ * @param name Name of the scope. Must be a string literal.
+ */
+abcg::ProfileScope::ProfileScope(char const *name)
+    : m_name{name}, m_begin{Profiler::now()} {
+  ++scopeDepth;
+}
+
+/**
+ * @brief Ends the profiling scope and records it.
+ */
+abcg::ProfileScope::~ProfileScope() {
+  --scopeDepth;
+  Profiler::record({.name = m_name,
+                    .begin = m_begin,
+                    .end = Profiler::now(),
+                    .depth = scopeDepth});
+}
@@ -0,0 +1,129 @@
+/**
+ * @file abcgProfiler.hpp
+ * @brief Header file of abcg::Profiler and abcg::ProfileScope.
+ *
+ * Declaration of abcg::Profiler and abcg::ProfileScope, and definition of the
+ * ABCG_PROFILE_SCOPE macro.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_PROFILER_HPP_
+#define ABCG_PROFILER_HPP_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace abcg {
+class Profiler;
+class ProfileScope;
+} // namespace abcg
+
+/**
+ * @brief CPU profiler of the rendering loop.
+ *
+ * Profiling scopes created with ABCG_PROFILE_SCOPE store their begin and end
+ * times in a lock-free ring buffer owned by the calling thread. Once per frame,
+ * abcg::Profiler::endFrame moves the events of all threads to the list of
+ * events of the last frame and updates the statistics of each scope.
+ *
+ * The profiler is only used if ABCg is built with the CMake option
+ * `ENABLE_PROFILER`, which defines the preprocessor symbol `ABCG_PROFILER`.
+ * Otherwise, ABCG_PROFILE_SCOPE expands to nothing.
+ *
+ * @sa abcg::WindowSettings::showProfiler.
+ */
+class abcg::Profiler {
+public:
+  /**
+   * @brief Profiled scope.
+   */
+  struct Event {
+    /** @brief Name of the scope. Must be a string literal. */
+    char const *name{};
+    /** @brief Begin time, in nanoseconds. */
+    std::int64_t begin{};
+    /** @brief End time, in nanoseconds. */
+    std::int64_t end{};
+    /** @brief Nesting level of the scope in its thread. */
+    std::uint32_t depth{};
+    /** @brief Index of the thread that created the scope. */
+    std::uint32_t thread{};
+  };
+
+  /**
+   * @brief Timing statistics of all scopes with the same name.
+   */
+  struct ScopeStatistics {
+    /** @brief Name of the scope. */
+    std::string_view name;
+    /** @brief Total time spent in the scope in the last frame, in
+     * milliseconds. */
+    double last{};
+    /** @brief Average total time per frame over the last 120 frames, or
+     * over the frames since the scope was first entered, in milliseconds. */
+    double average{};
+    /** @brief Maximum total time per frame, in milliseconds. */
+    double maximum{};
+    /** @brief Number of times the scope was entered in the last frame. */
+    std::size_t calls{};
+  };
+
+  static void beginFrame();
+  static void endFrame();
+  static void record(Event const &event);
+
+  [[nodiscard]] static std::int64_t now();
+  [[nodiscard]] static std::uint32_t getThreadIndex();
+  [[nodiscard]] static std::vector<Event> const &getFrameEvents();
+  [[nodiscard]] static std::vector<ScopeStatistics> const &
+  getScopeStatistics();
+
+  static void paintUI();
+};
+
+/**
+ * @brief RAII object that records a profiling scope.
+ *
+ * The scope begins when the object is constructed and ends when it is
+ * destroyed. Use the ABCG_PROFILE_SCOPE macro instead of creating this object
+ * directly.
+ */
+class abcg::ProfileScope {
+public:
+  explicit ProfileScope(char const *name);
+  ProfileScope(ProfileScope const &) = delete;
+  ProfileScope(ProfileScope &&) = delete;
+  ProfileScope &operator=(ProfileScope const &) = delete;
+  ProfileScope &operator=(ProfileScope &&) = delete;
+  ~ProfileScope();
+
+private:
+  char const *m_name{};
+  std::int64_t m_begin{};
+};
+
+// @cond Skipped by Doxygen
+#define ABCG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ABCG_PROFILE_CONCAT(a, b) ABCG_PROFILE_CONCAT_IMPL(a, b)
+// @endcond
+
+#if defined(ABCG_PROFILER)
+/**
+ * @brief Profiles the enclosing scope.
+ *
+ * @param name Name of the scope. Must be a string literal.
+ */
+#define ABCG_PROFILE_SCOPE(name)                                               \
+  abcg::ProfileScope const ABCG_PROFILE_CONCAT(abcgProfileScope, __LINE__) {   \
+    name                                                                       \
+  }
+#else
+#define ABCG_PROFILE_SCOPE(name)
+#endif
+
+#endif
@@ -11,11 +11,14 @@
 #ifndef ABCG_SHADER_HPP_
 #define ABCG_SHADER_HPP_
 
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 
 namespace abcg {
 struct ShaderSource;
+struct ShaderBinary;
 enum class ShaderStage;
 }; // namespace abcg
 
@@ -54,4 +57,17 @@ struct abcg::ShaderSource {
   abcg::ShaderStage stage{};
 };
 
+/**
+ * @brief Precompiled SPIR-V code and corresponding stage.
+ *
+ * Objects of this type are generated at build time by the `abcg_add_shaders`
+ * CMake function.
+ */
+struct abcg::ShaderBinary {
+  /** @brief SPIR-V words. */
+  std::span<std::uint32_t const> code{};
+  /** @brief Shader stage. */
+  abcg::ShaderStage stage{};
+};
+
 #endif
@@ -0,0 +1,325 @@
+/**
+ * @file abcgShaderPreprocessor.cpp
+ * @brief Definition of abcg::ShaderPreprocessor members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgShaderPreprocessor.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+
+#include "abcgApplication.hpp"
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+
+namespace {
+struct CachedFile {
+  std::string contents;
+  // Files included directly by this file, or std::nullopt if the file has not
+  // been preprocessed yet
+  std::optional<std::vector<std::filesystem::path>> includes;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex cacheMutex;
+std::map<std::filesystem::path, CachedFile> cache;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+std::filesystem::path toCanonical(std::filesystem::path const &path) {
+  std::error_code error;
+  auto canonical{std::filesystem::weakly_canonical(path, error)};
+  return error ? path : canonical;
+}
+
+bool isFile(std::string_view pathOrSource) {
+  static constexpr std::size_t maxPathSize{260};
+  std::error_code error;
+  return pathOrSource.size() <= maxPathSize &&
+         std::filesystem::is_regular_file(std::filesystem::path{pathOrSource},
+                                          error);
+}
+
+// Returns the contents of a file given by its canonical path
+std::string readFile(std::filesystem::path const &file) {
+  {
+    std::scoped_lock const lock{cacheMutex};
+    if (auto const iter{cache.find(file)}; iter != cache.end()) {
+      return iter->second.contents;
+    }
+  }
+
+  std::stringstream contents;
+  if (std::ifstream stream{file}; stream) {
+    contents << stream.rdbuf();
+  } else {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to read file {}", file.string()));
+  }
+
+  std::scoped_lock const lock{cacheMutex};
+  return cache
+      .try_emplace(file,
+                   CachedFile{.contents = contents.str(), .includes = {}})
+      .first->second.contents;
+}
+
+void setIncludes(std::filesystem::path const &file,
+                 std::vector<std::filesystem::path> includes) {
+  std::scoped_lock const lock{cacheMutex};
+  if (auto const iter{cache.find(file)}; iter != cache.end()) {
+    iter->second.includes = std::move(includes);
+  }
+}
+
+// Returns the name of the file of an #include directive, or std::nullopt if
+// the line is not an #include directive
+std::optional<std::string_view> parseInclude(std::string_view line) {
+  auto const skipBlanks{[&line] {
+    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+  }};
+
+  skipBlanks();
+  if (!line.starts_with('#'))
+    return std::nullopt;
+  line.remove_prefix(1);
+  skipBlanks();
+  if (!line.starts_with("include"))
+    return std::nullopt;
+  line.remove_prefix(std::string_view{"include"}.size());
+  skipBlanks();
+
+  if (line.empty() || (line.front() != '"' && line.front() != '<'))
+    return std::nullopt;
+  auto const end{line.find(line.front() == '"' ? '"' : '>', 1)};
+  if (end == std::string_view::npos)
+    return std::nullopt;
+  return line.substr(1, end - 1);
+}
+
+// Returns the canonical path of an included file. The file is searched in the
+// directory of the including file, then in the assets directory.
+std::filesystem::path findInclude(std::string_view name,
+                                  std::filesystem::path const &includer) {
+  std::vector<std::filesystem::path> candidates;
+  if (!includer.empty()) {
+    candidates.push_back(includer.parent_path() / name);
+  }
+  candidates.push_back(
+      std::filesystem::path{abcg::Application::getAssetsPath()} / name);
+
+  for (auto const &candidate : candidates) {
+    std::error_code error;
+    if (std::filesystem::is_regular_file(candidate, error)) {
+      return toCanonical(candidate);
+    }
+  }
+  throw abcg::RuntimeError(fmt::format("Failed to find include file {}", name));
+}
+
+// Appends source to output with its #include directives resolved. included
+// holds the files included so far, starting with the main file; the source
+// string number of each file is its position in included.
+void expand(std::string_view source, std::filesystem::path const &file,
+            std::size_t sourceIndex,
+            std::vector<std::filesystem::path> &included,
+            std::string &output) {
+  std::vector<std::filesystem::path> includes;
+  std::size_t lineNumber{};
+
+  for (std::size_t begin{}; begin < source.size();) {
+    auto const end{source.find('\n', begin)};
+    auto const line{source.substr(
+        begin, end == std::string_view::npos ? end : end - begin)};
+    begin = end == std::string_view::npos ? source.size() : end + 1;
+    ++lineNumber;
+
+    auto const name{parseInclude(line)};
+    if (!name.has_value()) {
+      output += line;
+      output += '\n';
+      continue;
+    }
+
+    auto const includePath{findInclude(*name, file)};
+    includes.push_back(includePath);
+    if (std::ranges::find(included, includePath) != included.end()) {
+      // Already included. Keep the line count.
+      output += '\n';
+      continue;
+    }
+
+    included.push_back(includePath);
+    auto const includeIndex{included.size() - 1};
+    output += fmt::format("#line 1 {}\n", includeIndex);
+    expand(readFile(includePath), includePath, includeIndex, included, output);
+    output += fmt::format("#line {} {}\n", lineNumber + 1, sourceIndex);
+  }
+
+  if (!file.empty()) {
+    setIncludes(file, std::move(includes));
+  }
+}
+
+std::string preprocess(std::string_view source,
+                       std::filesystem::path const &file) {
+  if (source.find("#include") == std::string_view::npos) {
+    if (!file.empty()) {
+      setIncludes(file, {});
+    }
+    return std::string{source};
+  }
+
+  std::string output;
+  output.reserve(source.size());
+  std::vector<std::filesystem::path> included{file};
+  expand(source, file, 0, included, output);
+  return output;
+}
+} // namespace
+
+/**
+ * @brief Returns the source code of a shader with its `#include` directives
+ * resolved.
+ *
+ * @param pathOrSource Path to the shader file, or the source code itself.
+ *
+ * @throw abcg::RuntimeError if a file could not be read or an included file
+ * could not be found.
+ *
+ * @returns Preprocessed source code.
+ */
+std::string
+abcg::ShaderPreprocessor::readSource(std::string_view pathOrSource) {
+  if (isFile(pathOrSource)) {
+    auto const file{toCanonical(pathOrSource)};
+    return preprocess(readFile(file), file);
+  }
+  return preprocess(pathOrSource, {});
+}
+
+/**
+ * @brief Inserts `#define` directives in the source code of a shader.
+ *
+ * The directives are inserted after the `#version` directive, which must come
+ * first in a shader, and are followed by a `#line` directive so that compile
+ * errors refer to the original line numbers. If there is no `#version`
+ * directive, they are inserted at the beginning of the source code.
+ *
+ * @param source Source code of the shader.
+ * @param defines Names of the macros to define (e.g., `USE_TEXTURE`),
+ * optionally followed by a space and the replacement (e.g., `NUM_LIGHTS 4`).
+ *
+ * @returns Source code with the `#define` directives.
+ */
+std::string abcg::ShaderPreprocessor::insertDefines(
+    std::string_view source, std::vector<std::string> const &defines) {
+  if (defines.empty())
+    return std::string{source};
+
+  // Position and number of the line that follows the #version directive
+  std::size_t position{};
+  std::size_t lineNumber{1};
+  for (std::size_t begin{}, number{1}; begin < source.size(); ++number) {
+    auto const end{source.find('\n', begin)};
+    auto const next{end == std::string_view::npos ? source.size() : end + 1};
+    auto line{source.substr(begin, next - begin)};
+    line.remove_prefix(std::min(line.find_first_not_of(" \t"), line.size()));
+    if (line.starts_with("#version")) {
+      position = next;
+      lineNumber = number + 1;
+      break;
+    }
+    begin = next;
+  }
+
+  std::string output{source.substr(0, position)};
+  if (!output.empty() && !output.ends_with('\n'))
+    output += '\n';
+  for (auto const &define : defines) {
+    output += fmt::format("#define {}\n", define);
+  }
+  output += fmt::format("#line {} 0\n", lineNumber);
+  output += source.substr(position);
+  return output;
+}
+
+/**
+ * @brief Returns the files included by a shader file, directly or indirectly.
+ *
+ * Only the includes found the last time the file was read with
+ * abcg::ShaderPreprocessor::readSource are known.
+ *
+ * @param file Path to the shader file.
+ *
+ * @returns Canonical paths of the included files.
+ */
+std::vector<std::filesystem::path>
+abcg::ShaderPreprocessor::getDependencies(std::filesystem::path const &file) {
+  std::vector<std::filesystem::path> dependencies;
+  std::vector<std::filesystem::path> pending{toCanonical(file)};
+
+  std::scoped_lock const lock{cacheMutex};
+  while (!pending.empty()) {
+    auto const current{pending.back()};
+    pending.pop_back();
+
+    auto const iter{cache.find(current)};
+    if (iter == cache.end() || !iter->second.includes.has_value())
+      continue;
+    for (auto const &include : *iter->second.includes) {
+      if (std::ranges::find(dependencies, include) == dependencies.end()) {
+        dependencies.push_back(include);
+        pending.push_back(include);
+      }
+    }
+  }
+  return dependencies;
+}
+
+/**
+ * @brief Returns whether a shader file is, or includes, any of the given
+ * files.
+ *
+ * @param file Path to the shader file.
+ * @param changedFiles Paths of the files to look for.
+ */
+bool abcg::ShaderPreprocessor::dependsOn(
+    std::filesystem::path const &file,
+    std::vector<std::filesystem::path> const &changedFiles) {
+  auto files{getDependencies(file)};
+  files.push_back(toCanonical(file));
+  return std::ranges::any_of(changedFiles, [&files](auto const &changedFile) {
+    return std::ranges::find(files, toCanonical(changedFile)) != files.end();
+  });
+}
+
+/**
+ * @brief Removes a file from the cache.
+ *
+ * The file is read again the next time it is needed. Files that include it
+ * are not affected, since their contents did not change.
+ *
+ * @param file Path to the file.
+ */
+void abcg::ShaderPreprocessor::invalidate(std::filesystem::path const &file) {
+  auto const canonical{toCanonical(file)};
+  std::scoped_lock const lock{cacheMutex};
+  cache.erase(canonical);
+}
+
+/**
+ * @brief Removes all files from the cache.
+ */
+void abcg::ShaderPreprocessor::clear() {
+  std::scoped_lock const lock{cacheMutex};
+  cache.clear();
+}
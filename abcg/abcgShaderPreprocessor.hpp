@@ -0,0 +1,58 @@
+/**
+ * @file abcgShaderPreprocessor.hpp
+ * @brief Header file of abcg::ShaderPreprocessor.
+ *
+ * Declaration of abcg::ShaderPreprocessor.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_SHADER_PREPROCESSOR_HPP_
+#define ABCG_SHADER_PREPROCESSOR_HPP_
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace abcg {
+class ShaderPreprocessor;
+} // namespace abcg
+
+/**
+ * @brief Reads shader files and resolves `#include` directives.
+ *
+ * A line of the form `#include "file.glsl"` (or `#include <file.glsl>`) is
+ * replaced with the contents of the file, which is searched first in the
+ * directory of the including file and then in the assets directory
+ * (abcg::Application::getAssetsPath). Each file is included at most once per
+ * shader, as if it began with `#pragma once`. `#line` directives are inserted
+ * around the included contents so that compile errors refer to the original
+ * line numbers. The source string number of each file is its order of
+ * inclusion, starting from 1 for the first included file.
+ *
+ * The contents of the files and the include graph are cached in memory, so
+ * shared files are read only once per process. Modified files are removed
+ * from the cache with abcg::ShaderPreprocessor::invalidate.
+ *
+ * All functions are thread-safe.
+ */
+class abcg::ShaderPreprocessor {
+public:
+  [[nodiscard]] static std::string readSource(std::string_view pathOrSource);
+  [[nodiscard]] static std::string
+  insertDefines(std::string_view source,
+                std::vector<std::string> const &defines);
+  [[nodiscard]] static std::vector<std::filesystem::path>
+  getDependencies(std::filesystem::path const &file);
+  [[nodiscard]] static bool
+  dependsOn(std::filesystem::path const &file,
+            std::vector<std::filesystem::path> const &changedFiles);
+  static void invalidate(std::filesystem::path const &file);
+  static void clear();
+};
+
+#endif
@@ -19,7 +19,7 @@ using namespace std::chrono;
  * last call to abcg::Timer::restart.
  */
 double abcg::Timer::elapsed() const {
-  return duration_cast<duration<double>>(steady_clock::now() - start).count();
+  return duration_cast<duration<double>>(now() - start).count();
 }
 
 /**
@@ -29,9 +29,55 @@ double abcg::Timer::elapsed() const {
  * last call to abcg::Timer::restart.
  */
 double abcg::Timer::restart() {
-  auto const now{steady_clock::now()};
-  auto const elapsed{duration_cast<duration<double>>(now - start).count()};
-  start = now;
+  auto const current{now()};
+  auto const elapsed{duration_cast<duration<double>>(current - start).count()};
+  start = current;
 
   return elapsed;
+}
+
+/**
+ * @brief Returns the current time used by all timers.
+ *
+ * @return Current time of `std::chrono::steady_clock`, or the current time of
+ * the virtual clock if abcg::Timer::enableVirtualClock was called.
+ */
+abcg::Timer::clock::time_point abcg::Timer::now() {
+  return m_virtualClockEnabled ? m_virtualTime : clock::now();
+}
+
+/**
+ * @brief Switches all timers to a virtual clock.
+ *
+ * The virtual clock starts at the current time of `std::chrono::steady_clock`
+ * and stands still until abcg::Timer::advanceVirtualClock is called. Timers
+ * created before this call keep their start time.
+ *
+ * This must be called from the main thread.
+ */
+void abcg::Timer::enableVirtualClock() {
+  if (m_virtualClockEnabled)
+    return;
+  m_virtualTime = clock::now();
+  m_virtualClockEnabled = true;
+}
+
+/**
+ * @brief Advances the virtual clock.
+ *
+ * This has no effect if the virtual clock is not enabled.
+ *
+ * @param delta Time increment.
+ */
+void abcg::Timer::advanceVirtualClock(clock::duration delta) {
+  m_virtualTime += delta;
+}
+
+/**
+ * @brief Returns whether the timers are using the virtual clock.
+ *
+ * @return `true` if abcg::Timer::enableVirtualClock was called.
+ */
+bool abcg::Timer::isVirtualClockEnabled() noexcept {
+  return m_virtualClockEnabled;
 }
\ No newline at end of file
@@ -20,16 +20,31 @@ class Timer;
 /**
  * @brief Represents a timer based on the monotonic clock
  * `std::chrono::steady_clock`.
+ *
+ * All timers can be switched to a virtual clock that only advances when
+ * abcg::Timer::advanceVirtualClock is called. abcg::Application uses it to make
+ * the timing of recorded and replayed sessions deterministic.
  */
 class abcg::Timer {
 public:
+  /** @brief Type of the underlying clock. */
+  using clock = std::chrono::steady_clock;
+
   [[nodiscard]] double elapsed() const;
   double restart();
 
+  [[nodiscard]] static clock::time_point now();
+  static void enableVirtualClock();
+  static void advanceVirtualClock(clock::duration delta);
+  [[nodiscard]] static bool isVirtualClockEnabled() noexcept;
+
 private:
-  using clock = std::chrono::steady_clock;
+  clock::time_point start{now()};
 
-  clock::time_point start{clock::now()};
+  // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+  static inline bool m_virtualClockEnabled{};
+  static inline clock::time_point m_virtualTime{};
+  // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 };
 
 #endif
\ No newline at end of file
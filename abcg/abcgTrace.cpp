@@ -0,0 +1,168 @@
+/**
+ * @file abcgTrace.cpp
+ * @brief Definition of abcg::Trace and abcg::TraceScope members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgTrace.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgProfiler.hpp"
+#include "abcgUtil.hpp"
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::mutex traceMutex;
+std::ofstream traceFile;
+std::atomic<bool> traceActive{false};
+std::int64_t traceStart{};
+bool firstEvent{true};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Converts a time of abcg::Profiler::now to microseconds since the start of
+// the trace
+double toMicroseconds(std::int64_t time) {
+  return gsl::narrow_cast<double>(time - traceStart) * 1e-3;
+}
+
+// Must be called with traceMutex locked
+void writeEvent(std::string const &event) {
+  traceFile << (firstEvent ? "" : ",\n") << event;
+  firstEvent = false;
+}
+} // namespace
+
+/**
+ * @brief Starts writing a trace to a file.
+ *
+ * If a trace is already being written, it is stopped first.
+ *
+ * @param path Path to the output JSON file.
+ *
+ * @throw abcg::RuntimeError if the file cannot be created.
+ */
+void abcg::Trace::start(std::string const &path) {
+  stop();
+
+  std::scoped_lock const lock{traceMutex};
+  traceFile.open(path, std::ios::trunc);
+  if (!traceFile) {
+    throw abcg::RuntimeError(
+        fmt::format("Failed to create trace file {}", path));
+  }
+
+  traceStart = Profiler::now();
+  firstEvent = true;
+  traceFile << "[\n";
+  writeEvent(R"({"name":"process_name","ph":"M","pid":0,"tid":0,)"
+             R"("args":{"name":"abcg"}})");
+  traceActive.store(true, std::memory_order_release);
+  fmt::print("Trace started: {}\n", path);
+}
+
+/**
+ * @brief Finishes writing the current trace, if any.
+ */
+void abcg::Trace::stop() {
+  std::scoped_lock const lock{traceMutex};
+  if (!traceActive.load(std::memory_order_acquire))
+    return;
+
+  traceActive.store(false, std::memory_order_release);
+  traceFile << "\n]\n";
+  traceFile.close();
+  fmt::print("Trace stopped\n");
+}
+
+/**
+ * @brief Returns whether a trace is being written.
+ */
+bool abcg::Trace::isActive() noexcept {
+  return traceActive.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Writes a complete event, i.e., an event with a begin time and a
+ * duration.
+ *
+ * @param name Name of the event.
+ * @param category Comma-separated list of categories of the event.
+ * @param begin Begin time, in nanoseconds, of abcg::Profiler::now.
+ * @param end End time, in nanoseconds, of abcg::Profiler::now.
+ * @param thread Index of the thread that generated the event.
+ */
+void abcg::Trace::writeCompleteEvent(std::string_view name,
+                                     std::string_view category,
+                                     std::int64_t begin, std::int64_t end,
+                                     std::uint32_t thread) {
+  std::scoped_lock const lock{traceMutex};
+  if (!traceActive.load(std::memory_order_acquire))
+    return;
+
+  writeEvent(fmt::format(
+      R"({{"name":"{}","cat":"{}","ph":"X","pid":0,"tid":{},"ts":{:.3f},)"
+      R"("dur":{:.3f}}})",
+      escapeJSON(name), escapeJSON(category), thread, toMicroseconds(begin),
+      gsl::narrow_cast<double>(end - begin) * 1e-3));
+}
+
+/**
+ * @brief Writes a counter event.
+ *
+ * Each value is shown as a separate series of the counter.
+ *
+ * @param name Name of the counter.
+ * @param time Time, in nanoseconds, of abcg::Profiler::now.
+ * @param values Pairs of series name and value.
+ */
+void abcg::Trace::writeCounterEvent(
+    std::string_view name, std::int64_t time,
+    std::vector<std::pair<std::string_view, double>> const &values) {
+  if (values.empty())
+    return;
+
+  std::scoped_lock const lock{traceMutex};
+  if (!traceActive.load(std::memory_order_acquire))
+    return;
+
+  std::string args;
+  for (auto const &[series, value] : values) {
+    args += fmt::format(R"({}"{}":{:.6f})", args.empty() ? "" : ",",
+                        escapeJSON(series), value);
+  }
+  writeEvent(fmt::format(
+      R"({{"name":"{}","ph":"C","pid":0,"tid":0,"ts":{:.3f},"args":{{{}}}}})",
+      escapeJSON(name), toMicroseconds(time), args));
+}
+
+/**
+ * @brief Begins a traced scope.
+ *
+ * @param name Name of the scope. Must be a string literal.
+ * @param category Category of the scope. Must be a string literal.
+ */
+abcg::TraceScope::TraceScope(char const *name, char const *category)
+    : m_name{name}, m_category{category} {
+  if (Trace::isActive()) {
+    m_begin = Profiler::now();
+  }
+}
+
+/**
+ * @brief Ends the traced scope and writes its event.
+ */
+abcg::TraceScope::~TraceScope() {
+  if (m_begin != 0 && Trace::isActive()) {
+    Trace::writeCompleteEvent(m_name, m_category, m_begin, Profiler::now(),
+                              Profiler::getThreadIndex());
+  }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file abcgTrace.hpp
+ * @brief Header file of abcg::Trace and abcg::TraceScope.
+ *
+ * Declaration of abcg::Trace and abcg::TraceScope.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_TRACE_HPP_
+#define ABCG_TRACE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace abcg {
+class Trace;
+class TraceScope;
+} // namespace abcg
+
+/**
+ * @brief Writer of timeline traces in the Chrome trace-event JSON format.
+ *
+ * The trace can be opened in `chrome://tracing` or in the Perfetto UI
+ * (https://ui.perfetto.dev). Events are written to the file as they are
+ * received, so the memory usage does not grow with the length of the capture.
+ *
+ * abcg::Window writes one event per frame, the events of the CPU profiler (if
+ * ABCg is built with `ENABLE_PROFILER`), and the GPU times of each frame as
+ * counters. Shader builds are also written as events.
+ *
+ * Tracing starts when the application starts if the environment variable
+ * `ABCG_TRACE` is set to the path of the output file. It can also be toggled
+ * at any time with the F10 key, in which case the output file is
+ * `abcg_trace.json` in the working directory.
+ */
+class abcg::Trace {
+public:
+  static void start(std::string const &path);
+  static void stop();
+  [[nodiscard]] static bool isActive() noexcept;
+
+  static void writeCompleteEvent(std::string_view name,
+                                 std::string_view category, std::int64_t begin,
+                                 std::int64_t end, std::uint32_t thread);
+  static void writeCounterEvent(
+      std::string_view name, std::int64_t time,
+      std::vector<std::pair<std::string_view, double>> const &values);
+};
+
+/**
+ * @brief RAII object that writes a trace event for the enclosing scope.
+ *
+ * Nothing is written if tracing is not active when the object is created.
+ */
+class abcg::TraceScope {
+public:
+  TraceScope(char const *name, char const *category);
+  TraceScope(TraceScope const &) = delete;
+  TraceScope(TraceScope &&) = delete;
+  TraceScope &operator=(TraceScope const &) = delete;
+  TraceScope &operator=(TraceScope &&) = delete;
+  ~TraceScope();
+
+private:
+  char const *m_name{};
+  char const *m_category{};
+  std::int64_t m_begin{};
+};
+
+#endif
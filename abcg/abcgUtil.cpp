@@ -0,0 +1,44 @@
+/**
+ * @file abcgUtil.cpp
+ * @brief Definition of general utility functions.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgUtil.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Returns a path for a temporary file to be renamed to the given path.
+ *
+ * The name of the temporary file contains the process ID and a counter, so
+ * that concurrent writers of the same file, in this or in other processes,
+ * never write to the same temporary file.
+ *
+ * @param path Path of the file to be written.
+ *
+ * @return Path of the temporary file, in the same directory of @a path.
+ */
+std::filesystem::path
+abcg::getTemporaryFilePath(std::filesystem::path const &path) {
+  static std::atomic<std::uint64_t> counter{};
+#if defined(WIN32)
+  auto const processID{_getpid()};
+#else
+  auto const processID{getpid()};
+#endif
+  auto temporaryPath{path};
+  temporaryPath += fmt::format(".{}.{}.tmp", processID, counter++);
+  return temporaryPath;
+}
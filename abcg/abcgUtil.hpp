@@ -11,7 +11,12 @@
 #ifndef ABCG_UTIL_HPP_
 #define ABCG_UTIL_HPP_
 
+#include <filesystem>
 #include <functional>
+#include <string>
+#include <string_view>
+
+#include "abcgExternal.hpp"
 
 namespace abcg {
 
@@ -68,6 +73,51 @@ std::size_t hashCombine(const TFirst &value, const TRest &...rest) {
   return seed;
 }
 
+/**
+ * @brief Escapes a string to be written inside the quotes of a JSON string.
+ *
+ * Quotes, backslashes and control characters are escaped. Other characters,
+ * including UTF-8 sequences, are copied as they are.
+ *
+ * @param text String to be escaped.
+ *
+ * @return Escaped string, without the enclosing quotes.
+ */
+[[nodiscard]] inline std::string escapeJSON(std::string_view text) {
+  std::string result;
+  result.reserve(text.size());
+  for (auto const character : text) {
+    switch (character) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\r':
+      result += "\\r";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    default:
+      if (auto const code{static_cast<unsigned char>(character)}; code < 0x20) {
+        result += fmt::format("\\u{:04x}", code);
+      } else {
+        result += character;
+      }
+      break;
+    }
+  }
+  return result;
+}
+
+[[nodiscard]] std::filesystem::path
+getTemporaryFilePath(std::filesystem::path const &path);
+
 } // namespace abcg
 
 #endif
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "abcgVulkanDevice.hpp"
 
 #include <gsl/pointers>
+#include <type_traits>
 
 namespace abcg {
 struct VulkanBufferCreateInfo;
@@ -46,6 +47,26 @@ public:
   void loadData(gsl::not_null<void const *> data, vk::DeviceSize size,
                 vk::DeviceSize offset = 0UL);
 
+  /**
+   * @brief Copies a uniform or storage block to the buffer memory.
+   *
+   * The layout of the struct should be checked against the std140 or std430
+   * rules with abcg::isStd140 or abcg::isStd430. The whole block is copied
+   * with a single `memcpy`.
+   *
+   * @tparam T Trivially copyable struct that mirrors the block.
+   *
+   * @param block Contents of the block.
+   * @param offset Offset from the beginning of the buffer memory.
+   */
+  template <typename T>
+  void loadBlock(T const &block, vk::DeviceSize offset = 0UL) {
+    static_assert(std::is_trivially_copyable_v<T> &&
+                      std::is_standard_layout_v<T>,
+                  "Blocks must be trivially copyable standard-layout types");
+    loadData(&block, sizeof(T), offset);
+  }
+
   /**
    * @brief Conversion to vk::Buffer.
    */
@@ -0,0 +1,219 @@
+/**
+ * @file abcgVulkanPipelineReloader.cpp
+ * @brief Definition of abcg::VulkanPipelineReloader members.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgVulkanPipelineReloader.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgShaderPreprocessor.hpp"
+
+/**
+ * @brief Registers a pipeline to be recreated when its shader files change.
+ *
+ * If the pipeline is already registered, its creation info is replaced.
+ *
+ * @param pipeline Reference to the pipeline.
+ * @param createInfo Creation info given to abcg::VulkanPipeline::create. The
+ * shaders of the creation info are ignored.
+ * @param pathsOrSources Paths or source codes of the shaders of the pipeline,
+ * as given to abcg::VulkanShader::create. Only the paths are watched.
+ * @param onReload Function called after the pipeline is replaced.
+ */
+void abcg::VulkanPipelineReloader::add(
+    VulkanPipeline &pipeline, VulkanPipelineCreateInfo const &createInfo,
+    std::vector<ShaderSource> const &pathsOrSources, Callback const &onReload) {
+  remove(pipeline);
+
+  Entry entry{.pipeline = &pipeline,
+              .createInfo = createInfo,
+              .pathsOrSources = pathsOrSources,
+              .files = {},
+              .onReload = onReload,
+              .shaders = {},
+              .stale = false};
+  entry.createInfo.shaders.clear();
+  for (auto const &pathOrSource : pathsOrSources) {
+    std::error_code error;
+    if (std::filesystem::is_regular_file(pathOrSource.source, error)) {
+      entry.files.emplace_back(pathOrSource.source);
+    }
+  }
+  m_entries.push_back(std::move(entry));
+}
+
+/**
+ * @brief Stops watching a pipeline.
+ *
+ * The pipeline is not destroyed.
+ *
+ * @param pipeline Reference to the pipeline given to
+ * abcg::VulkanPipelineReloader::add.
+ */
+void abcg::VulkanPipelineReloader::remove(VulkanPipeline const &pipeline) {
+  for (auto &entry : m_entries) {
+    if (entry.pipeline == &pipeline) {
+      discard(entry);
+    }
+  }
+  std::erase_if(m_entries, [&pipeline](auto const &entry) {
+    return entry.pipeline == &pipeline;
+  });
+}
+
+/**
+ * @brief Starts compiling the shaders of the pipelines that use any of the
+ * given files, including files included with `#include`.
+ *
+ * The shaders are compiled on a background thread. The pipelines are replaced
+ * by abcg::VulkanPipelineReloader::poll when the compilation is finished.
+ *
+ * @param swapchain Swapchain used to create the pipelines.
+ * @param changedFiles Paths of the modified files.
+ */
+void abcg::VulkanPipelineReloader::reload(
+    VulkanSwapchain const &swapchain,
+    std::vector<std::filesystem::path> const &changedFiles) {
+  // The affected entries are found before invalidating the cache, which holds
+  // the include graph
+  std::vector<Entry *> affectedEntries;
+  for (auto &entry : m_entries) {
+    if (std::ranges::any_of(entry.files, [&changedFiles](auto const &file) {
+          return ShaderPreprocessor::dependsOn(file, changedFiles);
+        })) {
+      affectedEntries.push_back(&entry);
+    }
+  }
+
+  for (auto const &file : changedFiles) {
+    ShaderPreprocessor::invalidate(file);
+  }
+
+  for (auto *entry : affectedEntries) {
+    if (entry->shaders.valid()) {
+      // Compiled again when the current compilation is finished
+      entry->stale = true;
+    } else {
+      compile(swapchain, *entry);
+    }
+  }
+}
+
+/**
+ * @brief Replaces the pipelines whose shaders have finished compiling.
+ *
+ * This never waits for the compilation. The new pipelines are created on the
+ * calling thread. If a shader failed to compile or the pipeline could not be
+ * created, the errors are printed and the old pipeline is kept.
+ *
+ * @param swapchain Swapchain used to create the pipelines.
+ */
+void abcg::VulkanPipelineReloader::poll(VulkanSwapchain const &swapchain) {
+  std::vector<VulkanPipeline *> readyPipelines;
+  for (auto const &entry : m_entries) {
+    if (entry.shaders.valid() &&
+        entry.shaders.wait_for(std::chrono::seconds{0}) ==
+            std::future_status::ready) {
+      readyPipelines.push_back(entry.pipeline);
+    }
+  }
+
+  for (auto *readyPipeline : readyPipelines) {
+    // Looked up again because the callbacks may register pipelines
+    auto const entryIter{
+        std::ranges::find(m_entries, readyPipeline, &Entry::pipeline)};
+    if (entryIter == m_entries.end() || !entryIter->shaders.valid())
+      continue;
+    auto &entry{*entryIter};
+
+    auto createInfo{entry.createInfo};
+    try {
+      createInfo.shaders = entry.shaders.get();
+    } catch (abcg::Exception const &exception) {
+      fmt::print("Failed to reload pipeline: {}\n", exception.what());
+      if (entry.stale) {
+        compile(swapchain, entry);
+      }
+      continue;
+    }
+
+    if (entry.stale) {
+      // The shaders are out of date
+      for (auto &shader : createInfo.shaders) {
+        shader.destroy();
+      }
+      compile(swapchain, entry);
+      continue;
+    }
+
+    VulkanPipeline pipeline;
+    try {
+      pipeline.create(swapchain, createInfo);
+    } catch (abcg::Exception const &exception) {
+      fmt::print("Failed to reload pipeline: {}\n", exception.what());
+      for (auto &shader : createInfo.shaders) {
+        shader.destroy();
+      }
+      continue;
+    }
+
+    for (auto &shader : createInfo.shaders) {
+      shader.destroy();
+    }
+
+    // Waits until the old pipeline is no longer in use
+    entry.pipeline->destroy();
+    *entry.pipeline = pipeline;
+    fmt::print("Pipeline reloaded\n");
+
+    if (auto const onReload{entry.onReload}; onReload) {
+      onReload();
+    }
+  }
+}
+
+/**
+ * @brief Unregisters all pipelines.
+ *
+ * Waits for the shaders being compiled, if any, and destroys them.
+ */
+void abcg::VulkanPipelineReloader::destroy() {
+  for (auto &entry : m_entries) {
+    discard(entry);
+  }
+  m_entries.clear();
+}
+
+// Starts compiling the shaders of an entry on a background thread
+void abcg::VulkanPipelineReloader::compile(VulkanSwapchain const &swapchain,
+                                           Entry &entry) {
+  entry.stale = false;
+  entry.shaders = std::async(
+      std::launch::async,
+      [&device = swapchain.getDevice(), pathsOrSources = entry.pathsOrSources] {
+        return createVulkanShaders(device, pathsOrSources);
+      });
+}
+
+// Waits for the shaders being compiled, if any, and destroys them
+void abcg::VulkanPipelineReloader::discard(Entry &entry) {
+  if (!entry.shaders.valid())
+    return;
+
+  try {
+    for (auto &shader : entry.shaders.get()) {
+      shader.destroy();
+    }
+  } catch (abcg::Exception const &) {
+    // Nothing was created
+  }
+}
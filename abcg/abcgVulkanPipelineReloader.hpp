@@ -0,0 +1,82 @@
+/**
+ * @file abcgVulkanPipelineReloader.hpp
+ * @brief Header file of abcg::VulkanPipelineReloader.
+ *
+ * Declaration of abcg::VulkanPipelineReloader.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_VULKAN_PIPELINE_RELOADER_HPP_
+#define ABCG_VULKAN_PIPELINE_RELOADER_HPP_
+
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <vector>
+
+#include "abcgVulkanPipeline.hpp"
+#include "abcgVulkanShader.hpp"
+
+namespace abcg {
+class VulkanPipelineReloader;
+} // namespace abcg
+
+/**
+ * @brief Recreates Vulkan pipelines when their shader files are modified.
+ *
+ * Each registered pipeline keeps a copy of its creation info and the paths of
+ * its shaders. When a shader file is modified, the shaders are compiled again
+ * with abcg::createVulkanShaders on a background thread, so that the frame
+ * loop is not stalled. abcg::VulkanPipelineReloader::poll then creates the new
+ * pipeline on the calling thread once all shaders are compiled. Only if both
+ * steps succeed, the old pipeline is destroyed and replaced. Otherwise, the
+ * errors are printed and the old pipeline is kept.
+ *
+ * abcg::VulkanWindow feeds the reloader with the files reported by its file
+ * watcher when abcg::WindowSettings::hotReload is enabled, and polls it once
+ * per frame.
+ *
+ * @remark The pipelines, and the memory pointed to by the creation info (e.g.,
+ * descriptor set layouts), must outlive the reloader or be removed with
+ * abcg::VulkanPipelineReloader::remove.
+ */
+class abcg::VulkanPipelineReloader {
+public:
+  /**
+   * @brief Function called after a pipeline is replaced.
+   */
+  using Callback = std::function<void()>;
+
+  void add(VulkanPipeline &pipeline, VulkanPipelineCreateInfo const &createInfo,
+           std::vector<ShaderSource> const &pathsOrSources,
+           Callback const &onReload = {});
+  void remove(VulkanPipeline const &pipeline);
+  void reload(VulkanSwapchain const &swapchain,
+              std::vector<std::filesystem::path> const &changedFiles);
+  void poll(VulkanSwapchain const &swapchain);
+  void destroy();
+
+private:
+  struct Entry {
+    VulkanPipeline *pipeline{};
+    VulkanPipelineCreateInfo createInfo;
+    std::vector<ShaderSource> pathsOrSources;
+    std::vector<std::filesystem::path> files;
+    Callback onReload;
+    // Shaders being compiled, if any
+    std::future<std::vector<VulkanShader>> shaders;
+    // Whether the files changed again while the shaders were being compiled
+    bool stale{};
+  };
+
+  static void compile(VulkanSwapchain const &swapchain, Entry &entry);
+  static void discard(Entry &entry);
+
+  std::vector<Entry> m_entries;
+};
+
+#endif
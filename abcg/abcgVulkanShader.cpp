@@ -11,14 +11,36 @@
 #include "abcgVulkanShader.hpp"
 #include "abcgApplication.hpp"
 #include "abcgException.hpp"
+#include "abcgShaderPreprocessor.hpp"
+#include "abcgTrace.hpp"
+#include "abcgVulkanShaderCache.hpp"
 #include "abcgVulkanWindow.hpp"
 
 #include <glslang/SPIRV/GlslangToSpv.h>
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace {
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::once_flag glslangInitFlag;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Initializes glslang on first use. The process is finalized at exit.
+void initializeGlslang() {
+  std::call_once(glslangInitFlag, [] {
+    glslang::InitializeProcess();
+    std::atexit([] { glslang::FinalizeProcess(); });
+  });
+}
+} // namespace
 
 static TBuiltInResource InitResources() {
   TBuiltInResource Resources{
@@ -233,34 +255,29 @@ abcgStageToVulkanStage(abcg::ShaderStage stage) {
   }
 };
 
-// If filenameOrText is a filename, returns the contents of the file (assumed
-// to be in text format). Otherwise, returns filenameOrText.
-[[nodiscard]] static std::string toSource(std::string_view filenameOrText) {
-  static const std::size_t maxPathSize{260};
-  if (filenameOrText.size() > maxPathSize ||
-      !std::filesystem::exists(filenameOrText)) {
-    return filenameOrText.data();
-  }
-  std::stringstream source;
-  if (std::ifstream stream(filenameOrText.data()); stream) {
-    source << stream.rdbuf();
-    stream.close();
-  } else {
-    throw abcg::RuntimeError(
-        fmt::format("Failed to read file {}", filenameOrText));
-  }
-  return source.str();
-}
+// Result of the compilation of a GLSL shader into Vulkan SPIR-V
+struct SPVResult {
+  std::vector<uint32_t> code;
+  // Information logs of glslang
+  std::string log;
+  // Empty if the shader was compiled successfully
+  std::string error;
+};
 
-// Compiles the given GLSL shader source into Vulkan SPIR-V.
-std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
-  // Prints out log info for compiling and linking
-  auto printLog{[](glslang::TShader &shader, std::string_view name) {
+// Compiles the given GLSL shader source into Vulkan SPIR-V. This can be called
+// concurrently from different threads after glslang is initialized.
+SPVResult GLSLtoSPV(abcg::ShaderSource const &shaderSource) {
+  SPVResult result;
+
+  // Collects log info for compiling and linking
+  auto appendLog{[&result](glslang::TShader &shader, std::string_view name) {
     if (std::string const log{shader.getInfoLog()}; !log.empty()) {
-      fmt::print("Shader information log ({} shader):\n{}\n", name, log);
+      result.log += fmt::format("Shader information log ({} shader):\n{}\n",
+                                name, log);
     }
     if (std::string const log{shader.getInfoDebugLog()}; !log.empty()) {
-      fmt::print("Shader information debug log ({} shader):\n{}\n", name, log);
+      result.log += fmt::format(
+          "Shader information debug log ({} shader):\n{}\n", name, log);
     }
   }};
 
@@ -277,9 +294,9 @@ std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
   TBuiltInResource resources{InitResources()};
   if (!shader.parse(&resources, 100, false, messages)) {
     auto const *shaderStage{glslangStageToText(stage)};
-    printLog(shader, shaderStage);
-    throw abcg::RuntimeError(
-        fmt::format("Failed to compile {} shader", shaderStage));
+    appendLog(shader, shaderStage);
+    result.error = fmt::format("Failed to compile {} shader", shaderStage);
+    return result;
   }
 
   // Links
@@ -287,20 +304,23 @@ std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
   program.addShader(&shader);
   if (!program.link(messages)) {
     auto const *shaderStage{glslangStageToText(stage)};
-    printLog(shader, shaderStage);
-    throw abcg::RuntimeError(
-        fmt::format("Failed to link {} shader", shaderStage));
+    appendLog(shader, shaderStage);
+    result.error = fmt::format("Failed to link {} shader", shaderStage);
+    return result;
   }
 
-  std::vector<uint32_t> outCode;
-  glslang::GlslangToSpv(*program.getIntermediate(stage), outCode);
+  glslang::GlslangToSpv(*program.getIntermediate(stage), result.code);
 
-  return outCode;
+  return result;
 }
 
 /**
  * @brief Compiles a GLSL shader to SPIR-V and creates its module.
  *
+ * The SPIR-V code is cached in memory and on disk (see
+ * abcg::setVulkanShaderCacheDirectory), so the same source is compiled only
+ * once. glslang is initialized the first time a shader is compiled.
+ *
  * @param device Vulkan device to be used to create the shader module.
  * @param pathOrSource Path or source code of the GLSL shader to be compiled to
  * SPIR-V.
@@ -310,20 +330,58 @@ std::vector<uint32_t> GLSLtoSPV(abcg::ShaderSource shaderSource) {
  */
 void abcg::VulkanShader::create(VulkanDevice const &device,
                                 ShaderSource const &pathOrSource) {
+  TraceScope const traceScope{"VulkanShader::create", "shader"};
+
   m_device = static_cast<vk::Device>(device);
 
-  ShaderSource source{.source = toSource(pathOrSource.source),
-                      .stage = pathOrSource.stage};
+  ShaderSource source{
+      .source = ShaderPreprocessor::readSource(pathOrSource.source),
+      .stage = pathOrSource.stage};
 
-  glslang::InitializeProcess();
-  std::vector<uint32_t> shader{GLSLtoSPV(source)};
+  auto const hash{hashVulkanShader(source)};
+  auto shader{loadVulkanShaderBinary(hash)};
+  if (shader.empty()) {
+    initializeGlslang();
+    auto result{GLSLtoSPV(source)};
+    if (!result.error.empty()) {
+      fmt::print("{}", result.log);
+      throw abcg::RuntimeError(result.error);
+    }
+    shader = std::move(result.code);
+    saveVulkanShaderBinary(shader, hash);
+  }
   m_stage = abcgStageToVulkanStage(source.stage);
-  glslang::FinalizeProcess();
 
   m_module = m_device.createShaderModule(
       {.codeSize = shader.size() * sizeof(uint32_t), .pCode = shader.data()});
 }
 
+/**
+ * @brief Creates a shader module from precompiled SPIR-V code.
+ *
+ * glslang is not used, so this is much faster than compiling the GLSL source
+ * at runtime.
+ *
+ * @param device Vulkan device to be used to create the shader module.
+ * @param binary SPIR-V code and stage of the shader, usually generated by the
+ * `abcg_add_shaders` CMake function.
+ *
+ * @throw abcg::RuntimeError if the code is empty.
+ */
+void abcg::VulkanShader::create(VulkanDevice const &device,
+                                ShaderBinary const &binary) {
+  TraceScope const traceScope{"VulkanShader::create", "shader"};
+
+  if (binary.code.empty()) {
+    throw abcg::RuntimeError("Empty SPIR-V shader code");
+  }
+
+  m_device = static_cast<vk::Device>(device);
+  m_stage = abcgStageToVulkanStage(binary.stage);
+  m_module = m_device.createShaderModule(
+      {.codeSize = binary.code.size_bytes(), .pCode = binary.code.data()});
+}
+
 /**
  * @brief Destroys the shader module.
  */
@@ -333,4 +391,114 @@ void abcg::VulkanShader::destroy() {
   }
 
   m_device.destroyShaderModule(m_module);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Compiles GLSL shaders to SPIR-V on worker threads and creates their
+ * modules.
+ *
+ * This is equivalent to calling abcg::VulkanShader::create for each shader,
+ * but the shaders that are not in the SPIR-V cache are compiled concurrently.
+ * The shader files are read and the modules are created on the calling thread.
+ *
+ * @param device Vulkan device to be used to create the shader modules.
+ * @param pathsOrSources Paths or source codes of the GLSL shaders.
+ * @param maxThreads Maximum number of threads used for compiling, including
+ * the calling thread. If zero, the number of hardware threads is used.
+ *
+ * @throw abcg::RuntimeError if a shader could not be read from file or any
+ * shader has failed to compile. In the latter case, the information logs of
+ * all shaders that failed are printed, and the message of the exception lists
+ * them.
+ *
+ * @returns Shaders in the same order as `pathsOrSources`.
+ */
+std::vector<abcg::VulkanShader>
+abcg::createVulkanShaders(VulkanDevice const &device,
+                          std::vector<ShaderSource> const &pathsOrSources,
+                          std::size_t maxThreads) {
+  TraceScope const traceScope{"createVulkanShaders", "shader"};
+
+  // Read all sources and look them up in the cache up front, so that a missing
+  // file is reported before any shader is compiled
+  std::vector<ShaderSource> sources;
+  std::vector<std::size_t> hashes;
+  std::vector<std::vector<uint32_t>> codes;
+  // Indices of the shaders that are not in the cache
+  std::vector<std::size_t> pending;
+  for (auto const &pathOrSource : pathsOrSources) {
+    auto const &source{sources.emplace_back(ShaderSource{
+        .source = ShaderPreprocessor::readSource(pathOrSource.source),
+        .stage = pathOrSource.stage})};
+    hashes.push_back(hashVulkanShader(source));
+    codes.push_back(loadVulkanShaderBinary(hashes.back()));
+    if (codes.back().empty()) {
+      pending.push_back(sources.size() - 1);
+    }
+  }
+
+  std::vector<SPVResult> results(pending.size());
+  if (!pending.empty()) {
+    initializeGlslang();
+
+    if (maxThreads == 0) {
+      maxThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    auto const numThreads{std::min(maxThreads, pending.size())};
+
+    std::atomic<std::size_t> next{};
+    auto const compile{[&] {
+      for (auto index{next++}; index < pending.size(); index = next++) {
+        try {
+          results.at(index) = GLSLtoSPV(sources.at(pending.at(index)));
+        } catch (std::exception const &exception) {
+          results.at(index).error = exception.what();
+        }
+      }
+    }};
+
+    // The threads are joined when they go out of scope, also if one of them
+    // cannot be started
+    std::vector<std::jthread> threads;
+    threads.reserve(numThreads - 1);
+    for ([[maybe_unused]] auto const thread : iter::range(numThreads - 1)) {
+      threads.emplace_back(compile);
+    }
+    compile();
+  }
+
+  std::string errors;
+  std::size_t numErrors{};
+  for (auto const index : iter::range(pending.size())) {
+    auto &result{results.at(index)};
+    auto const shaderIndex{pending.at(index)};
+    if (!result.error.empty()) {
+      fmt::print("{}", result.log);
+      errors += fmt::format("\n  shader {}: {}", shaderIndex, result.error);
+      ++numErrors;
+      continue;
+    }
+    saveVulkanShaderBinary(result.code, hashes.at(shaderIndex));
+    codes.at(shaderIndex) = std::move(result.code);
+  }
+  if (numErrors > 0) {
+    throw abcg::RuntimeError(fmt::format("Failed to build {} of {} shaders:{}",
+                                         numErrors, sources.size(), errors));
+  }
+
+  std::vector<VulkanShader> shaders(sources.size());
+  for (auto const index : iter::range(sources.size())) {
+    try {
+      shaders.at(index).create(
+          device, ShaderBinary{.code = codes.at(index),
+                               .stage = sources.at(index).stage});
+    } catch (...) {
+      // Do not leak the modules created so far
+      for (auto const created : iter::range(index)) {
+        shaders.at(created).destroy();
+      }
+      throw;
+    }
+  }
+  return shaders;
+}
@@ -11,6 +11,9 @@
 #ifndef ABCG_VULKAN_SHADER_HPP_
 #define ABCG_VULKAN_SHADER_HPP_
 
+#include <cstddef>
+#include <vector>
+
 #include "abcgShader.hpp"
 #include "abcgVulkanDevice.hpp"
 
@@ -22,11 +25,14 @@ class VulkanShader;
  * @brief A class for representing a Vulkan shader.
  *
  * This class compiles a GLSL shader into a Vulkan SPIR-V shader and creates the
- * corresponding vk::ShaderModule.
+ * corresponding vk::ShaderModule. Shaders compiled at build time with the
+ * `abcg_add_shaders` CMake function can be given as abcg::ShaderBinary, in
+ * which case the runtime compilation is skipped.
  */
 class abcg::VulkanShader {
 public:
   void create(VulkanDevice const &device, ShaderSource const &pathOrSource);
+  void create(VulkanDevice const &device, ShaderBinary const &binary);
   void destroy();
 
   /**
@@ -53,4 +59,11 @@ private:
   vk::Device m_device{};
 };
 
+namespace abcg {
+[[nodiscard]] std::vector<VulkanShader>
+createVulkanShaders(VulkanDevice const &device,
+                    std::vector<ShaderSource> const &pathsOrSources,
+                    std::size_t maxThreads = 0);
+} // namespace abcg
+
 #endif
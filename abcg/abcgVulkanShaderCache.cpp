@@ -0,0 +1,264 @@
+/**
+ * @file abcgVulkanShaderCache.cpp
+ * @brief Definition of helper functions for caching SPIR-V code.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include "abcgVulkanShaderCache.hpp"
+
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+#include <glslang/Public/ShaderLang.h>
+#include <glslang/SPIRV/GlslangToSpv.h>
+
+#include "abcgExternal.hpp"
+#include "abcgTrace.hpp"
+#include "abcgUtil.hpp"
+
+namespace {
+// Entry of the in-memory cache
+struct MemoryCacheEntry {
+  std::size_t hash{};
+  std::vector<std::uint32_t> code;
+};
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::optional<std::filesystem::path> cacheDirectory;
+std::mutex cacheMutex;
+// Least recently used entries are at the back
+std::list<MemoryCacheEntry> memoryCache;
+std::unordered_map<std::size_t, std::list<MemoryCacheEntry>::iterator>
+    memoryCacheIndex;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Header of a cache file. The SPIR-V code follows the header.
+struct CacheFileHeader {
+  std::uint32_t magic{};
+  std::uint32_t wordCount{};
+  std::uint64_t hash{};
+};
+
+constexpr std::uint32_t cacheFileMagic{0x56534741}; // "AGSV"
+constexpr std::uint32_t spirvMagic{0x07230203};
+constexpr std::size_t memoryCacheCapacity{64};
+
+std::filesystem::path getDefaultCacheDirectory() {
+  if (auto const *directory{SDL_getenv("ABCG_SPIRV_CACHE")};
+      directory != nullptr) {
+    return directory;
+  }
+  std::error_code error;
+  auto const tempDirectory{std::filesystem::temp_directory_path(error)};
+  if (error) {
+    return {};
+  }
+  return tempDirectory / "abcg" / "spirv_cache";
+}
+
+// Must be called with cacheMutex locked
+std::filesystem::path const &getCacheDirectory() {
+  if (!cacheDirectory.has_value()) {
+    cacheDirectory = getDefaultCacheDirectory();
+  }
+  return *cacheDirectory;
+}
+
+std::filesystem::path getCacheFilePath(std::size_t hash) {
+  return getCacheDirectory() / fmt::format("{:016x}.spv", hash);
+}
+
+void removeCacheFile(std::filesystem::path const &path) {
+  std::error_code error;
+  std::filesystem::remove(path, error);
+}
+
+// Must be called with cacheMutex locked
+void insertInMemoryCache(std::size_t hash,
+                         std::vector<std::uint32_t> const &code) {
+  if (auto const iter{memoryCacheIndex.find(hash)};
+      iter != memoryCacheIndex.end()) {
+    memoryCache.splice(memoryCache.begin(), memoryCache, iter->second);
+    return;
+  }
+  memoryCache.push_front({.hash = hash, .code = code});
+  memoryCacheIndex.emplace(hash, memoryCache.begin());
+  if (memoryCache.size() > memoryCacheCapacity) {
+    memoryCacheIndex.erase(memoryCache.back().hash);
+    memoryCache.pop_back();
+  }
+}
+} // namespace
+
+/**
+ * @brief Sets the directory where SPIR-V code compiled by
+ * abcg::VulkanShader::create is cached.
+ *
+ * By default, the cache directory is given by the environment variable
+ * `ABCG_SPIRV_CACHE` or, if it is not set, by `abcg/spirv_cache` in the
+ * temporary directory of the system.
+ *
+ * @param directory Path to the cache directory. An empty path disables the
+ * disk cache. The in-memory cache is always enabled.
+ */
+void abcg::setVulkanShaderCacheDirectory(
+    std::filesystem::path const &directory) {
+  std::scoped_lock const lock{cacheMutex};
+  cacheDirectory = directory;
+}
+
+/**
+ * @brief Returns the directory where SPIR-V code is cached.
+ *
+ * @returns Path to the cache directory, or an empty path if the disk cache is
+ * disabled.
+ */
+std::filesystem::path abcg::getVulkanShaderCacheDirectory() {
+  std::scoped_lock const lock{cacheMutex};
+  return getCacheDirectory();
+}
+
+/**
+ * @brief Creates a hash value that identifies the SPIR-V code of a shader.
+ *
+ * @param source Shader source code (not path) and stage.
+ *
+ * @returns Hash of the source code, stage, and version of glslang.
+ */
+std::size_t abcg::hashVulkanShader(ShaderSource const &source) {
+  auto const version{glslang::GetVersion()};
+  return hashCombine(source.source, source.stage, version.major, version.minor,
+                     version.patch, std::string_view{version.flavor},
+                     glslang::GetSpirvGeneratorVersion());
+}
+
+/**
+ * @brief Returns cached SPIR-V code.
+ *
+ * The code is searched in the in-memory cache of the most recently used
+ * shaders, then in the cache directory. Invalid cache files are removed.
+ *
+ * @param hash Hash returned by abcg::hashVulkanShader.
+ *
+ * @returns SPIR-V code, or an empty vector if the code is not in the cache.
+ */
+std::vector<std::uint32_t> abcg::loadVulkanShaderBinary(std::size_t hash) {
+  std::scoped_lock const lock{cacheMutex};
+
+  if (auto const iter{memoryCacheIndex.find(hash)};
+      iter != memoryCacheIndex.end()) {
+    memoryCache.splice(memoryCache.begin(), memoryCache, iter->second);
+    return iter->second->code;
+  }
+
+  if (getCacheDirectory().empty()) {
+    return {};
+  }
+
+  auto const path{getCacheFilePath(hash)};
+  std::ifstream stream{path, std::ios::binary};
+  if (!stream) {
+    return {};
+  }
+
+  TraceScope const traceScope{"loadVulkanShaderBinary", "shader"};
+
+  CacheFileHeader header{};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!stream || header.magic != cacheFileMagic || header.hash != hash ||
+      header.wordCount == 0) {
+    stream.close();
+    removeCacheFile(path);
+    return {};
+  }
+
+  std::vector<std::uint32_t> code(header.wordCount);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  stream.read(reinterpret_cast<char *>(code.data()),
+              gsl::narrow<std::streamsize>(code.size() * sizeof(code[0])));
+  if (!stream || code.front() != spirvMagic) {
+    stream.close();
+    removeCacheFile(path);
+    return {};
+  }
+
+  insertInMemoryCache(hash, code);
+  return code;
+}
+
+/**
+ * @brief Stores SPIR-V code in the in-memory cache and in the cache directory.
+ *
+ * Failures to write to the cache directory are ignored.
+ *
+ * @param code SPIR-V code.
+ * @param hash Hash returned by abcg::hashVulkanShader.
+ */
+void abcg::saveVulkanShaderBinary(std::vector<std::uint32_t> const &code,
+                                  std::size_t hash) {
+  if (code.empty()) {
+    return;
+  }
+
+  std::scoped_lock const lock{cacheMutex};
+  insertInMemoryCache(hash, code);
+
+  if (getCacheDirectory().empty()) {
+    return;
+  }
+
+  TraceScope const traceScope{"saveVulkanShaderBinary", "shader"};
+
+  auto const path{getCacheFilePath(hash)};
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+  if (error) {
+    return;
+  }
+
+  // Write to a temporary file first so that other processes never read a
+  // partially written file
+  auto const temporaryPath{getTemporaryFilePath(path)};
+  {
+    std::ofstream stream{temporaryPath, std::ios::binary | std::ios::trunc};
+    CacheFileHeader const header{
+        .magic = cacheFileMagic,
+        .wordCount = gsl::narrow<std::uint32_t>(code.size()),
+        .hash = hash};
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<char const *>(code.data()),
+                 gsl::narrow<std::streamsize>(code.size() * sizeof(code[0])));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (!stream) {
+      stream.close();
+      removeCacheFile(temporaryPath);
+      return;
+    }
+  }
+
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error) {
+    removeCacheFile(temporaryPath);
+  }
+}
+
+/**
+ * @brief Removes all entries of the in-memory cache.
+ *
+ * The files of the cache directory are kept.
+ */
+void abcg::clearVulkanShaderMemoryCache() {
+  std::scoped_lock const lock{cacheMutex};
+  memoryCache.clear();
+  memoryCacheIndex.clear();
+}
@@ -0,0 +1,31 @@
+/**
+ * @file abcgVulkanShaderCache.hpp
+ * @brief Declaration of helper functions for caching SPIR-V code.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#ifndef ABCG_VULKAN_SHADER_CACHE_HPP_
+#define ABCG_VULKAN_SHADER_CACHE_HPP_
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "abcgShader.hpp"
+
+namespace abcg {
+void setVulkanShaderCacheDirectory(std::filesystem::path const &directory);
+[[nodiscard]] std::filesystem::path getVulkanShaderCacheDirectory();
+[[nodiscard]] std::size_t hashVulkanShader(ShaderSource const &source);
+[[nodiscard]] std::vector<std::uint32_t>
+loadVulkanShaderBinary(std::size_t hash);
+void saveVulkanShaderBinary(std::vector<std::uint32_t> const &code,
+                            std::size_t hash);
+void clearVulkanShaderMemoryCache();
+} // namespace abcg
+
+#endif
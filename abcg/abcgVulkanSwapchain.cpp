@@ -27,6 +27,10 @@ struct SurfaceSupport {
   std::vector<vk::PresentModeKHR> presentModes;
 };
 
+// Timestamps per frame: begin of the main pass, end of the main pass (begin of
+// the UI pass), and end of the UI pass
+constexpr uint32_t numTimestamps{3};
+
 [[nodiscard]] vk::SurfaceFormatKHR
 chooseSwapSurfaceFormat(std::vector<vk::Format> const &requestFormats,
                         vk::ColorSpaceKHR requestColorSpace,
@@ -105,6 +109,8 @@ void abcg::VulkanSwapchain::create(VulkanDevice const &device,
                                    glm::ivec2 const &windowSize) {
   m_device = device;
 
+  checkTimestampSupport();
+
   m_swapChainRebuild = true;
 
   checkRebuild(settings, windowSize);
@@ -158,13 +164,35 @@ void abcg::VulkanSwapchain::render(
   device.resetFences(frame.fence);
   device.resetCommandPool(frame.commandPool);
 
+  std::vector<vk::CommandBuffer> commandBuffers;
+
+  // Timestamp at the beginning of the frame
+  if (m_timestampsSupported) {
+    readTimestamps(frame);
+
+    frame.commandBufferTimestamps.begin(
+        {.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    frame.commandBufferTimestamps.resetQueryPool(frame.timestampQueryPool, 0,
+                                                 numTimestamps);
+    frame.commandBufferTimestamps.writeTimestamp(
+        vk::PipelineStageFlagBits::eTopOfPipe, frame.timestampQueryPool, 0);
+    frame.commandBufferTimestamps.end();
+    commandBuffers.push_back(frame.commandBufferTimestamps);
+  }
+
   // Main pass
   fun(frame);
+  commandBuffers.push_back(frame.commandBuffer);
 
   // UI render pass
   frame.commandBufferUI.begin(
       {.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
 
+  if (m_timestampsSupported) {
+    frame.commandBufferUI.writeTimestamp(
+        vk::PipelineStageFlagBits::eBottomOfPipe, frame.timestampQueryPool, 1);
+  }
+
   std::array<vk::ClearValue, 2> const clearValues{};
 
   frame.commandBufferUI.beginRenderPass(
@@ -180,12 +208,17 @@ void abcg::VulkanSwapchain::render(
 
   frame.commandBufferUI.endRenderPass();
 
+  if (m_timestampsSupported) {
+    frame.commandBufferUI.writeTimestamp(
+        vk::PipelineStageFlagBits::eBottomOfPipe, frame.timestampQueryPool, 2);
+  }
+
   frame.commandBufferUI.end();
+  commandBuffers.push_back(frame.commandBufferUI);
 
   std::array waitSemaphores{presentCompleteSemaphore};
   std::array waitStages{vk::PipelineStageFlags{
       vk::PipelineStageFlagBits::eColorAttachmentOutput}};
-  std::array commandBuffers{frame.commandBuffer, frame.commandBufferUI};
   std::array signalSemaphores{renderCompleteSemaphore};
 
   // Submit command buffer
@@ -193,11 +226,15 @@ void abcg::VulkanSwapchain::render(
       {{.waitSemaphoreCount = gsl::narrow<uint32_t>(waitSemaphores.size()),
         .pWaitSemaphores = waitSemaphores.data(),
         .pWaitDstStageMask = waitStages.data(),
-        .commandBufferCount = commandBuffers.size(),
+        .commandBufferCount = gsl::narrow<uint32_t>(commandBuffers.size()),
         .pCommandBuffers = commandBuffers.data(),
         .signalSemaphoreCount = gsl::narrow<uint32_t>(signalSemaphores.size()),
         .pSignalSemaphores = signalSemaphores.data()}},
       frame.fence);
+
+  if (m_timestampsSupported) {
+    m_timestampsPending.at(m_currentFrame) = true;
+  }
 }
 
 void abcg::VulkanSwapchain::present() {
@@ -373,6 +410,7 @@ void abcg::VulkanSwapchain::createFrames() {
   m_frames.resize(swapchainImages.size());
   m_currentSemaphore = 0;
   m_frameSemaphores.resize(swapchainImages.size());
+  m_timestampsPending.assign(swapchainImages.size(), false);
 
   for (auto &&[frame, image, index] :
        iter::zip(m_frames, swapchainImages, iter::range(m_frames.size()))) {
@@ -394,6 +432,7 @@ void abcg::VulkanSwapchain::destroyFrames() {
 
   for (auto &frame : m_frames) {
     device.destroyCommandPool(frame.commandPool);
+    device.destroyQueryPool(frame.timestampQueryPool);
     device.destroyFence(frame.fence);
     frame.colorImage.destroy();
     device.destroyFramebuffer(frame.framebufferMain);
@@ -729,6 +768,20 @@ void abcg::VulkanSwapchain::createFramebuffers(VulkanSettings const &settings) {
                                      .commandBufferCount = 1})
             .front();
 
+    // Create a primary command buffer and a query pool for GPU timestamps
+    if (m_timestampsSupported) {
+      frame.commandBufferTimestamps =
+          device
+              .allocateCommandBuffers(
+                  {.commandPool = frame.commandPool,
+                   .level = vk::CommandBufferLevel::ePrimary,
+                   .commandBufferCount = 1})
+              .front();
+      frame.timestampQueryPool =
+          device.createQueryPool({.queryType = vk::QueryType::eTimestamp,
+                                  .queryCount = numTimestamps});
+    }
+
     // Create fence
     frame.fence =
         device.createFence({.flags = vk::FenceCreateFlagBits::eSignaled});
@@ -769,3 +822,48 @@ void abcg::VulkanSwapchain::createFramebuffers(VulkanSettings const &settings) {
     frameSemaphore.renderComplete = device.createSemaphore({});
   }
 }
+
+void abcg::VulkanSwapchain::checkTimestampSupport() {
+  auto const &physicalDevice{
+      static_cast<vk::PhysicalDevice>(m_device.getPhysicalDevice())};
+  auto const graphicsFamily{
+      m_device.getPhysicalDevice().getQueuesFamilies().graphics.value()};
+  auto const validBits{physicalDevice.getQueueFamilyProperties()
+                           .at(graphicsFamily)
+                           .timestampValidBits};
+
+  m_timestampsSupported = validBits > 0;
+  m_timestampPeriod = physicalDevice.getProperties().limits.timestampPeriod;
+  m_timestampMask = validBits >= 64 ? std::numeric_limits<uint64_t>::max()
+                                    : (uint64_t{1} << validBits) - 1;
+  m_GPUTimes.clear();
+}
+
+// Reads the timestamps written the last time the frame was rendered. This is
+// called after waiting for the fence of the frame, so the results are
+// available unless the frame was not submitted since the swapchain was
+// rebuilt.
+void abcg::VulkanSwapchain::readTimestamps(VulkanFrame const &frame) {
+  if (!m_timestampsPending.at(m_currentFrame))
+    return;
+  m_timestampsPending.at(m_currentFrame) = false;
+
+  auto const &device{static_cast<vk::Device>(m_device)};
+  std::array<uint64_t, numTimestamps> timestamps{};
+  if (device.getQueryPoolResults(
+          frame.timestampQueryPool, 0, numTimestamps, sizeof(timestamps),
+          timestamps.data(), sizeof(uint64_t),
+          vk::QueryResultFlagBits::e64) != vk::Result::eSuccess) {
+    return;
+  }
+
+  auto const toMilliseconds{[this](uint64_t begin, uint64_t end) {
+    auto const ticks{(end - begin) & m_timestampMask};
+    return gsl::narrow_cast<double>(ticks) * m_timestampPeriod * 1e-6;
+  }};
+  m_GPUTimes = {
+      {.name = "onPaint",
+       .milliseconds = toMilliseconds(timestamps.at(0), timestamps.at(1))},
+      {.name = "UI",
+       .milliseconds = toMilliseconds(timestamps.at(1), timestamps.at(2))}};
+}
@@ -18,6 +18,7 @@
 
 #include "abcgVulkanDevice.hpp"
 #include "abcgVulkanImage.hpp"
+#include "abcgWindow.hpp"
 
 namespace abcg {
 class VulkanSwapchain;
@@ -36,6 +37,8 @@ struct abcg::VulkanFrame {
   vk::CommandPool commandPool{};
   vk::CommandBuffer commandBuffer{};
   vk::CommandBuffer commandBufferUI{};
+  vk::CommandBuffer commandBufferTimestamps{};
+  vk::QueryPool timestampQueryPool{};
   vk::Fence fence{};
   VulkanImage colorImage{};
   vk::Framebuffer framebufferMain{};
@@ -127,6 +130,20 @@ public:
     return m_depthImage;
   }
 
+  /**
+   * @brief Returns the GPU times of the main and UI render passes.
+   *
+   * The times are read from the timestamp queries of a frame when its fence
+   * is signaled, i.e., when the same swapchain image is reused, so reading
+   * them never stalls the CPU.
+   *
+   * @return GPU times of the scopes "onPaint" and "UI", or an empty vector if
+   * the graphics queue does not support timestamps.
+   */
+  [[nodiscard]] std::vector<GPUTime> const &getGPUTimes() const noexcept {
+    return m_GPUTimes;
+  }
+
 private:
   void createFrames();
   void destroyFrames();
@@ -143,6 +160,9 @@ private:
 
   void createFramebuffers(VulkanSettings const &settings);
 
+  void checkTimestampSupport();
+  void readTimestamps(VulkanFrame const &frame);
+
   vk::SwapchainKHR m_swapchainKHR;
   VulkanDevice m_device;
 
@@ -169,6 +189,13 @@ private:
   // Render passes
   vk::RenderPass m_renderPassMain{};
   vk::RenderPass m_renderPassUI{};
+
+  // GPU timestamps
+  bool m_timestampsSupported{};
+  double m_timestampPeriod{};
+  uint64_t m_timestampMask{};
+  std::vector<bool> m_timestampsPending{};
+  std::vector<GPUTime> m_GPUTimes{};
 };
 
 #endif
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #include "abcgEmbeddedFonts.hpp"
 #include "abcgException.hpp"
+#include "abcgProfiler.hpp"
 #include "abcgVulkanError.hpp"
 #include "abcgVulkanInstance.hpp"
 #include "abcgWindow.hpp"
@@ -136,30 +137,7 @@ void abcg::VulkanWindow::onPaint([[maybe_unused]] VulkanFrame const &frame) {}
 void abcg::VulkanWindow::onPaintUI() {
   // FPS counter
   if (abcg::Window::getWindowSettings().showFPS) {
-    auto fps{ImGui::GetIO().Framerate};
-
-    static auto offset{0UL};
-    static auto refreshTime{ImGui::GetTime()};
-    static std::array<float, 150> frames{};
-
-    while (refreshTime < ImGui::GetTime()) {
-      auto const refreshFrequency{60.0};
-      frames.at(offset) = fps;
-      offset = (offset + 1) % frames.size();
-      refreshTime += (1.0 / refreshFrequency);
-    }
-
-    ImGui::SetNextWindowPos(ImVec2(5, 5));
-    ImGui::Begin("FPS", nullptr,
-                 ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs |
-                     ImGuiWindowFlags_NoBringToFrontOnFocus |
-                     ImGuiWindowFlags_NoFocusOnAppearing);
-    auto const label{fmt::format("avg {:.1f} FPS", fps)};
-    ImGui::PlotLines("", frames.data(), gsl::narrow<int>(frames.size()),
-                     gsl::narrow<int>(offset), label.c_str(), 0.0f,
-                     *std::ranges::max_element(frames) * 2,
-                     ImVec2(gsl::narrow<float>(frames.size()), 50));
-    ImGui::End();
+    abcg::Window::paintFPSCounter();
   }
 
   // Fullscreen button
@@ -198,13 +176,31 @@ void abcg::VulkanWindow::onResize() {}
 /**
  * @brief Custom handler called for each frame before painting.
  *
- * This virtual function is called just before abcg::VulkanWindow::onPaint, even
- * if the window is minimized.
+ * This virtual function is called just before abcg::VulkanWindow::onPaint. It
+ * is not called while the window is hidden or minimized.
  *
  * Override it for custom behavior. By default, it does nothing.
  */
 void abcg::VulkanWindow::onUpdate() {}
 
+/**
+ * @brief Custom handler called at a fixed rate.
+ *
+ * This virtual function is called zero or more times per frame, just before
+ * abcg::VulkanWindow::onUpdate, so that it is called on average once every
+ * abcg::WindowSettings::fixedTimeStep seconds. It is not called if
+ * abcg::WindowSettings::fixedTimeStep is zero.
+ *
+ * Use it to advance simulations that must be independent of the frame rate.
+ * When rendering, abcg::Window::getFixedUpdateAlpha can be used to
+ * interpolate between the two latest simulation states.
+ *
+ * Override it for custom behavior. By default, it does nothing.
+ *
+ * @param timeStep Fixed time step, in seconds.
+ */
+void abcg::VulkanWindow::onFixedUpdate([[maybe_unused]] double timeStep) {}
+
 /**
  * @brief Custom handler for cleaning up Vulkan resources.
  *
@@ -218,30 +214,19 @@ void abcg::VulkanWindow::handleEvent(SDL_Event const &event) {
   if (event.window.windowID != abcg::Window::getSDLWindowID())
     return;
 
-  if (event.type == SDL_WINDOWEVENT) {
-    switch (event.window.event) {
-    case SDL_WINDOWEVENT_HIDDEN:
-      m_hidden = true;
-      break;
-    case SDL_WINDOWEVENT_SHOWN:
-    case SDL_WINDOWEVENT_EXPOSED:
-      m_hidden = false;
-      break;
-    case SDL_WINDOWEVENT_MINIMIZED:
-      m_minimized = true;
-      break;
-    case SDL_WINDOWEVENT_RESTORED:
-      m_minimized = false;
-      break;
-    default:
-      break;
-    }
-  }
-
   onEvent(event);
 }
 
+void abcg::VulkanWindow::filesChanged(
+    std::vector<std::filesystem::path> const &files) {
+  m_pipelineReloader.reload(m_swapchain, files);
+}
+
 void abcg::VulkanWindow::create() {
+  if (abcg::Window::getWindowSettings().headless) {
+    throw abcg::RuntimeError("Headless mode is not supported with Vulkan");
+  }
+
   // Create window fol Vulkan graphics
   if (!createSDLWindow(SDL_WINDOW_VULKAN)) {
     throw abcg::SDLError("SDL_CreateWindow failed");
@@ -374,10 +359,12 @@ void abcg::VulkanWindow::create() {
 }
 
 void abcg::VulkanWindow::paint() {
-  onUpdate();
+  m_pipelineReloader.poll(m_swapchain);
 
-  if (m_hidden || m_minimized)
-    return;
+  {
+    ABCG_PROFILE_SCOPE("onUpdate");
+    onUpdate();
+  }
 
   if (m_swapchain.checkRebuild(m_vulkanSettings, getWindowSize())) {
     onResize();
@@ -390,19 +377,46 @@ void abcg::VulkanWindow::paint() {
   ImGui_ImplSDL2_NewFrame();
   ImGui::NewFrame();
 
-  onPaintUI();
+  {
+    ABCG_PROFILE_SCOPE("onPaintUI");
+    onPaintUI();
+  }
+
+#if defined(ABCG_PROFILER)
+  if (abcg::Window::getWindowSettings().showProfiler) {
+    Profiler::paintUI();
+  }
+#endif
+
+  {
+    ABCG_PROFILE_SCOPE("ImGui::Render");
+    ImGui::Render();
+  }
 
-  ImGui::Render();
+  {
+    ABCG_PROFILE_SCOPE("Render");
+    m_swapchain.render([this](auto const &frame) {
+      ABCG_PROFILE_SCOPE("onPaint");
+      onPaint(frame);
+    });
+  }
 
-  m_swapchain.render([this](auto const &frame) { onPaint(frame); });
+  ABCG_PROFILE_SCOPE("Present");
   m_swapchain.present();
 }
 
+void abcg::VulkanWindow::fixedUpdate(double timeStep) {
+  ABCG_PROFILE_SCOPE("onFixedUpdate");
+  onFixedUpdate(timeStep);
+}
+
 void abcg::VulkanWindow::destroy() {
   static_cast<vk::Device>(m_device).waitIdle();
 
   onDestroy();
 
+  m_pipelineReloader.destroy();
+
   ImGui_ImplVulkan_Shutdown();
   ImGui_ImplSDL2_Shutdown();
   ImGui::DestroyContext();
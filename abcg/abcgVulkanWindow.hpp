@@ -19,6 +19,7 @@
 #include "abcgVulkanDevice.hpp"
 #include "abcgVulkanInstance.hpp"
 #include "abcgVulkanPhysicalDevice.hpp"
+#include "abcgVulkanPipelineReloader.hpp"
 #include "abcgVulkanSwapchain.hpp"
 #include "abcgWindow.hpp"
 
@@ -75,6 +76,7 @@ struct abcg::VulkanSettings {
  * @sa abcg::VulkanWindow::onPaintUI for UI rendering.
  * @sa abcg::VulkanWindow::onResize for handling swapchain rebuild events.
  * @sa abcg::VulkanWindow::onUpdate for commands to be called every frame.
+ * @sa abcg::VulkanWindow::onFixedUpdate for commands to be called at a fixed rate.
  * @sa abcg::VulkanWindow::onDestroy for cleaning up Vulkan resources.
  *
  * @remark Objects of this type cannot be copied or copy-constructed.
@@ -94,22 +96,32 @@ public:
   [[nodiscard]] VulkanSwapchain const &getSwapchain() noexcept {
     return m_swapchain;
   }
+  [[nodiscard]] std::vector<GPUTime> const &getGPUTimes() const final {
+    return m_swapchain.getGPUTimes();
+  }
 
 protected:
+  [[nodiscard]] VulkanPipelineReloader &getPipelineReloader() noexcept {
+    return m_pipelineReloader;
+  }
+
   virtual void onEvent(SDL_Event const &event);
   virtual void onCreate();
   virtual void onPaint(VulkanFrame const &frame);
   virtual void onPaintUI();
   virtual void onResize();
   virtual void onUpdate();
+  virtual void onFixedUpdate(double timeStep);
   virtual void onDestroy();
 
 private:
   void handleEvent(SDL_Event const &event) final;
   void create() final;
   void paint() final;
+  void fixedUpdate(double timeStep) final;
   void destroy() final;
   [[nodiscard]] glm::ivec2 getWindowSize() const final;
+  void filesChanged(std::vector<std::filesystem::path> const &files) final;
 
   VulkanSettings m_vulkanSettings;
   std::vector<char const *> const m_deviceExtensions{
@@ -124,10 +136,9 @@ private:
   VulkanPhysicalDevice m_physicalDevice{};
   VulkanDevice m_device{};
   VulkanSwapchain m_swapchain{};
+  VulkanPipelineReloader m_pipelineReloader;
   vk::SurfaceKHR m_surface{};
   vk::DescriptorPool m_UIdescriptorPool{};
-  bool m_hidden{};
-  bool m_minimized{};
 };
 
 #endif
@@ -11,10 +11,20 @@
 #include "abcgWindow.hpp"
 
 #include <SDL_video.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
 #include <utility>
 
 #include <imgui_impl_sdl.h>
 
+#include "abcgApplication.hpp"
+#include "abcgException.hpp"
+#include "abcgProfiler.hpp"
+#include "abcgTrace.hpp"
+
 static ImVec4 ColorAlpha(ImVec4 const &color, float const alpha) {
   return {color.x, color.y, color.z, alpha};
 }
@@ -133,7 +143,8 @@ int abcg::resizingEventWatcher(void *data, SDL_Event *event) {
       if (window.m_enableResizingEventWatcher) {
         [[maybe_unused]] bool done{};
         window.templateHandleEvent(*event, done);
-        window.templatePaint();
+        if (window.needsRedraw())
+          window.templatePaint();
       }
     }
   }
@@ -157,14 +168,28 @@ abcg::fullscreenchangeCallback(int eventType,
 /**
  * @brief Returns the time that have passed since the last frame.
  *
- * This delta time has a minimum resolution of 2ms. If the time is smaller than
- * that, zero is returned. Internally, the delta time accumulates for the next
- * frame(s) until at least 2ms have passed.
+ * This is the time between the start of the previous frame and the start of
+ * the current frame. If a target frame rate is set (see
+ * abcg::WindowSettings::targetFrameRate), it includes the time the frame
+ * limiter has waited, and thus is close to the target frame period. The time
+ * spent idle waiting for events in render-on-demand mode is not included.
  *
  * @returns Time in seconds.
  */
 double abcg::Window::getDeltaTime() const noexcept { return m_lastDeltaTime; }
 
+/**
+ * @brief Returns the real time that have passed since the last frame.
+ *
+ * This is the same interval of abcg::Window::getDeltaTime, but measured with
+ * `std::chrono::steady_clock` even if the timers use the virtual clock (e.g.,
+ * with the command-line options `--fixed-delta` or `--replay`). It is the time
+ * used by the frame statistics of the FPS counter and of the benchmark report.
+ *
+ * @returns Time in seconds.
+ */
+double abcg::Window::getFrameTime() const noexcept { return m_lastFrameTime; }
+
 /**
  * @brief Returns the time that have passed since the window was created.
  *
@@ -172,6 +197,101 @@ double abcg::Window::getDeltaTime() const noexcept { return m_lastDeltaTime; }
  */
 double abcg::Window::getElapsedTime() const { return m_elapsedTime.elapsed(); }
 
+/**
+ * @brief Returns the interpolation factor between the two latest fixed-rate
+ * updates.
+ *
+ * This is the fraction of abcg::WindowSettings::fixedTimeStep that has been
+ * accumulated but not yet consumed by the fixed-rate update handler. It can be
+ * used in the painting handler to interpolate between the previous and the
+ * current simulation states, so that the motion looks smooth even if the
+ * rendering rate is not a multiple of the simulation rate.
+ *
+ * @returns Interpolation factor in the range [0, 1), or 0 if fixed-rate
+ * updates are disabled.
+ */
+double abcg::Window::getFixedUpdateAlpha() const noexcept {
+  return m_fixedUpdateAlpha;
+}
+
+/**
+ * @brief Returns the frame limiter of the rendering loop.
+ *
+ * The frame limiter can be used to query frame pacing statistics such as the
+ * jitter and CPU usage of the rendering loop.
+ *
+ * @returns Reference to the abcg::FrameLimiter object.
+ *
+ * @sa abcg::WindowSettings::targetFrameRate.
+ */
+abcg::FrameLimiter const &abcg::Window::getFrameLimiter() const noexcept {
+  return m_frameLimiter;
+}
+
+/**
+ * @brief Returns whether the window is visible.
+ *
+ * @returns `false` if the window is hidden or minimized; `true` otherwise.
+ */
+bool abcg::Window::isVisible() const noexcept {
+  return !m_hidden && !m_minimized;
+}
+
+/**
+ * @brief Returns the number of frames painted since the window was created.
+ *
+ * @returns Number of calls to the painting handler.
+ */
+std::size_t abcg::Window::getFrameCount() const noexcept {
+  return m_frameCount;
+}
+
+/**
+ * @brief Returns the GPU times of the most recent frame whose timer queries
+ * are available.
+ *
+ * GPU timer queries are read a few frames after they are issued so that the
+ * CPU never waits for the GPU. Thus, the results usually lag behind the
+ * current frame by two or three frames.
+ *
+ * @returns Reference to the GPU times of the built-in scopes and of the scopes
+ * created by the application, or to an empty vector if GPU timing is not
+ * supported.
+ */
+std::vector<abcg::GPUTime> const &abcg::Window::getGPUTimes() const {
+  static std::vector<GPUTime> const noGPUTimes{};
+  return noGPUTimes;
+}
+
+/**
+ * @brief Returns the counters of the most recent frame.
+ *
+ * @returns Reference to the counters, such as the number of draw calls and
+ * bytes uploaded to the GPU, or to an empty vector if counting is not
+ * enabled.
+ *
+ * @sa abcg::WindowSettings::frameCounters.
+ */
+std::vector<abcg::FrameCounter> const &abcg::Window::getFrameCounters() const {
+  static std::vector<FrameCounter> const noFrameCounters{};
+  return noFrameCounters;
+}
+
+/**
+ * @brief Returns the statistics of the frame times.
+ *
+ * The statistics are computed from the real time between consecutive frames
+ * (abcg::Window::getFrameTime) over the last
+ * abcg::WindowSettings::frameStatisticsSize frames. The first frame after the
+ * window is created is not taken into account.
+ *
+ * @returns Reference to the abcg::FrameStatistics object of the window.
+ */
+abcg::FrameStatistics const &
+abcg::Window::getFrameStatistics() const noexcept {
+  return m_frameStatistics;
+}
+
 /**
  * @brief Returns the current configuration settings of the window.
  *
@@ -232,7 +352,8 @@ Uint32 abcg::Window::getSDLWindowID() const noexcept { return m_windowID; }
  * @brief Creates the SDL window.
  *
  * @param extraFlags Extra SDL window flags to be combined with the common
- * flags (`SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI`).
+ * flags (`SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI`, or
+ * `SDL_WINDOW_HIDDEN` if abcg::WindowSettings::headless is `true`).
  *
  * @returns `true` on success; `false` on failure.
  */
@@ -240,7 +361,9 @@ bool abcg::Window::createSDLWindow(SDL_WindowFlags extraFlags) {
   if (m_window != nullptr)
     return false;
 
-  auto commonFlags{SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI};
+  auto commonFlags{m_windowSettings.headless
+                       ? SDL_WINDOW_HIDDEN
+                       : SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI};
 
   m_window = SDL_CreateWindow(
       m_windowSettings.title.c_str(), SDL_WINDOWPOS_CENTERED,
@@ -313,17 +436,133 @@ void abcg::Window::toggleFullscreen() {
 #endif
 }
 
+/**
+ * @brief Paints the FPS counter with Dear ImGui.
+ *
+ * This shows a histogram of the recent frame times in the top-left corner of
+ * the window, followed by the frame time percentiles, the number of hitches,
+ * the CPU usage and frame pacing jitter of the rendering loop, the GPU times,
+ * and the frame counters. It must be called between `ImGui::NewFrame` and
+ * `ImGui::Render`.
+ *
+ * @sa abcg::Window::getFrameStatistics.
+ */
+void abcg::Window::paintFPSCounter() {
+  auto const average{m_frameStatistics.getAverage()};
+  auto const p50{m_frameStatistics.getPercentile(50.0) * 1000.0};
+  auto const p95{m_frameStatistics.getPercentile(95.0) * 1000.0};
+  auto const p99{m_frameStatistics.getPercentile(99.0) * 1000.0};
+  auto const maximum{m_frameStatistics.getMaximum() * 1000.0};
+
+  ImGui::SetNextWindowPos(ImVec2(5, 5));
+  ImGui::Begin("FPS", nullptr,
+               ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs |
+                   ImGuiWindowFlags_NoBringToFrontOnFocus |
+                   ImGuiWindowFlags_NoFocusOnAppearing);
+  auto const label{
+      fmt::format("avg {:.1f} FPS", average > 0.0 ? 1.0 / average : 0.0)};
+  // Distribution of the frame times from 0 to 4 times the median. Slower
+  // frames are counted in the last bin.
+  m_frameStatistics.getHistogram(m_fpsHistogram, p50 * 4.0 / 1000.0);
+  std::ranges::transform(
+      m_fpsHistogram, m_fpsHistogramPlot.begin(),
+      [](auto const count) { return gsl::narrow_cast<float>(count); });
+  ImGui::PlotHistogram("", m_fpsHistogramPlot.data(),
+                       gsl::narrow<int>(m_fpsHistogramPlot.size()), 0,
+                       label.c_str(), 0.0f, std::numeric_limits<float>::max(),
+                       ImVec2(150, 50));
+  auto const range{fmt::format("0 to {:.1f} ms", p50 * 4.0)};
+  ImGui::TextUnformatted(range.c_str());
+  auto const percentiles{fmt::format(
+      "p50 {:.1f}  p95 {:.1f}  p99 {:.1f}  max {:.1f} ms", p50, p95, p99,
+      maximum)};
+  ImGui::TextUnformatted(percentiles.c_str());
+  auto const hitches{fmt::format("hitches {} / {} frames",
+                                 m_frameStatistics.getHitchCount(),
+                                 m_frameStatistics.getFrameCount())};
+  ImGui::TextUnformatted(hitches.c_str());
+  auto const pacing{fmt::format("CPU {:.0f}%  jitter {:.2f} ms",
+                                m_frameLimiter.getCPUUsage() * 100.0,
+                                m_frameLimiter.getJitter() * 1000.0)};
+  ImGui::TextUnformatted(pacing.c_str());
+  for (auto const &gpuTime : getGPUTimes()) {
+    auto const text{
+        fmt::format("GPU {} {:.2f} ms", gpuTime.name, gpuTime.milliseconds)};
+    ImGui::TextUnformatted(text.c_str());
+  }
+  for (auto const &counter : getFrameCounters()) {
+    auto const text{fmt::format("{} {}", counter.name, counter.value)};
+    ImGui::TextUnformatted(text.c_str());
+  }
+  ImGui::End();
+}
+
+/**
+ * @brief Requests a new frame to be painted.
+ *
+ * This is only needed when abcg::WindowSettings::renderOnDemand is `true`.
+ * In that case, call it whenever the contents of the window must be updated
+ * for reasons other than user input, which already triggers a new frame.
+ *
+ * This must be called from the main thread.
+ *
+ * @sa abcg::Window::requestRedrawFor.
+ */
+void abcg::Window::requestRedraw() noexcept {
+  // Dear ImGui may need an additional frame to settle after a change
+  m_pendingRedraws = 2;
+}
+
+/**
+ * @brief Requests the window to be painted continuously for a given time.
+ *
+ * This is only needed when abcg::WindowSettings::renderOnDemand is `true`.
+ * Use it to keep the window painting while an animation is running. If an
+ * animation is already active, its end time is extended if needed.
+ *
+ * This must be called from the main thread.
+ *
+ * @param seconds Duration of the animation, in seconds.
+ *
+ * @sa abcg::Window::requestRedraw.
+ */
+void abcg::Window::requestRedrawFor(double seconds) {
+  m_redrawDeadline =
+      std::max(m_redrawDeadline, m_elapsedTime.elapsed() + seconds);
+  requestRedraw();
+}
+
 void abcg::Window::templateHandleEvent(SDL_Event const &event, bool &done) {
   ImGui_ImplSDL2_ProcessEvent(&event);
 
   if (event.window.windowID != m_windowID)
     return;
 
+  requestRedraw();
+
+  if (m_fileWatcher.isActive() && event.type == m_fileWatcherEventType) {
+    filesChanged(m_fileWatcher.takeChangedFiles());
+    return;
+  }
+
   if (event.type == SDL_WINDOWEVENT) {
     switch (event.window.event) {
     case SDL_WINDOWEVENT_CLOSE:
       done = true;
       break;
+    case SDL_WINDOWEVENT_HIDDEN:
+      m_hidden = true;
+      break;
+    case SDL_WINDOWEVENT_SHOWN:
+    case SDL_WINDOWEVENT_EXPOSED:
+      m_hidden = false;
+      break;
+    case SDL_WINDOWEVENT_MINIMIZED:
+      m_minimized = true;
+      break;
+    case SDL_WINDOWEVENT_RESTORED:
+      m_minimized = false;
+      break;
 
     case SDL_WINDOWEVENT_RESIZED: {
       auto const fullscreen{
@@ -344,6 +583,19 @@ void abcg::Window::templateHandleEvent(SDL_Event const &event, bool &done) {
     }
   }
   if (event.type == SDL_KEYUP) {
+#if !defined(__EMSCRIPTEN__)
+    if (event.key.keysym.sym == SDLK_F10) {
+      if (Trace::isActive()) {
+        Trace::stop();
+      } else {
+        try {
+          Trace::start("abcg_trace.json");
+        } catch (abcg::RuntimeError const &exception) {
+          fmt::print("Failed to start trace: {}\n", exception.what());
+        }
+      }
+    }
+#endif
     if (event.key.keysym.sym == SDLK_F11) {
 #if defined(__EMSCRIPTEN__)
       auto const isFullscreenAvailable{
@@ -381,29 +633,152 @@ void abcg::Window::templateHandleEvent(SDL_Event const &event, bool &done) {
 
 void abcg::Window::templateCreate() {
   m_deltaTime.restart();
+  m_frameStart = Timer::clock::now();
   m_elapsedTime.restart();
+  m_fixedUpdateAccumulator = 0.0;
+  m_fixedUpdateAlpha = 0.0;
 
   create();
 
+  m_frameLimiter.reset();
+
+  if (m_windowSettings.hotReload && FileWatcher::isSupported()) {
+    // The watcher thread wakes up the main loop with a user event
+    static Uint32 const registeredEventType{SDL_RegisterEvents(1)};
+    m_fileWatcherEventType = registeredEventType;
+    if (m_fileWatcherEventType != std::numeric_limits<Uint32>::max()) {
+      m_fileWatcher.start(Application::getAssetsPath(),
+                          [eventType = m_fileWatcherEventType,
+                           windowID = m_windowID] {
+                            SDL_Event event{};
+                            event.type = eventType;
+                            event.user.windowID = windowID;
+                            SDL_PushEvent(&event);
+                          });
+    }
+  }
+
   // Set up our own Dear ImGui style
   setupImGuiStyle(true, 1.0f);
 }
 
 void abcg::Window::templatePaint() {
-  // Cap to 480 Hz
-  if (m_deltaTime.elapsed() >= 1.0 / 480.0) {
-    m_lastDeltaTime = m_deltaTime.restart();
+  auto const frameBegin{Profiler::now()};
+#if defined(ABCG_PROFILER)
+  Profiler::beginFrame();
+#endif
+
+  m_pendingRedraws = std::max(m_pendingRedraws - 1, 0);
+  m_lastDeltaTime = m_deltaTime.restart();
+  auto const frameStart{Timer::clock::now()};
+  m_lastFrameTime =
+      std::chrono::duration<double>{frameStart - m_frameStart}.count();
+  m_frameStart = frameStart;
+  ++m_frameCount;
+
+  m_frameStatistics.setWindowSize(m_windowSettings.frameStatisticsSize);
+  if (m_frameCount > 1) {
+    m_frameStatistics.addFrameTime(m_lastFrameTime);
+  }
+
+  if (auto const timeStep{m_windowSettings.fixedTimeStep}; timeStep > 0.0) {
+    auto const maxUpdates{std::max(m_windowSettings.maxFixedUpdatesPerFrame, 1)};
+    m_fixedUpdateAccumulator += m_lastDeltaTime;
+    for (auto updates{0}; m_fixedUpdateAccumulator >= timeStep; ++updates) {
+      if (updates == maxUpdates) {
+        // Discard the time we could not catch up with
+        m_fixedUpdateAccumulator = std::fmod(m_fixedUpdateAccumulator, timeStep);
+        break;
+      }
+      fixedUpdate(timeStep);
+      m_fixedUpdateAccumulator -= timeStep;
+    }
+    m_fixedUpdateAlpha = m_fixedUpdateAccumulator / timeStep;
   } else {
-    m_lastDeltaTime = 0.0;
+    m_fixedUpdateAccumulator = 0.0;
+    m_fixedUpdateAlpha = 0.0;
   }
 
   paint();
+
+  {
+    ABCG_PROFILE_SCOPE("FrameLimiter");
+    m_frameLimiter.setTargetFrameRate(m_windowSettings.targetFrameRate);
+    m_frameLimiter.wait();
+  }
+
+#if defined(ABCG_PROFILER)
+  Profiler::endFrame();
+#endif
+
+  if (Trace::isActive()) {
+    writeTraceEvents(frameBegin);
+  }
+}
+
+void abcg::Window::writeTraceEvents(std::int64_t frameBegin) const {
+#if defined(ABCG_PROFILER)
+  // The events of the profiler include the frame itself
+  (void)frameBegin;
+  for (auto const &event : Profiler::getFrameEvents()) {
+    Trace::writeCompleteEvent(event.name, "cpu", event.begin, event.end,
+                              event.thread);
+  }
+#else
+  Trace::writeCompleteEvent("Frame", "cpu", frameBegin, Profiler::now(),
+                            Profiler::getThreadIndex());
+#endif
+
+  std::vector<std::pair<std::string_view, double>> gpuTimes;
+  for (auto const &gpuTime : getGPUTimes()) {
+    gpuTimes.emplace_back(gpuTime.name, gpuTime.milliseconds);
+  }
+  Trace::writeCounterEvent("GPU time (ms)", Profiler::now(), gpuTimes);
+
+  if (auto const &frameCounters{getFrameCounters()}; !frameCounters.empty()) {
+    std::vector<std::pair<std::string_view, double>> values;
+    for (auto const &counter : frameCounters) {
+      values.emplace_back(counter.name,
+                          gsl::narrow_cast<double>(counter.value));
+    }
+    Trace::writeCounterEvent("Frame counters", Profiler::now(), values);
+  }
+}
+
+bool abcg::Window::needsRedraw() const {
+  if (m_windowSettings.headless)
+    return true;
+  if (!isVisible())
+    return false;
+  if (!m_windowSettings.renderOnDemand)
+    return true;
+  return m_pendingRedraws > 0 || m_elapsedTime.elapsed() < m_redrawDeadline;
+}
+
+// Blocks until an event is received or a timeout expires if there is nothing
+// to paint. Returns true if an event was stored in the given structure.
+bool abcg::Window::waitEvent(SDL_Event &event) {
+  if (needsRedraw())
+    return false;
+
+  // Bounded so that the main loop still wakes up periodically when no events
+  // are delivered (e.g., while the window is hidden or minimized)
+  constexpr int maxWaitTime{100}; // ms
+  auto const received{SDL_WaitEventTimeout(&event, maxWaitTime) != 0};
+
+  // Idle time does not count as frame time
+  m_deltaTime.restart();
+  m_frameStart = Timer::clock::now();
+
+  return received;
 }
 
 void abcg::Window::templateDestroy() {
   if (m_window == nullptr)
     return;
 
+  m_fileWatcher.stop();
+
   destroy();
 
   SDL_DestroyWindow(m_window);
@@ -13,9 +13,16 @@
 #ifndef ABCG_WINDOW_HPP_
 #define ABCG_WINDOW_HPP_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "abcgExternal.hpp"
+#include "abcgFileWatcher.hpp"
+#include "abcgFrameLimiter.hpp"
+#include "abcgFrameStatistics.hpp"
 #include "abcgTimer.hpp"
 
 #if defined(__EMSCRIPTEN__)
@@ -24,6 +31,8 @@
 
 namespace abcg {
 struct WindowSettings;
+struct GPUTime;
+struct FrameCounter;
 class Application;
 class Window;
 int resizingEventWatcher(void *data, SDL_Event *event);
@@ -68,6 +77,142 @@ struct abcg::WindowSettings {
   std::string fullscreenElementID{"#canvas"};
   /** @brief String containing the window title. */
   std::string title{"ABCg Window"};
+  /** @brief Time step, in seconds, of the fixed-rate update handler.
+   *
+   * If greater than zero, the fixed-rate update handler (e.g.,
+   * abcg::OpenGLWindow::onFixedUpdate) is called zero or more times per frame
+   * so that the simulation advances at a constant rate that is independent of
+   * the rendering rate. If zero (default), fixed-rate updates are disabled.
+   */
+  double fixedTimeStep{};
+  /** @brief Maximum number of fixed-rate updates per frame.
+   *
+   * If the simulation falls behind by more than this number of steps, the
+   * remaining time is discarded so that the application does not spend
+   * increasingly more time catching up on each frame.
+   */
+  int maxFixedUpdatesPerFrame{5};
+  /** @brief Target frame rate, in frames per second.
+   *
+   * If greater than zero, the rendering loop is limited to this frame rate.
+   * The application sleeps for most of the frame period and spins only for
+   * the last fraction, so that frame pacing stays tight without keeping the
+   * CPU busy. If zero (default), the frame rate is unlimited.
+   *
+   * This has no effect in WebAssembly builds, where the frame rate is
+   * controlled by the browser.
+   *
+   * @sa abcg::FrameLimiter.
+   */
+  double targetFrameRate{};
+  /** @brief Whether the window is painted only when needed.
+   *
+   * If `true`, the main loop blocks until there are pending events, and a new
+   * frame is painted only after receiving input, after a call to
+   * abcg::Window::requestRedraw, or while an animation requested with
+   * abcg::Window::requestRedrawFor is active. If `false` (default), the
+   * window is painted continuously.
+   *
+   * Regardless of this setting, the window is never painted while it is
+   * hidden or minimized.
+   */
+  bool renderOnDemand{false};
+  /** @brief Whether the application runs without a visible window.
+   *
+   * If `true`, the SDL window is created hidden and the scene is rendered
+   * offscreen at the fixed resolution given by abcg::WindowSettings::width and
+   * abcg::WindowSettings::height. If the environment variable
+   * `SDL_VIDEODRIVER` is not set, SDL's `offscreen` video driver is used so
+   * that no display server is required.
+   *
+   * This is only supported by abcg::OpenGLWindow.
+   */
+  bool headless{false};
+  /** @brief Number of frames to paint before closing the application.
+   *
+   * If zero (default), the application runs until the window is closed.
+   */
+  std::size_t maxFrames{};
+  /** @brief Number of most recent frames used to compute the frame time
+   * statistics.
+   *
+   * @sa abcg::Window::getFrameStatistics.
+   */
+  std::size_t frameStatisticsSize{300};
+  /** @brief Whether to show the profiler overlay.
+   *
+   * The overlay shows a flame graph of the last frame and the timing
+   * statistics of each profiling scope. This has no effect unless ABCg is
+   * built with the CMake option `ENABLE_PROFILER`.
+   *
+   * @sa abcg::Profiler.
+   */
+  bool showProfiler{true};
+  /** @brief Whether to reload shaders when their files are modified.
+   *
+   * If `true`, the assets directory (abcg::Application::getAssetsPath) is
+   * watched for modified files. Programs registered with
+   * abcg::OpenGLProgramReloader (see abcg::OpenGLWindow::getProgramReloader)
+   * or abcg::VulkanPipelineReloader (see
+   * abcg::VulkanWindow::getPipelineReloader) are rebuilt when their shader
+   * files change. This must be set before abcg::Application::run and is only
+   * supported on Linux.
+   *
+   * @sa abcg::FileWatcher.
+   */
+  bool hotReload{false};
+  /** @brief Whether to count the graphics API calls of each frame.
+   *
+   * The counts, such as the number of draw calls and bytes uploaded, are
+   * shown in the FPS counter and written to the benchmark report. This must be
+   * set before abcg::Application::run and is only supported by
+   * abcg::OpenGLWindow.
+   *
+   * @sa abcg::Window::getFrameCounters.
+   * @sa abcg::OpenGLCounters.
+   */
+  bool frameCounters{false};
+  /** @brief Path of a file to which the OpenGL calls are captured.
+   *
+   * If not empty, the calls of the OpenGL function wrappers are written to
+   * the file from the creation of the OpenGL context until the last frame
+   * given by `captureFirstFrame` and `captureFrameCount`. The file can be
+   * replayed with the `abcg_replay` tool. This must be set before
+   * abcg::Application::run and is only supported by abcg::OpenGLWindow on
+   * desktop platforms.
+   *
+   * @sa abcg::beginOpenGLCapture.
+   */
+  std::string capturePath{};
+  /** @brief Index of the first captured frame that is measured by the
+   * replay. The frames before it are captured only to recreate the state. */
+  std::size_t captureFirstFrame{};
+  /** @brief Number of captured frames that are measured by the replay. */
+  std::size_t captureFrameCount{1};
+};
+
+/**
+ * @brief GPU time of a profiled scope.
+ *
+ * @sa abcg::Window::getGPUTimes.
+ */
+struct abcg::GPUTime {
+  /** @brief Name of the scope. */
+  char const *name{};
+  /** @brief Time spent by the GPU in the scope, in milliseconds. */
+  double milliseconds{};
+};
+
+/**
+ * @brief Value of a counter of the most recent frame.
+ *
+ * @sa abcg::Window::getFrameCounters.
+ */
+struct abcg::FrameCounter {
+  /** @brief Name of the counter. */
+  char const *name{};
+  /** @brief Value of the counter. */
+  std::uint64_t value{};
 };
 
 /**
@@ -107,6 +252,11 @@ public:
   [[nodiscard]] WindowSettings const &getWindowSettings() const noexcept;
   void setWindowSettings(WindowSettings const &windowSettings);
 
+  [[nodiscard]] virtual std::vector<GPUTime> const &getGPUTimes() const;
+  [[nodiscard]] virtual std::vector<FrameCounter> const &
+  getFrameCounters() const;
+  [[nodiscard]] FrameStatistics const &getFrameStatistics() const noexcept;
+
 protected:
   /**
    * @brief Custom event handler.
@@ -134,6 +284,17 @@ protected:
    */
   virtual void paint() = 0;
 
+  /**
+   * @brief Custom handler for fixed-rate updates.
+   *
+   * This is called zero or more times per frame, just before
+   * abcg::Window::paint, if abcg::WindowSettings::fixedTimeStep is greater
+   * than zero.
+   *
+   * @param timeStep Fixed time step, in seconds.
+   */
+  virtual void fixedUpdate(double timeStep) = 0;
+
   /**
    * @brief Custom handler for window cleanup tasks.
    *
@@ -152,14 +313,33 @@ protected:
    */
   [[nodiscard]] virtual glm::ivec2 getWindowSize() const = 0;
 
+  /**
+   * @brief Custom handler for modified files.
+   *
+   * This is called when files in the assets directory are modified, if
+   * abcg::WindowSettings::hotReload is `true`.
+   *
+   * @param files Paths of the modified files.
+   */
+  virtual void filesChanged(
+      [[maybe_unused]] std::vector<std::filesystem::path> const &files) {}
+
   [[nodiscard]] double getDeltaTime() const noexcept;
+  [[nodiscard]] double getFrameTime() const noexcept;
   [[nodiscard]] double getElapsedTime() const;
+  [[nodiscard]] double getFixedUpdateAlpha() const noexcept;
+  [[nodiscard]] FrameLimiter const &getFrameLimiter() const noexcept;
+  [[nodiscard]] bool isVisible() const noexcept;
+  [[nodiscard]] std::size_t getFrameCount() const noexcept;
   [[nodiscard]] SDL_Window *getSDLWindow() const noexcept;
   [[nodiscard]] Uint32 getSDLWindowID() const noexcept;
   [[nodiscard]] bool createSDLWindow(SDL_WindowFlags extraFlags);
 
   void setEnableResizingEventWatcher(bool enabled) noexcept;
   void toggleFullscreen();
+  void paintFPSCounter();
+  void requestRedraw() noexcept;
+  void requestRedrawFor(double seconds);
 
 private:
   void templateHandleEvent(SDL_Event const &event, bool &done);
@@ -167,6 +347,10 @@ private:
   void templatePaint();
   void templateDestroy();
 
+  [[nodiscard]] bool needsRedraw() const;
+  bool waitEvent(SDL_Event &event);
+  void writeTraceEvents(std::int64_t frameBegin) const;
+
   SDL_Window *m_window{};
   Uint32 m_windowID{};
 
@@ -175,9 +359,30 @@ private:
   Timer m_deltaTime;
   Timer m_elapsedTime;
   double m_lastDeltaTime{};
+  // Start of the current frame and time since the previous one, measured with
+  // the real clock even if the timers use the virtual clock
+  Timer::clock::time_point m_frameStart{};
+  double m_lastFrameTime{};
+  double m_fixedUpdateAccumulator{};
+  double m_fixedUpdateAlpha{};
+  FrameLimiter m_frameLimiter;
+  FrameStatistics m_frameStatistics;
+  // Buffers of the frame time histogram of the FPS counter
+  static constexpr std::size_t fpsHistogramBins{50};
+  std::array<std::size_t, fpsHistogramBins> m_fpsHistogram{};
+  std::array<float, fpsHistogramBins> m_fpsHistogramPlot{};
+
+  int m_pendingRedraws{};
+  double m_redrawDeadline{};
+  bool m_hidden{};
+  bool m_minimized{};
+  std::size_t m_frameCount{};
 
   bool m_enableResizingEventWatcher{true};
 
+  FileWatcher m_fileWatcher;
+  Uint32 m_fileWatcherEventType{};
+
   friend Application;
   friend int resizingEventWatcher(void *data, SDL_Event *event);
 #if defined(__EMSCRIPTEN__)
@@ -177,3 +177,120 @@ function(enable_abcg project_target)
   endif()
 
 endfunction()
+
+# Function to validate GLSL shaders at build time. A shader that fails to
+# compile fails the build of the target.
+#
+# In Vulkan builds, the shaders are also compiled to SPIR-V and embedded in the
+# generated header file shaders.hpp as abcg::ShaderBinary objects of namespace
+# shaders, named after the files (e.g., the code of UnlitVertexColor.vert is
+# shaders::UnlitVertexColor_vert). These objects can be given to
+# abcg::VulkanShader::create so that glslang is not used at runtime.
+#
+# The shader stage is deduced from the file extension: .vert, .tesc, .tese,
+# .geom, .frag or .comp. #include directives are expanded as in
+# abcg::ShaderPreprocessor, with the assets directory of the target as the
+# fallback search directory.
+#
+# In Vulkan builds, the glslangValidator built from the bundled glslang is used.
+# Otherwise, glslangValidator is searched in the system and, if not found, the
+# shaders are not validated.
+#
+# Usage:
+#
+# abcg_add_shaders(${PROJECT_NAME} assets/shader.vert assets/shader.frag)
+function(abcg_add_shaders project_target)
+  if(TARGET glslangValidator)
+    set(validator $<TARGET_FILE:glslangValidator>)
+    set(validator_target glslangValidator)
+  else()
+    find_program(GLSLANG_VALIDATOR glslangValidator)
+    if(NOT GLSLANG_VALIDATOR)
+      if(${GRAPHICS_API} MATCHES "Vulkan")
+        message(FATAL_ERROR "glslangValidator is required to build the "
+                            "shaders of ${project_target}")
+      endif()
+      message(STATUS "glslangValidator not found: shaders of "
+                     "${project_target} will not be validated")
+      return()
+    endif()
+    set(validator ${GLSLANG_VALIDATOR})
+    set(validator_target "")
+  endif()
+
+  if(${GRAPHICS_API} MATCHES "Vulkan")
+    set(spirv ON)
+  else()
+    set(spirv OFF)
+  endif()
+
+  set(output_dir ${CMAKE_CURRENT_BINARY_DIR}/${project_target}_shaders)
+
+  foreach(shader ${ARGN})
+    get_filename_component(shader_path ${shader} ABSOLUTE)
+    get_filename_component(shader_name ${shader} NAME)
+    get_filename_component(extension ${shader} LAST_EXT)
+
+    if(extension STREQUAL ".vert")
+      set(stage Vertex)
+    elseif(extension STREQUAL ".tesc")
+      set(stage TessellationControl)
+    elseif(extension STREQUAL ".tese")
+      set(stage TessellationEvaluation)
+    elseif(extension STREQUAL ".geom")
+      set(stage Geometry)
+    elseif(extension STREQUAL ".frag")
+      set(stage Fragment)
+    elseif(extension STREQUAL ".comp")
+      set(stage Compute)
+    else()
+      message(FATAL_ERROR "Unknown shader stage of ${shader}")
+    endif()
+
+    string(MAKE_C_IDENTIFIER ${shader_name} variable)
+    set(stamp ${output_dir}/${shader_name}.stamp)
+    set(outputs ${stamp})
+    if(spirv)
+      set(header ${output_dir}/${variable}.hpp)
+      list(APPEND outputs ${header})
+      set_property(
+        TARGET ${project_target}
+        APPEND
+        PROPERTY ABCG_SHADER_INCLUDES "#include \"${variable}.hpp\"")
+    endif()
+
+    add_custom_command(
+      OUTPUT ${outputs}
+      COMMAND
+        ${CMAKE_COMMAND} -DVALIDATOR=${validator} -DSHADER=${shader_path}
+        -DASSETS_DIR=${CMAKE_CURRENT_SOURCE_DIR}/assets
+        -DOUTPUT_DIR=${output_dir} -DSTAMP=${stamp}
+        -DDEPFILE=${stamp}.d -DSPIRV=${spirv} -DHEADER=${header}
+        -DVARIABLE=${variable} -DSTAGE=${stage} -P
+        ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/CompileShader.cmake
+      DEPENDS ${shader_path}
+              ${CMAKE_CURRENT_FUNCTION_LIST_DIR}/CompileShader.cmake
+              ${validator_target}
+      DEPFILE ${stamp}.d
+      COMMENT "Compiling shader ${shader}"
+      VERBATIM)
+    target_sources(${project_target} PRIVATE ${outputs})
+  endforeach()
+
+  # Header file that includes the headers of all shaders of the target
+  get_target_property(header_generated ${project_target}
+                      ABCG_SHADERS_HEADER_GENERATED)
+  if(spirv AND NOT header_generated)
+    set(content "// Generated by abcg_add_shaders. Do not edit.\n\n")
+    string(APPEND content "#pragma once\n\n")
+    string(APPEND content "$<JOIN:$<TARGET_PROPERTY:${project_target},"
+           "ABCG_SHADER_INCLUDES>,\n>\n")
+    file(
+      GENERATE
+      OUTPUT ${output_dir}/shaders.hpp
+      CONTENT "${content}")
+    set_target_properties(${project_target}
+                          PROPERTIES ABCG_SHADERS_HEADER_GENERATED TRUE)
+    target_include_directories(${project_target} PRIVATE ${output_dir})
+  endif()
+endfunction()
@@ -0,0 +1,27 @@
+# Script run by abcg_bench (see examples/CMakeLists.txt) to check a benchmark
+# report written with --report.
+#
+# Usage:
+#
+# cmake -DREPORT=<report file> -P CheckBenchmarkReport.cmake
+#
+# The benchmarks run with --fixed-delta, which makes the timers of the
+# application use a virtual clock that advances by a constant amount per frame.
+# The frame times of the report must still be measured with the real clock, so
+# they are expected to vary between frames.
+
+cmake_minimum_required(VERSION 3.21)
+
+file(READ ${REPORT} report)
+string(JSON frames GET ${report} frames)
+string(JSON p50 GET ${report} frameTime p50)
+string(JSON maximum GET ${report} frameTime max)
+
+if(frames GREATER 1 AND p50 STREQUAL maximum)
+  message(
+    FATAL_ERROR
+      "${REPORT}: all frame times are ${p50} ms. The frame statistics are "
+      "probably measured with the virtual clock of --fixed-delta.")
+endif()
+
+message(STATUS "${REPORT}: ${frames} frames, p50 ${p50} ms, max ${maximum} ms")
@@ -17,6 +17,35 @@ option(ENABLE_IPO "Enable Interprocedural Optimization" ON)
 # mold
 option(ENABLE_MOLD "Enable mold (Modern Linker)" OFF)
 
+# Profiler
+option(ENABLE_PROFILER "Enable the built-in frame profiler" OFF)
+if(ENABLE_PROFILER)
+  add_compile_definitions(ABCG_PROFILER)
+endif()
+
+# Benchmark
+option(ENABLE_BENCHMARK "Add the abcg_bench target for benchmarking the examples"
+       OFF)
+set(BENCHMARK_FRAMES
+    600
+    CACHE STRING "Number of frames painted by each benchmark run.")
+set(BENCHMARK_SIZE
+    1280x720
+    CACHE STRING "Resolution of the benchmark runs.")
+set(BENCHMARK_SEED
+    42
+    CACHE STRING "Random seed of the benchmark runs.")
+set(BENCHMARK_FIXED_DELTA
+    0.0166667
+    CACHE STRING "Time step, in seconds, of each frame of the benchmark runs.")
+option(BENCHMARK_SOFTWARE_RENDERING
+       "Run the benchmarks with Mesa's software rasterizer (llvmpipe)" ON)
+option(BENCHMARK_COUNT_ALLOCATIONS
+       "Count the memory allocations of each frame in the benchmark reports" ON)
+if(ENABLE_BENCHMARK AND BENCHMARK_COUNT_ALLOCATIONS)
+  add_compile_definitions(ABCG_COUNT_ALLOCATIONS)
+endif()
+
 if(NOT ${CMAKE_SYSTEM_NAME} MATCHES "Emscripten")
   set(OPTIONS_TARGET options)
   set(SANITIZERS_TARGET sanitizers)
@@ -0,0 +1,156 @@
+# Script run by abcg_add_shaders (see ABCg.cmake) to validate a GLSL shader at
+# build time and, optionally, embed its SPIR-V code in a C++ header file.
+#
+# Usage:
+#
+# cmake -DVALIDATOR=<glslangValidator> -DSHADER=<shader file>
+# -DASSETS_DIR=<assets directory> -DOUTPUT_DIR=<output directory>
+# -DSTAMP=<file touched on success> -DDEPFILE=<dependency file> [-DSPIRV=ON
+# -DHEADER=<header file> -DVARIABLE=<C++ identifier> -DSTAGE=<abcg::ShaderStage
+# enumerator>] -P CompileShader.cmake
+#
+# #include directives are expanded with the same rules as
+# abcg::ShaderPreprocessor: the included file is searched in the directory of
+# the including file, then in ASSETS_DIR, and each file is included only once.
+
+cmake_minimum_required(VERSION 3.21)
+
+set_property(GLOBAL PROPERTY ABCG_SHADER_FILES "")
+
+# Function to expand the #include directives of a shader file.
+#
+# Parameters:
+#
+# FILE: Path of the shader file.
+#
+# OUTPUT_VARIABLE: Name of the variable that receives the expanded source.
+function(EXPAND_INCLUDES FILE OUTPUT_VARIABLE)
+  get_property(files GLOBAL PROPERTY ABCG_SHADER_FILES)
+  list(LENGTH files index)
+  list(APPEND files ${FILE})
+  set_property(GLOBAL PROPERTY ABCG_SHADER_FILES ${files})
+
+  file(READ ${FILE} content)
+  string(REPLACE "\r\n" "\n" content "${content}")
+  get_filename_component(directory ${FILE} DIRECTORY)
+
+  set(result "")
+  set(line 1)
+  set(include_regex
+      "(^|\n)[ \t]*#[ \t]*include[ \t]*[\"<]([^\">]+)[\">][^\n]*")
+  while(TRUE)
+    string(REGEX MATCH "${include_regex}" match "${content}")
+    if(NOT match)
+      string(APPEND result "${content}")
+      break()
+    endif()
+    set(name ${CMAKE_MATCH_2})
+
+    # Split the content into the lines before the directive and the lines after
+    string(FIND "${content}" "${match}" position)
+    string(LENGTH "${match}" length)
+    if(match MATCHES "^\n")
+      math(EXPR position "${position} + 1")
+      math(EXPR length "${length} - 1")
+    endif()
+    string(SUBSTRING "${content}" 0 ${position} before)
+    math(EXPR after_position "${position} + ${length}")
+    string(SUBSTRING "${content}" ${after_position} -1 content)
+    string(APPEND result "${before}")
+
+    string(REGEX MATCHALL "\n" newlines "${before}")
+    list(LENGTH newlines newline_count)
+    math(EXPR line "${line} + ${newline_count}")
+
+    if(EXISTS ${directory}/${name})
+      get_filename_component(path ${directory}/${name} REALPATH)
+    elseif(EXISTS ${ASSETS_DIR}/${name})
+      get_filename_component(path ${ASSETS_DIR}/${name} REALPATH)
+    else()
+      message(FATAL_ERROR "${FILE}:${line}: Failed to include ${name}")
+    endif()
+
+    get_property(files GLOBAL PROPERTY ABCG_SHADER_FILES)
+    if(NOT path IN_LIST files)
+      list(LENGTH files included_index)
+      expand_includes(${path} included)
+      math(EXPR next_line "${line} + 1")
+      string(APPEND result "#line 1 ${included_index}\n${included}\n"
+             "#line ${next_line} ${index}")
+    endif()
+  endwhile()
+
+  set(${OUTPUT_VARIABLE}
+      "${result}"
+      PARENT_SCOPE)
+endfunction()
+
+get_filename_component(SHADER ${SHADER} REALPATH)
+expand_includes(${SHADER} source)
+
+# The extension is kept so that glslangValidator infers the shader stage
+get_filename_component(shader_name ${SHADER} NAME)
+set(expanded ${OUTPUT_DIR}/${shader_name})
+file(WRITE ${expanded} "${source}")
+
+if(SPIRV)
+  set(spirv ${OUTPUT_DIR}/${shader_name}.spv)
+  set(arguments -V --target-env vulkan1.0 -o ${spirv})
+endif()
+
+execute_process(
+  COMMAND ${VALIDATOR} ${arguments} ${expanded}
+  RESULT_VARIABLE result
+  OUTPUT_VARIABLE output
+  ERROR_VARIABLE output)
+
+get_property(files GLOBAL PROPERTY ABCG_SHADER_FILES)
+
+if(NOT result EQUAL 0)
+  # Map the source string numbers of the messages back to the file names
+  set(legend "")
+  set(index 0)
+  foreach(file ${files})
+    string(APPEND legend "  ${index}: ${file}\n")
+    math(EXPR index "${index} + 1")
+  endforeach()
+  message(FATAL_ERROR "Failed to compile ${SHADER}\n${output}\n"
+                      "Source strings:\n${legend}")
+endif()
+
+if(SPIRV)
+  # Read the code as little-endian 32-bit words
+  file(READ ${spirv} hex HEX)
+  string(REGEX MATCHALL "........" bytes "${hex}")
+  set(words "")
+  set(word_count 0)
+  foreach(word ${bytes})
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1U" word ${word})
+    math(EXPR column "${word_count} % 5")
+    if(column EQUAL 0)
+      string(APPEND words "\n   ")
+    endif()
+    string(APPEND words " ${word},")
+    math(EXPR word_count "${word_count} + 1")
+  endforeach()
+
+  file(
+    WRITE ${HEADER}
+    "// Generated by abcg_add_shaders from ${SHADER}. Do not edit.\n\n"
+    "#pragma once\n\n"
+    "#include <array>\n"
+    "#include <cstdint>\n\n"
+    "#include \"abcgShader.hpp\"\n\n"
+    "namespace shaders {\n\n"
+    "inline constexpr std::array<std::uint32_t, ${word_count}> "
+    "${VARIABLE}_spv{${words}\n};\n\n"
+    "inline constexpr abcg::ShaderBinary ${VARIABLE}{\n"
+    "    .code = ${VARIABLE}_spv, .stage = abcg::ShaderStage::${STAGE}};\n\n"
+    "} // namespace shaders\n")
+endif()
+
+# Rebuild when the shader or any of its included files change
+string(REPLACE " " "\\ " dependencies "${files}")
+string(REPLACE ";" " " dependencies "${dependencies}")
+file(WRITE ${DEPFILE} "${STAMP}: ${dependencies}\n")
+file(TOUCH ${STAMP})
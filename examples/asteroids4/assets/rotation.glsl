@@ -0,0 +1,5 @@
+vec2 rotate(vec2 v, float angle) {
+  float sinAngle = sin(angle);
+  float cosAngle = cos(angle);
+  return vec2(v.x * cosAngle - v.y * sinAngle, v.x * sinAngle + v.y * cosAngle);
+}
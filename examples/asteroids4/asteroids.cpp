@@ -2,19 +2,13 @@
 
 #include <glm/gtx/fast_trigonometry.hpp>
 
-void Asteroids::create(GLuint program, int quantity) {
+void Asteroids::create(abcg::OpenGLProgram &program, int quantity) {
   destroy();
 
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  // Seed independent of the other generators of the game
+  m_randomEngine.seed(abcg::Application::getRandomSeed(1U));
 
-  m_program = program;
-
-  // Get location of uniforms in the program
-  m_colorLoc = abcg::glGetUniformLocation(m_program, "color");
-  m_rotationLoc = abcg::glGetUniformLocation(m_program, "rotation");
-  m_scaleLoc = abcg::glGetUniformLocation(m_program, "scale");
-  m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
+  m_program = &program;
 
   // Create asteroids
   m_asteroids.clear();
@@ -31,20 +25,21 @@ void Asteroids::create(GLuint program, int quantity) {
   }
 }
 
-void Asteroids::paint() {
-  abcg::glUseProgram(m_program);
+void Asteroids::paint(ObjectBlocks &objectBlocks) {
+  m_program->use();
 
   for (auto const &asteroid : m_asteroids) {
     abcg::glBindVertexArray(asteroid.m_VAO);
 
-    abcg::glUniform4fv(m_colorLoc, 1, &asteroid.m_color.r);
-    abcg::glUniform1f(m_scaleLoc, asteroid.m_scale);
-    abcg::glUniform1f(m_rotationLoc, asteroid.m_rotation);
+    ObjectBlock block{.color = asteroid.m_color,
+                      .translation = {},
+                      .rotation = asteroid.m_rotation,
+                      .scale = asteroid.m_scale};
 
     for (auto i : {-2, 0, 2}) {
       for (auto j : {-2, 0, 2}) {
-        abcg::glUniform2f(m_translationLoc, asteroid.m_translation.x + j,
-                          asteroid.m_translation.y + i);
+        block.translation = asteroid.m_translation + glm::vec2(j, i);
+        objectBlocks.bind(block);
 
         abcg::glDrawArrays(GL_TRIANGLE_FAN, 0, asteroid.m_polygonSides + 2);
       }
@@ -126,8 +121,7 @@ Asteroids::Asteroid Asteroids::makeAsteroid(glm::vec2 translation,
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Get location of attributes in the program
-  auto const positionAttribute{
-      abcg::glGetAttribLocation(m_program, "inPosition")};
+  auto const positionAttribute{m_program->getAttribLocation("inPosition")};
 
   // Create VAO
   abcg::glGenVertexArrays(1, &asteroid.m_VAO);
@@ -7,12 +7,13 @@
 #include "abcgOpenGL.hpp"
 
 #include "gamedata.hpp"
+#include "objectblock.hpp"
 #include "ship.hpp"
 
 class Asteroids {
 public:
-  void create(GLuint program, int quantity);
-  void paint();
+  void create(abcg::OpenGLProgram &program, int quantity);
+  void paint(ObjectBlocks &objectBlocks);
   void destroy();
   void update(const Ship &ship, float deltaTime);
 
@@ -35,11 +36,7 @@ public:
   Asteroid makeAsteroid(glm::vec2 translation = {}, float scale = 0.25f);
 
 private:
-  GLuint m_program{};
-  GLint m_colorLoc{};
-  GLint m_rotationLoc{};
-  GLint m_translationLoc{};
-  GLint m_scaleLoc{};
+  abcg::OpenGLProgram *m_program{};
 
   std::default_random_engine m_randomEngine;
   std::uniform_real_distribution<float> m_randomDist{-1.0f, 1.0f};
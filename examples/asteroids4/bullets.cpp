@@ -2,20 +2,13 @@
 
 #include <glm/gtx/rotate_vector.hpp>
 
-void Bullets::create(GLuint program) {
+void Bullets::create(abcg::OpenGLProgram &program) {
   destroy();
 
-  m_program = program;
-
-  // Get location of uniforms in the program
-  m_colorLoc = abcg::glGetUniformLocation(m_program, "color");
-  m_rotationLoc = abcg::glGetUniformLocation(m_program, "rotation");
-  m_scaleLoc = abcg::glGetUniformLocation(m_program, "scale");
-  m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
+  m_program = &program;
 
   // Get location of attributes in the program
-  auto const positionAttribute{
-      abcg::glGetAttribLocation(m_program, "inPosition")};
+  auto const positionAttribute{m_program->getAttribLocation("inPosition")};
 
   m_bullets.clear();
 
@@ -51,17 +44,16 @@ void Bullets::create(GLuint program) {
   abcg::glBindVertexArray(0);
 }
 
-void Bullets::paint() {
-  abcg::glUseProgram(m_program);
+void Bullets::paint(ObjectBlocks &objectBlocks) {
+  m_program->use();
 
   abcg::glBindVertexArray(m_VAO);
-  abcg::glUniform4f(m_colorLoc, 1, 1, 1, 1);
-  abcg::glUniform1f(m_rotationLoc, 0);
-  abcg::glUniform1f(m_scaleLoc, m_scale);
 
   for (auto const &bullet : m_bullets) {
-    abcg::glUniform2f(m_translationLoc, bullet.m_translation.x,
-                      bullet.m_translation.y);
+    objectBlocks.bind({.color = glm::vec4{1},
+                       .translation = bullet.m_translation,
+                       .rotation = 0.0f,
+                       .scale = m_scale});
 
     abcg::glDrawArrays(GL_TRIANGLE_FAN, 0, 12);
   }
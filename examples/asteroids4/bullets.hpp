@@ -6,14 +6,15 @@
 #include "abcgOpenGL.hpp"
 
 #include "gamedata.hpp"
+#include "objectblock.hpp"
 #include "ship.hpp"
 
 class OpenGLWindow;
 
 class Bullets {
 public:
-  void create(GLuint program);
-  void paint();
+  void create(abcg::OpenGLProgram &program);
+  void paint(ObjectBlocks &objectBlocks);
   void destroy();
   void update(Ship &ship, const GameData &gameData, float deltaTime);
 
@@ -28,11 +29,7 @@ public:
   float m_scale{0.015f};
 
 private:
-  GLuint m_program{};
-  GLint m_colorLoc{};
-  GLint m_rotationLoc{};
-  GLint m_translationLoc{};
-  GLint m_scaleLoc{};
+  abcg::OpenGLProgram *m_program{};
 
   GLuint m_VAO{};
   GLuint m_VBO{};
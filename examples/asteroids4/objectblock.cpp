@@ -0,0 +1,30 @@
+#include "objectblock.hpp"
+
+#include <algorithm>
+
+namespace {
+// Maximum number of draws per frame
+constexpr std::size_t maxBlocks{2048};
+} // namespace
+
+void ObjectBlocks::create() {
+  // Offsets of glBindBufferRange must be multiples of this alignment
+  GLint alignment{};
+  abcg::glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  m_alignment = std::max(gsl::narrow<std::size_t>(alignment), std::size_t{16});
+
+  m_streamBuffer.create(
+      maxBlocks * abcg::alignBlockOffset(sizeof(ObjectBlock), m_alignment));
+}
+
+void ObjectBlocks::destroy() { m_streamBuffer.destroy(); }
+
+void ObjectBlocks::beginFrame() { m_streamBuffer.beginFrame(); }
+
+void ObjectBlocks::bind(ObjectBlock const &block) {
+  auto const offset{
+      m_streamBuffer.push(&block, sizeof(ObjectBlock), m_alignment)};
+  abcg::glBindBufferRange(GL_UNIFORM_BUFFER, objectBlockBinding,
+                          m_streamBuffer.getId(),
+                          gsl::narrow<GLintptr>(offset), sizeof(ObjectBlock));
+}
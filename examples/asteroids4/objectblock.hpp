@@ -0,0 +1,38 @@
+#ifndef OBJECTBLOCK_HPP_
+#define OBJECTBLOCK_HPP_
+
+#include "abcgOpenGL.hpp"
+
+// Uniform block "Object" of objects.vert
+struct ObjectBlock {
+  glm::vec4 color{1};
+  glm::vec2 translation{};
+  float rotation{};
+  float scale{1};
+};
+
+static_assert(abcg::isStd140<ObjectBlock>(
+    ABCG_BLOCK_FIELD(ObjectBlock, color),
+    ABCG_BLOCK_FIELD(ObjectBlock, translation),
+    ABCG_BLOCK_FIELD(ObjectBlock, rotation),
+    ABCG_BLOCK_FIELD(ObjectBlock, scale)));
+
+// Uniform buffer binding point of the "Object" block
+inline constexpr GLuint objectBlockBinding{0};
+
+// "Object" blocks of all draws of a frame. Each block is appended to a stream
+// buffer and bound with glBindBufferRange, so that a draw never waits for the
+// GPU to finish reading the block of a previous draw.
+class ObjectBlocks {
+public:
+  void create();
+  void destroy();
+  void beginFrame();
+  void bind(ObjectBlock const &block);
+
+private:
+  abcg::OpenGLStreamBuffer m_streamBuffer;
+  std::size_t m_alignment{};
+};
+
+#endif
@@ -3,16 +3,10 @@
 #include <glm/gtx/fast_trigonometry.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 
-void Ship::create(GLuint program) {
+void Ship::create(abcg::OpenGLProgram &program) {
   destroy();
 
-  m_program = program;
-
-  // Get location of uniforms in the program
-  m_colorLoc = abcg::glGetUniformLocation(m_program, "color");
-  m_rotationLoc = abcg::glGetUniformLocation(m_program, "rotation");
-  m_scaleLoc = abcg::glGetUniformLocation(m_program, "scale");
-  m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
+  m_program = &program;
 
   // Reset ship attributes
   m_rotation = 0.0f;
@@ -85,8 +79,7 @@ void Ship::create(GLuint program) {
   abcg::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
   // Get location of attributes in the program
-  auto const positionAttribute{
-      abcg::glGetAttribLocation(m_program, "inPosition")};
+  auto const positionAttribute{m_program->getAttribLocation("inPosition")};
 
   // Create VAO
   abcg::glGenVertexArrays(1, &m_VAO);
@@ -106,17 +99,18 @@ void Ship::create(GLuint program) {
   abcg::glBindVertexArray(0);
 }
 
-void Ship::paint(const GameData &gameData) {
+void Ship::paint(const GameData &gameData, ObjectBlocks &objectBlocks) {
   if (gameData.m_state != State::Playing)
     return;
 
-  abcg::glUseProgram(m_program);
+  m_program->use();
 
   abcg::glBindVertexArray(m_VAO);
 
-  abcg::glUniform1f(m_scaleLoc, m_scale);
-  abcg::glUniform1f(m_rotationLoc, m_rotation);
-  abcg::glUniform2fv(m_translationLoc, 1, &m_translation.x);
+  ObjectBlock block{.color = m_color,
+                    .translation = m_translation,
+                    .rotation = m_rotation,
+                    .scale = m_scale};
 
   // Restart thruster blink timer every 100 ms
   if (m_trailBlinkTimer.elapsed() > 100.0 / 1000.0)
@@ -129,7 +123,9 @@ void Ship::paint(const GameData &gameData) {
       abcg::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
       // 50% transparent
-      abcg::glUniform4f(m_colorLoc, 1, 1, 1, 0.5f);
+      auto trailBlock{block};
+      trailBlock.color = glm::vec4{1, 1, 1, 0.5f};
+      objectBlocks.bind(trailBlock);
 
       abcg::glDrawElements(GL_TRIANGLES, 14 * 3, GL_UNSIGNED_INT, nullptr);
 
@@ -137,7 +133,7 @@ void Ship::paint(const GameData &gameData) {
     }
   }
 
-  abcg::glUniform4fv(m_colorLoc, 1, &m_color.r);
+  objectBlocks.bind(block);
   abcg::glDrawElements(GL_TRIANGLES, 12 * 3, GL_UNSIGNED_INT, nullptr);
 
   abcg::glBindVertexArray(0);
@@ -4,11 +4,12 @@
 #include "abcgOpenGL.hpp"
 
 #include "gamedata.hpp"
+#include "objectblock.hpp"
 
 class Ship {
 public:
-  void create(GLuint program);
-  void paint(GameData const &gameData);
+  void create(abcg::OpenGLProgram &program);
+  void paint(GameData const &gameData, ObjectBlocks &objectBlocks);
   void destroy();
   void update(GameData const &gameData, float deltaTime);
 
@@ -22,11 +23,7 @@ public:
   abcg::Timer m_bulletCoolDownTimer;
 
 private:
-  GLuint m_program{};
-  GLint m_translationLoc{};
-  GLint m_colorLoc{};
-  GLint m_scaleLoc{};
-  GLint m_rotationLoc{};
+  abcg::OpenGLProgram *m_program{};
 
   GLuint m_VAO{};
   GLuint m_VBO{};
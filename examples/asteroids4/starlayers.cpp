@@ -1,25 +1,23 @@
 #include "starlayers.hpp"
 
-void StarLayers::create(GLuint program, int quantity) {
+void StarLayers::create(abcg::OpenGLProgram &program, int quantity) {
   destroy();
 
   // Initialize pseudorandom number generator and distributions
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  m_randomEngine.seed(abcg::Application::getRandomSeed(2U));
   std::uniform_real_distribution distPos(-1.0f, 1.0f);
   std::uniform_real_distribution distIntensity(0.5f, 1.0f);
   auto &re{m_randomEngine}; // Shortcut
 
-  m_program = program;
+  m_program = &program;
 
   // Get location of uniforms in the program
-  m_pointSizeLoc = abcg::glGetUniformLocation(m_program, "pointSize");
-  m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
+  m_pointSizeLoc = m_program->getUniformLocation("pointSize");
+  m_translationLoc = m_program->getUniformLocation("translation");
 
   // Get location of attributes in the program
-  auto const positionAttribute{
-      abcg::glGetAttribLocation(m_program, "inPosition")};
-  auto const colorAttribute{abcg::glGetAttribLocation(m_program, "inColor")};
+  auto const positionAttribute{m_program->getAttribLocation("inPosition")};
+  auto const colorAttribute{m_program->getAttribLocation("inColor")};
 
   for (auto &&[index, layer] : iter::enumerate(m_starLayers)) {
     // Create geometry data for the stars of this layer
@@ -62,19 +60,19 @@ void StarLayers::create(GLuint program, int quantity) {
 }
 
 void StarLayers::paint() {
-  abcg::glUseProgram(m_program);
+  m_program->use();
 
   abcg::glEnable(GL_BLEND);
   abcg::glBlendFunc(GL_ONE, GL_ONE);
 
   for (auto const &layer : m_starLayers) {
     abcg::glBindVertexArray(layer.m_VAO);
-    abcg::glUniform1f(m_pointSizeLoc, layer.m_pointSize);
+    m_program->setUniform(m_pointSizeLoc, layer.m_pointSize);
 
     for (auto const i : {-2, 0, 2}) {
       for (auto const j : {-2, 0, 2}) {
-        abcg::glUniform2f(m_translationLoc, layer.m_translation.x + j,
-                          layer.m_translation.y + i);
+        m_program->setUniform(m_translationLoc,
+                              layer.m_translation + glm::vec2(j, i));
 
         abcg::glDrawArrays(GL_POINTS, 0, layer.m_quantity);
       }
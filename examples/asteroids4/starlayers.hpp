@@ -11,13 +11,13 @@
 
 class StarLayers {
 public:
-  void create(GLuint program, int quantity);
+  void create(abcg::OpenGLProgram &program, int quantity);
   void paint();
   void destroy();
   void update(const Ship &ship, float deltaTime);
 
 private:
-  GLuint m_program{};
+  abcg::OpenGLProgram *m_program{};
   GLint m_pointSizeLoc{};
   GLint m_translationLoc{};
 
@@ -41,8 +41,7 @@ void Window::onEvent(SDL_Event const &event) {
       m_gameData.m_input.reset(gsl::narrow<size_t>(Input::Up));
   }
   if (event.type == SDL_MOUSEMOTION) {
-    glm::ivec2 mousePosition;
-    SDL_GetMouseState(&mousePosition.x, &mousePosition.y);
+    glm::ivec2 const mousePosition{event.motion.x, event.motion.y};
 
     glm::vec2 direction{mousePosition.x - m_viewportSize.x / 2,
                         -(mousePosition.y - m_viewportSize.y / 2)};
@@ -62,18 +61,18 @@ void Window::onCreate() {
   }
 
   // Create program to render the other objects
-  m_objectsProgram =
-      abcg::createOpenGLProgram({{.source = assetsPath + "objects.vert",
-                                  .stage = abcg::ShaderStage::Vertex},
-                                 {.source = assetsPath + "objects.frag",
-                                  .stage = abcg::ShaderStage::Fragment}});
+  m_objectsProgram.create({{.source = assetsPath + "objects.vert",
+                            .stage = abcg::ShaderStage::Vertex},
+                           {.source = assetsPath + "objects.frag",
+                            .stage = abcg::ShaderStage::Fragment}});
+  m_objectsProgram.setUniformBlockBinding("Object", objectBlockBinding);
+  m_objectBlocks.create();
 
   // Create program to render the stars
-  m_starsProgram =
-      abcg::createOpenGLProgram({{.source = assetsPath + "stars.vert",
-                                  .stage = abcg::ShaderStage::Vertex},
-                                 {.source = assetsPath + "stars.frag",
-                                  .stage = abcg::ShaderStage::Fragment}});
+  m_starsProgram.create({{.source = assetsPath + "stars.vert",
+                          .stage = abcg::ShaderStage::Vertex},
+                         {.source = assetsPath + "stars.frag",
+                          .stage = abcg::ShaderStage::Fragment}});
 
   abcg::glClearColor(0, 0, 0, 1);
 
@@ -81,9 +80,9 @@ void Window::onCreate() {
   abcg::glEnable(GL_PROGRAM_POINT_SIZE);
 #endif
 
-  // Start pseudo-random number generator
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  // Start pseudo-random number generator. Each generator of the game uses a
+  // different stream of the session seed
+  m_randomEngine.seed(abcg::Application::getRandomSeed(0U));
 
   restart();
 }
@@ -122,10 +121,12 @@ void Window::onPaint() {
   abcg::glClear(GL_COLOR_BUFFER_BIT);
   abcg::glViewport(0, 0, m_viewportSize.x, m_viewportSize.y);
 
+  m_objectBlocks.beginFrame();
+
   m_starLayers.paint();
-  m_asteroids.paint();
-  m_bullets.paint();
-  m_ship.paint(m_gameData);
+  m_asteroids.paint(m_objectBlocks);
+  m_bullets.paint(m_objectBlocks);
+  m_ship.paint(m_gameData, m_objectBlocks);
 }
 
 void Window::onPaintUI() {
@@ -161,8 +162,9 @@ void Window::onResize(glm::ivec2 const &size) {
 }
 
 void Window::onDestroy() {
-  abcg::glDeleteProgram(m_starsProgram);
-  abcg::glDeleteProgram(m_objectsProgram);
+  m_starsProgram.destroy();
+  m_objectsProgram.destroy();
+  m_objectBlocks.destroy();
 
   m_asteroids.destroy();
   m_bullets.destroy();
@@ -23,8 +23,9 @@ protected:
 private:
   glm::ivec2 m_viewportSize{};
 
-  GLuint m_starsProgram{};
-  GLuint m_objectsProgram{};
+  abcg::OpenGLProgram m_starsProgram;
+  abcg::OpenGLProgram m_objectsProgram;
+  ObjectBlocks m_objectBlocks;
 
   GameData m_gameData;
 
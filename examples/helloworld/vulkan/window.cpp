@@ -1,5 +1,7 @@
 #include "window.hpp"
 
+#include "shaders.hpp"
+
 void Window::onCreate() {
   createBuffers();
   createShaders();
@@ -140,17 +142,9 @@ void Window::createBuffers() {
 void Window::destroyBuffers() { m_vertexBuffer.destroy(); }
 
 void Window::createShaders() {
-  auto const assetsPath{abcg::Application::getAssetsPath()};
-
-  // Crete vertex shader
-  m_vertexShader.create(getDevice(),
-                        {.source = assetsPath + "UnlitVertexColor.vert",
-                         .stage = abcg::ShaderStage::Vertex});
-
-  // Create fragment shader
-  m_fragmentShader.create(getDevice(),
-                          {.source = assetsPath + "UnlitVertexColor.frag",
-                           .stage = abcg::ShaderStage::Fragment});
+  // SPIR-V code compiled at build time by abcg_add_shaders
+  m_vertexShader.create(getDevice(), shaders::UnlitVertexColor_vert);
+  m_fragmentShader.create(getDevice(), shaders::UnlitVertexColor_frag);
 }
 
 void Window::destroyShaders() {
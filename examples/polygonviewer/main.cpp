@@ -6,7 +6,10 @@ int main(int argc, char **argv) {
 
     Window window;
     window.setWindowSettings(
-        {.width = 800, .height = 800, .title = "Polygon Viewer"});
+        {.width = 800,
+         .height = 800,
+         .title = "Polygon Viewer",
+         .renderOnDemand = true});
 
     app.run(window);
   } catch (std::exception const &exception) {
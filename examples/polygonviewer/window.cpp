@@ -11,8 +11,7 @@ void Window::onCreate() {
                                   .stage = abcg::ShaderStage::Fragment}});
 
   // Start pseudo-random number generator
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  m_randomEngine.seed(abcg::Application::getRandomSeed());
 
   // start rendering a triangle
   sides = 3;
@@ -44,11 +44,11 @@ void Window::onCreate() {
 
   // Create shader program
   auto const path{abcg::Application::getAssetsPath()};
-  m_program =
-      abcg::createOpenGLProgram({{.source = path + "UnlitVertexColor.vert",
-                                  .stage = abcg::ShaderStage::Vertex},
-                                 {.source = path + "UnlitVertexColor.frag",
-                                  .stage = abcg::ShaderStage::Fragment}});
+  m_program.create({{.source = path + "UnlitVertexColor.vert",
+                     .stage = abcg::ShaderStage::Vertex},
+                    {.source = path + "UnlitVertexColor.frag",
+                     .stage = abcg::ShaderStage::Fragment}});
+  m_scaleLocation = m_program.getUniformLocation("scale");
 
   // Load a new font
   auto const filename{path + "Inconsolata-Medium.ttf"};
@@ -60,17 +60,18 @@ void Window::onCreate() {
   abcg::glClearColor(0, 0, 0, 1);
 
   // Start pseudo-random number generator
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  m_randomEngine.seed(abcg::Application::getRandomSeed());
 
+  setupModel();
   restart();
 }
 
 void Window::restart() {
   m_simulationData.m_state = State::SimulationInProgress;
 
-  auto const scaleLocation{abcg::glGetUniformLocation(m_program, "scale")};
-  abcg::glUniform1f(scaleLocation, 0.25);
+  m_program.use();
+  m_program.setUniform(m_scaleLocation, 0.25f);
+  abcg::glUseProgram(0);
 
   // start rendering a triangle
   sides = 3;
@@ -96,7 +97,7 @@ void Window::onPaint() {
   abcg::glViewport(0, 0, m_viewportSize.x, m_viewportSize.y);
 
   // Start using the shader program
-  abcg::glUseProgram(m_program);
+  m_program.use();
 
   if (m_simulationData.m_input[static_cast<size_t>(Input::Left)]) {
     sides = sides - 1;
@@ -107,17 +108,21 @@ void Window::onPaint() {
     createRegularPolygon(sides);
   }
   if (m_simulationData.m_input[static_cast<size_t>(Input::ZoomIn)]) {
-    auto const scaleLocation{abcg::glGetUniformLocation(m_program, "scale")};
-    abcg::glUniform1f(scaleLocation, 0.5);
+    m_program.setUniform(m_scaleLocation, 0.5f);
   }
   if (m_simulationData.m_input[static_cast<size_t>(Input::ZoomIn)]) {
-    auto const scaleLocation{abcg::glGetUniformLocation(m_program, "scale")};
-    abcg::glUniform1f(scaleLocation, 0.25);
+    m_program.setUniform(m_scaleLocation, 0.25f);
   }
 
+  // Write the vertices to the region of the stream buffer of this frame
+  m_streamBuffer.beginFrame();
+  auto const offset{m_streamBuffer.push(std::span{m_vertices})};
+
   // Render
   abcg::glBindVertexArray(m_vao);
-  abcg::glDrawArrays(GL_TRIANGLE_FAN, 0, sides + 2);
+  abcg::glDrawArrays(GL_TRIANGLE_FAN,
+                     gsl::narrow<GLint>(offset / sizeof(Vertex)),
+                     gsl::narrow<GLsizei>(m_vertices.size()));
   abcg::glBindVertexArray(0);
   abcg::glUseProgram(0);
 }
@@ -170,9 +175,8 @@ void Window::onResize(glm::ivec2 const &size) {
 
 void Window::onDestroy() {
   // Release OpenGL resources
-  abcg::glDeleteProgram(m_program);
-  abcg::glDeleteBuffers(1, &m_vboVertices);
-  abcg::glDeleteBuffers(1, &m_vboColors);
+  m_program.destroy();
+  m_streamBuffer.destroy();
   abcg::glDeleteVertexArrays(1, &m_vao);
 }
 
@@ -196,11 +200,6 @@ their sides and angles are congruent. The three conditions must be satisfied.
 
 */
 void Window::createRegularPolygon(int sides) {
-  // Release previous resources, if any
-  abcg::glDeleteBuffers(1, &m_vboPositions);
-  abcg::glDeleteBuffers(1, &m_vboColors);
-  abcg::glDeleteVertexArrays(1, &m_vao);
-
   // Select random colors
   std::uniform_real_distribution<float> rd(0.0f, 1.0f);
   std::array const colors{glm::vec4(rd(m_randomEngine), rd(m_randomEngine),
@@ -224,24 +223,22 @@ void Window::createRegularPolygon(int sides) {
   // becomes regular.
   positions.emplace_back(positions.at(1));
 
-  // Generate VBO of positions
-  abcg::glGenBuffers(1, &m_vboPositions);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vboPositions);
-  abcg::glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
-                     positions.data(), GL_STATIC_DRAW);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+  // The vertices are streamed to the GPU in onPaint, so no buffer is
+  // recreated here. The three colors are repeated along the border.
+  m_vertices.clear();
+  for (auto const index : iter::range(positions.size())) {
+    m_vertices.push_back({.position = positions.at(index),
+                          .color = colors.at(index % colors.size())});
+  }
+}
 
-  // Generate VBO of colors
-  abcg::glGenBuffers(1, &m_vboColors);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vboColors);
-  abcg::glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(glm::vec4),
-                     colors.data(), GL_STATIC_DRAW);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+void Window::setupModel() {
+  // Generate a stream buffer with room for the largest polygon per frame
+  m_streamBuffer.create(sizeof(Vertex) * 64);
 
   // Get location of attributes in the program
-  const auto positionAttribute{
-      abcg::glGetAttribLocation(m_program, "inPosition")};
-  const auto colorAttribute{abcg::glGetAttribLocation(m_program, "inColor")};
+  const auto positionAttribute{m_program.getAttribLocation("inPosition")};
+  const auto colorAttribute{m_program.getAttribLocation("inColor")};
 
   // Create VAO
   abcg::glGenVertexArrays(1, &m_vao);
@@ -249,16 +246,17 @@ void Window::createRegularPolygon(int sides) {
   // Bind vertex attributes to current VAO
   abcg::glBindVertexArray(m_vao);
 
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer.getId());
+
   abcg::glEnableVertexAttribArray(positionAttribute);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vboPositions);
-  abcg::glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0,
-                              nullptr);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+  abcg::glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex), nullptr);
 
   abcg::glEnableVertexAttribArray(colorAttribute);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vboColors);
-  abcg::glVertexAttribPointer(colorAttribute, 4, GL_FLOAT, GL_FALSE, 0,
-                              nullptr);
+  abcg::glVertexAttribPointer(colorAttribute, 4, GL_FLOAT, GL_FALSE,
+                              sizeof(Vertex),
+                              reinterpret_cast<void *>(sizeof(glm::vec2)));
+
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // End of binding to current VAO
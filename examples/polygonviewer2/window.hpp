@@ -17,11 +17,16 @@ protected:
   void onDestroy() override;
 
 private:
+  struct Vertex {
+    glm::vec2 position;
+    glm::vec4 color;
+  };
+
   GLuint m_vao{};
-  GLuint m_vboVertices{};
-  GLuint m_vboColors{};
-  GLuint m_program{};
-  GLuint m_vboPositions{};
+  abcg::OpenGLStreamBuffer m_streamBuffer;
+  std::vector<Vertex> m_vertices;
+  abcg::OpenGLProgram m_program;
+  GLint m_scaleLocation{};
 
   SimulationData m_simulationData;
 
@@ -34,6 +39,7 @@ private:
   int sides;
 
   void createRegularPolygon(int sides);
+  void setupModel();
 
   void restart();
 
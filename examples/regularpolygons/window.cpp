@@ -29,15 +29,18 @@ void Window::onCreate() {
     void main() { outColor = fragColor; }
   )gl"};
 
-  m_program = abcg::createOpenGLProgram(
+  m_program.create(
       {{.source = vertexShader, .stage = abcg::ShaderStage::Vertex},
        {.source = fragmentShader, .stage = abcg::ShaderStage::Fragment}});
 
+  // Get location of uniforms in the program
+  m_translationLocation = m_program.getUniformLocation("translation");
+  m_scaleLocation = m_program.getUniformLocation("scale");
+
   abcg::glClearColor(0, 0, 0, 1);
   abcg::glClear(GL_COLOR_BUFFER_BIT);
 
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  m_randomEngine.seed(abcg::Application::getRandomSeed());
 }
 
 void Window::onPaint() {
@@ -52,20 +55,17 @@ void Window::onPaint() {
 
   abcg::glViewport(0, 0, m_viewportSize.x, m_viewportSize.y);
 
-  abcg::glUseProgram(m_program);
+  m_program.use();
 
   // Pick a random xy position from (-1,-1) to (1,1)
   std::uniform_real_distribution rd1(-1.0f, 1.0f);
   glm::vec2 const translation{rd1(m_randomEngine), rd1(m_randomEngine)};
-  auto const translationLocation{
-      abcg::glGetUniformLocation(m_program, "translation")};
-  abcg::glUniform2fv(translationLocation, 1, &translation.x);
+  m_program.setUniform(m_translationLocation, translation);
 
   // Pick a random scale factor (1% to 25%)
   std::uniform_real_distribution rd2(0.01f, 0.25f);
   auto const scale{rd2(m_randomEngine)};
-  auto const scaleLocation{abcg::glGetUniformLocation(m_program, "scale")};
-  abcg::glUniform1f(scaleLocation, scale);
+  m_program.setUniform(m_scaleLocation, scale);
 
   // Render
   abcg::glBindVertexArray(m_VAO);
@@ -107,7 +107,7 @@ void Window::onResize(glm::ivec2 const &size) {
 }
 
 void Window::onDestroy() {
-  abcg::glDeleteProgram(m_program);
+  m_program.destroy();
   abcg::glDeleteBuffers(1, &m_VBOPositions);
   abcg::glDeleteBuffers(1, &m_VBOColors);
   abcg::glDeleteVertexArrays(1, &m_VAO);
@@ -162,9 +162,8 @@ void Window::setupModel(int sides) {
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Get location of attributes in the program
-  auto const positionAttribute{
-      abcg::glGetAttribLocation(m_program, "inPosition")};
-  auto const colorAttribute{abcg::glGetAttribLocation(m_program, "inColor")};
+  auto const positionAttribute{m_program.getAttribLocation("inPosition")};
+  auto const colorAttribute{m_program.getAttribLocation("inColor")};
 
   // Create VAO
   abcg::glGenVertexArrays(1, &m_VAO);
@@ -19,7 +19,9 @@ private:
   GLuint m_VAO{};
   GLuint m_VBOPositions{};
   GLuint m_VBOColors{};
-  GLuint m_program{};
+  abcg::OpenGLProgram m_program;
+  GLint m_translationLocation{};
+  GLint m_scaleLocation{};
 
   std::default_random_engine m_randomEngine;
 
@@ -37,9 +37,11 @@ void Window::onCreate() {
   fmt::print("Point size: {:.2f} (min), {:.2f} (max)\n", sizes.at(0),
              sizes.at(1));
 
+  // Create the VBO and VAO once; the point is streamed every frame
+  setupModel();
+
   // Start pseudorandom number generator
-  auto const seed{std::chrono::steady_clock::now().time_since_epoch().count()};
-  m_randomEngine.seed(seed);
+  m_randomEngine.seed(abcg::Application::getRandomSeed());
 
   // Randomly pick a pair of coordinates in the range [-1; 1)
   std::uniform_real_distribution<float> realDistribution(-1.0f, 1.0f);
@@ -48,8 +50,9 @@ void Window::onCreate() {
 }
 
 void Window::onPaint() {
-  // Create OpenGL buffers for drawing the point at m_P
-  setupModel();
+  // Write the point at m_P to the region of the stream buffer of this frame
+  m_streamBuffer.beginFrame();
+  auto const offset{m_streamBuffer.push(std::span{&m_P, 1})};
 
   // Set the viewport
   abcg::glViewport(0, 0, m_viewportSize.x, m_viewportSize.y);
@@ -60,7 +63,7 @@ void Window::onPaint() {
   abcg::glBindVertexArray(m_VAO);
 
   // Draw a single point
-  abcg::glDrawArrays(GL_POINTS, 0, 1);
+  abcg::glDrawArrays(GL_POINTS, gsl::narrow<GLint>(offset / sizeof(m_P)), 1);
 
   // End using VAO
   abcg::glBindVertexArray(0);
@@ -103,23 +106,13 @@ void Window::onResize(glm::ivec2 const &size) {
 void Window::onDestroy() {
   // Release shader program, VBO and VAO
   abcg::glDeleteProgram(m_program);
-  abcg::glDeleteBuffers(1, &m_VBOVertices);
+  m_streamBuffer.destroy();
   abcg::glDeleteVertexArrays(1, &m_VAO);
 }
 
 void Window::setupModel() {
-  // Release previous VBO and VAO
-  abcg::glDeleteBuffers(1, &m_VBOVertices);
-  abcg::glDeleteVertexArrays(1, &m_VAO);
-
-  // Generate a new VBO and get the associated ID
-  abcg::glGenBuffers(1, &m_VBOVertices);
-  // Bind VBO in order to use it
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_VBOVertices);
-  // Upload data to VBO
-  abcg::glBufferData(GL_ARRAY_BUFFER, sizeof(m_P), &m_P, GL_STATIC_DRAW);
-  // Unbinding the VBO is allowed (data can be released now)
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+  // Generate a stream buffer with room for a few points per frame
+  m_streamBuffer.create(sizeof(m_P) * 16);
 
   // Get location of attributes in the program
   auto const positionAttribute{
@@ -132,7 +125,7 @@ void Window::setupModel() {
   abcg::glBindVertexArray(m_VAO);
 
   abcg::glEnableVertexAttribArray(positionAttribute);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_VBOVertices);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_streamBuffer.getId());
   abcg::glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0,
                               nullptr);
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
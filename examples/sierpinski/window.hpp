@@ -17,7 +17,7 @@ private:
   glm::ivec2 m_viewportSize{};
 
   GLuint m_VAO{};
-  GLuint m_VBOVertices{};
+  abcg::OpenGLStreamBuffer m_streamBuffer;
   GLuint m_program{};
 
   std::default_random_engine m_randomEngine;
@@ -6,7 +6,10 @@ int main(int argc, char **argv) {
 
     Window window;
     window.setWindowSettings(
-        {.width = 600, .height = 600, .title = "Tic-Tac-Toe"});
+        {.width = 600,
+         .height = 600,
+         .title = "Tic-Tac-Toe",
+         .renderOnDemand = true});
 
     app.run(window);
   } catch (std::exception const &exception) {
@@ -0,0 +1,773 @@
+/**
+ * @file main.cpp
+ * @brief Replays a capture file written by abcg::beginOpenGLCapture.
+ *
+ * Usage: `abcg_replay FILE`
+ *
+ * The calls are executed in a hidden window with an OpenGL context of the
+ * same version and profile of the captured context. The calls of the frames
+ * marked to be measured are timed, and the frame times (including the time
+ * taken by `glFinish`) and the time spent in each function are printed. Unless
+ * `SDL_VIDEODRIVER` is set, the window is created with SDL's `offscreen` video
+ * driver, or with the default driver if the former fails.
+ *
+ * The names of the objects created in the replay, the locations of uniforms
+ * and vertex attributes, and the indices of uniform blocks may differ from the
+ * captured ones, e.g., if objects were created without the function wrappers
+ * before the capture or if the replay runs on another driver. The values
+ * returned by `glGen*`, `glCreate*`, `glGetUniformLocation`,
+ * `glGetAttribLocation` and `glGetUniformBlockIndex` are thus mapped to the
+ * values of the replay, and the arguments of the later calls are translated.
+ * Names not created by the captured calls are passed unchanged.
+ *
+ * This file is part of ABCg (https://github.com/hbatagelo/abcg).
+ *
+ * @copyright (c) 2021--2022 Harlen Batagelo. All rights reserved.
+ * This project is released under the MIT License.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "abcgException.hpp"
+#include "abcgExternal.hpp"
+#include "abcgOpenGLCapture.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using Kind = abcg::OpenGLCaptureKind;
+
+// Argument or return value of a captured call
+struct Argument {
+  Kind kind{Kind::None};
+  std::uint64_t bits{};
+  // Data of Bytes, aligned to 8 bytes
+  std::vector<std::uint64_t> data;
+  // Strings of Strings, and pointers to them
+  std::vector<std::string> strings;
+  std::vector<GLchar const *> stringPointers;
+};
+
+struct Call {
+  std::uint16_t function{};
+  std::vector<Argument> args;
+  Argument result;
+};
+
+struct Frame {
+  std::uint64_t index{};
+  bool measured{};
+  std::vector<Call> calls;
+};
+
+struct Capture {
+  abcg::OpenGLCaptureInfo info;
+  // Names of the functions, indexed by their identifiers
+  std::vector<std::string> functions;
+  // The first frame holds the calls made before the first frame mark
+  std::vector<Frame> frames;
+};
+
+struct FunctionStats {
+  std::uint64_t calls{};
+  Clock::duration time{};
+};
+
+// Values that may differ between the capture and the replay
+enum class NameType {
+  Buffer,
+  Texture,
+  VertexArray,
+  Framebuffer,
+  Renderbuffer,
+  Query,
+  Sampler,
+  TransformFeedback,
+  // Programs and shaders share the same names
+  Program,
+  AttribLocation,
+  // Locations and indices of the variables of a program
+  UniformLocation,
+  UniformBlockIndex
+};
+
+// Parameter of a function that holds a name, or an array of names
+struct NameParameter {
+  std::size_t index{};
+  NameType type{};
+  // Index of the program parameter, for locations and block indices. If
+  // empty, the program in use is considered.
+  std::optional<std::size_t> program;
+};
+
+struct ReplayState {
+  // Sync objects of the replay, indexed by the captured values
+  std::unordered_map<std::uint64_t, GLsync> syncs;
+  // Names of the replay, indexed by the type and program (zero for names not
+  // specific to a program) and by the captured names
+  std::map<std::pair<NameType, std::uint64_t>,
+           std::unordered_map<std::uint64_t, std::uint64_t>>
+      names;
+  // Captured name of the program in use
+  std::uint64_t program{};
+  // Copy of the call being replayed, with translated names
+  Call translated;
+  // Storage for the outputs of the calls (e.g., the params of glGetIntegerv)
+  std::vector<std::uint64_t> output;
+};
+
+using Replayer = abcg::OpenGLCaptureValue (*)(Call const &, ReplayState &);
+
+struct ReplayFunction {
+  Replayer replayer{};
+  bool supported{};
+  std::vector<NameParameter> nameParameters;
+  // Type of the names created by the function, if any
+  std::optional<NameType> createdType;
+};
+
+// Reads the values of a capture file
+class Reader {
+public:
+  explicit Reader(std::vector<char> data) : m_data{std::move(data)} {}
+
+  template <typename T> T read() {
+    T value{};
+    std::memcpy(&value, consume(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  std::string readString(std::size_t size) { return {consume(size), size}; }
+
+  void readBytes(std::vector<std::uint64_t> &data, std::size_t size) {
+    data.resize((size + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    std::memcpy(data.data(), consume(size), size);
+  }
+
+private:
+  char const *consume(std::size_t size) {
+    if (size > m_data.size() - m_position) {
+      throw abcg::RuntimeError("Truncated capture file");
+    }
+    auto const *begin{std::next(m_data.data(), gsl::narrow<long>(m_position))};
+    m_position += size;
+    return begin;
+  }
+
+  std::vector<char> m_data;
+  std::size_t m_position{};
+};
+
+Argument readArgument(Reader &reader) {
+  Argument argument;
+  argument.kind = reader.read<Kind>();
+  switch (argument.kind) {
+  case Kind::Integer:
+  case Kind::Float:
+  case Kind::Offset:
+  case Kind::Sync:
+    argument.bits = reader.read<std::uint64_t>();
+    break;
+  case Kind::Bytes: {
+    auto const size{gsl::narrow<std::size_t>(reader.read<std::uint64_t>())};
+    reader.readBytes(argument.data, size);
+    argument.bits = size;
+    break;
+  }
+  case Kind::Strings: {
+    auto const count{reader.read<std::uint32_t>()};
+    for ([[maybe_unused]] auto const index : iter::range(count)) {
+      auto const length{reader.read<std::uint32_t>()};
+      argument.strings.push_back(reader.readString(length));
+    }
+    for (auto const &string : argument.strings) {
+      argument.stringPointers.push_back(string.c_str());
+    }
+    break;
+  }
+  case Kind::None:
+  case Kind::Output:
+  case Kind::Unknown:
+    break;
+  default:
+    throw abcg::RuntimeError("Invalid value in capture file");
+  }
+  return argument;
+}
+
+Capture readCapture(std::string const &path) {
+  std::ifstream stream{path, std::ios::binary};
+  if (!stream) {
+    throw abcg::RuntimeError(fmt::format("Failed to open {}", path));
+  }
+  Reader reader{{std::istreambuf_iterator<char>{stream}, {}}};
+
+  if (reader.read<std::uint32_t>() != abcg::openGLCaptureMagic) {
+    throw abcg::RuntimeError(fmt::format("{} is not a capture file", path));
+  }
+  if (auto const version{reader.read<std::uint32_t>()};
+      version != abcg::openGLCaptureVersion) {
+    throw abcg::RuntimeError(
+        fmt::format("Unsupported capture file version {}", version));
+  }
+
+  Capture capture;
+  capture.info = reader.read<abcg::OpenGLCaptureInfo>();
+  capture.frames.emplace_back();
+
+  while (true) {
+    switch (reader.read<abcg::OpenGLCaptureTag>()) {
+    case abcg::OpenGLCaptureTag::Function: {
+      auto const id{reader.read<std::uint16_t>()};
+      auto const length{reader.read<std::uint16_t>()};
+      if (id >= capture.functions.size()) {
+        capture.functions.resize(id + 1U);
+      }
+      capture.functions.at(id) = reader.readString(length);
+      break;
+    }
+    case abcg::OpenGLCaptureTag::Call: {
+      Call call;
+      call.function = reader.read<std::uint16_t>();
+      auto const argCount{reader.read<std::uint8_t>()};
+      for ([[maybe_unused]] auto const index : iter::range(argCount)) {
+        call.args.push_back(readArgument(reader));
+      }
+      call.result = readArgument(reader);
+      capture.frames.back().calls.push_back(std::move(call));
+      break;
+    }
+    case abcg::OpenGLCaptureTag::Frame: {
+      auto &frame{capture.frames.emplace_back()};
+      frame.index = reader.read<std::uint64_t>();
+      frame.measured = reader.read<std::uint8_t>() != 0;
+      break;
+    }
+    case abcg::OpenGLCaptureTag::End:
+      return capture;
+    default:
+      throw abcg::RuntimeError("Invalid record in capture file");
+    }
+  }
+}
+
+// Converts a captured argument to the type of the parameter of the function
+template <typename T> T decode(Argument const &argument, ReplayState &state) {
+  if constexpr (std::is_same_v<T, GLsync>) {
+    auto const iter{state.syncs.find(argument.bits)};
+    return iter == state.syncs.end() ? nullptr : iter->second;
+  } else if constexpr (std::is_pointer_v<T>) {
+    void const *address{};
+    switch (argument.kind) {
+    case Kind::Bytes:
+      address = argument.data.data();
+      break;
+    case Kind::Strings:
+      address = argument.stringPointers.data();
+      break;
+    case Kind::Offset:
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+      return reinterpret_cast<T>(static_cast<std::uintptr_t>(argument.bits));
+    case Kind::Output:
+      address = state.output.data();
+      break;
+    default:
+      return nullptr;
+    }
+    // The data is never written to, except for outputs
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+    return static_cast<T>(const_cast<void *>(address));
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return static_cast<T>(std::bit_cast<double>(argument.bits));
+  } else {
+    return static_cast<T>(argument.bits);
+  }
+}
+
+template <typename TResult, typename... TArgs, std::size_t... Index>
+abcg::OpenGLCaptureValue replayCall(TResult(GLAPIENTRY *function)(TArgs...),
+                                    Call const &call, ReplayState &state,
+                                    std::index_sequence<Index...> /*unused*/) {
+  if (call.args.size() != sizeof...(TArgs)) {
+    throw abcg::RuntimeError("Invalid number of arguments in capture file");
+  }
+  if constexpr (std::is_void_v<TResult>) {
+    function(decode<TArgs>(call.args[Index], state)...);
+    return {};
+  } else {
+    return abcg::OpenGLCaptureValue::make(
+        function(decode<TArgs>(call.args[Index], state)...));
+  }
+}
+
+template <typename TResult, typename... TArgs>
+abcg::OpenGLCaptureValue replayCall(TResult(GLAPIENTRY *function)(TArgs...),
+                                    Call const &call, ReplayState &state) {
+  return replayCall(function, call, state, std::index_sequence_for<TArgs...>{});
+}
+
+// Returns the parameters of a function that hold names
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+std::vector<NameParameter> getNameParameters(std::string_view name) {
+  auto const startsWithAny{[name](auto const &...prefixes) {
+    return (name.starts_with(prefixes) || ...);
+  }};
+  auto const isAny{[name](auto const &...names) {
+    return ((name == names) || ...);
+  }};
+
+  auto const parameter{[](std::size_t index, NameType type,
+                          std::optional<std::size_t> program = {}) {
+    return NameParameter{.index = index, .type = type, .program = program};
+  }};
+
+  // Objects bound, deleted or queried
+  struct ObjectParameter {
+    std::string_view function;
+    std::size_t index;
+    NameType type;
+  };
+  static std::array const objectParameters{
+      ObjectParameter{"glBindBuffer", 1, NameType::Buffer},
+      ObjectParameter{"glBindBufferBase", 2, NameType::Buffer},
+      ObjectParameter{"glBindBufferRange", 2, NameType::Buffer},
+      ObjectParameter{"glDeleteBuffers", 1, NameType::Buffer},
+      ObjectParameter{"glIsBuffer", 0, NameType::Buffer},
+      ObjectParameter{"glBindTexture", 1, NameType::Texture},
+      ObjectParameter{"glDeleteTextures", 1, NameType::Texture},
+      ObjectParameter{"glFramebufferTexture", 2, NameType::Texture},
+      ObjectParameter{"glFramebufferTexture2D", 3, NameType::Texture},
+      ObjectParameter{"glFramebufferTextureLayer", 2, NameType::Texture},
+      ObjectParameter{"glIsTexture", 0, NameType::Texture},
+      ObjectParameter{"glBindVertexArray", 0, NameType::VertexArray},
+      ObjectParameter{"glDeleteVertexArrays", 1, NameType::VertexArray},
+      ObjectParameter{"glIsVertexArray", 0, NameType::VertexArray},
+      ObjectParameter{"glBindFramebuffer", 1, NameType::Framebuffer},
+      ObjectParameter{"glDeleteFramebuffers", 1, NameType::Framebuffer},
+      ObjectParameter{"glIsFramebuffer", 0, NameType::Framebuffer},
+      ObjectParameter{"glBindRenderbuffer", 1, NameType::Renderbuffer},
+      ObjectParameter{"glDeleteRenderbuffers", 1, NameType::Renderbuffer},
+      ObjectParameter{"glFramebufferRenderbuffer", 3, NameType::Renderbuffer},
+      ObjectParameter{"glIsRenderbuffer", 0, NameType::Renderbuffer},
+      ObjectParameter{"glBeginQuery", 1, NameType::Query},
+      ObjectParameter{"glDeleteQueries", 1, NameType::Query},
+      ObjectParameter{"glGetQueryObjectui64v", 0, NameType::Query},
+      ObjectParameter{"glGetQueryObjectuiv", 0, NameType::Query},
+      ObjectParameter{"glIsQuery", 0, NameType::Query},
+      ObjectParameter{"glQueryCounter", 0, NameType::Query},
+      ObjectParameter{"glBindSampler", 1, NameType::Sampler},
+      ObjectParameter{"glDeleteSamplers", 1, NameType::Sampler},
+      ObjectParameter{"glGetSamplerParameterfv", 0, NameType::Sampler},
+      ObjectParameter{"glGetSamplerParameteriv", 0, NameType::Sampler},
+      ObjectParameter{"glIsSampler", 0, NameType::Sampler},
+      ObjectParameter{"glSamplerParameterf", 0, NameType::Sampler},
+      ObjectParameter{"glSamplerParameterfv", 0, NameType::Sampler},
+      ObjectParameter{"glSamplerParameteri", 0, NameType::Sampler},
+      ObjectParameter{"glSamplerParameteriv", 0, NameType::Sampler},
+      ObjectParameter{"glBindTransformFeedback", 1,
+                      NameType::TransformFeedback},
+      ObjectParameter{"glDeleteTransformFeedbacks", 1,
+                      NameType::TransformFeedback},
+      ObjectParameter{"glIsTransformFeedback", 0, NameType::TransformFeedback},
+      ObjectParameter{"glShaderBinary", 1, NameType::Program}};
+  for (auto const &object : objectParameters) {
+    if (name == object.function) {
+      return {parameter(object.index, object.type)};
+    }
+  }
+
+  // Programs and shaders
+  auto const program{parameter(0, NameType::Program)};
+  if (isAny("glAttachShader", "glDetachShader")) {
+    return {program, parameter(1, NameType::Program)};
+  }
+  if (isAny("glGetActiveUniformBlockName", "glGetActiveUniformBlockiv",
+            "glUniformBlockBinding")) {
+    return {program, parameter(1, NameType::UniformBlockIndex, 0)};
+  }
+  if (isAny("glGetUniformfv", "glGetUniformiv", "glGetUniformuiv")) {
+    return {program, parameter(1, NameType::UniformLocation, 0)};
+  }
+  if (name.starts_with("glUniform")) {
+    return {parameter(0, NameType::UniformLocation)};
+  }
+  if (name != "glGetShaderPrecisionFormat" &&
+      (startsWithAny("glGetActive", "glGetProgram", "glGetShader",
+                     "glGetUniform") ||
+       isAny("glBindAttribLocation", "glBindFragDataLocation",
+             "glCompileShader", "glDeleteProgram", "glDeleteShader",
+             "glGetAttachedShaders", "glGetAttribLocation",
+             "glGetFragDataLocation", "glGetTransformFeedbackVarying",
+             "glIsProgram", "glIsShader", "glLinkProgram", "glProgramBinary",
+             "glProgramParameteri", "glShaderSource",
+             "glTransformFeedbackVaryings", "glUseProgram",
+             "glValidateProgram"))) {
+    return {program};
+  }
+
+  // Vertex attributes, e.g., glVertexAttribPointer and glGetVertexAttribiv
+  if (name.find("VertexAttrib") != std::string_view::npos) {
+    return {parameter(0, NameType::AttribLocation)};
+  }
+  return {};
+}
+
+// Returns the type of the names created by a function, if any
+std::optional<NameType> getCreatedType(std::string_view name) {
+  static std::array const functions{
+      std::pair{"glGenBuffers", NameType::Buffer},
+      std::pair{"glGenTextures", NameType::Texture},
+      std::pair{"glGenVertexArrays", NameType::VertexArray},
+      std::pair{"glGenFramebuffers", NameType::Framebuffer},
+      std::pair{"glGenRenderbuffers", NameType::Renderbuffer},
+      std::pair{"glGenQueries", NameType::Query},
+      std::pair{"glGenSamplers", NameType::Sampler},
+      std::pair{"glGenTransformFeedbacks", NameType::TransformFeedback},
+      std::pair{"glCreateProgram", NameType::Program},
+      std::pair{"glCreateShader", NameType::Program}};
+  for (auto const &[function, type] : functions) {
+    if (name == function) {
+      return type;
+    }
+  }
+  return {};
+}
+
+// Must be called after glewInit so that the addresses of the functions are
+// known
+std::unordered_map<std::string_view, ReplayFunction> getReplayFunctions() {
+  std::unordered_map<std::string_view, ReplayFunction> functions;
+#define ABCG_ADD_FUNCTION(name)                                                \
+  functions.try_emplace(                                                       \
+      #name,                                                                   \
+      ReplayFunction{                                                          \
+          .replayer = [](Call const &call, ReplayState &state) {               \
+            return replayCall(::name, call, state);                            \
+          },                                                                   \
+          .supported = abcg::getOpenGLFunctionAddress(::name) != nullptr,      \
+          .nameParameters = getNameParameters(#name),                          \
+          .createdType = getCreatedType(#name)});
+  ABCG_OPENGL_CAPTURE_FUNCTIONS(ABCG_ADD_FUNCTION)
+#undef ABCG_ADD_FUNCTION
+  return functions;
+}
+
+// Returns the map from captured to replayed names of a given type
+std::unordered_map<std::uint64_t, std::uint64_t> &
+getNames(ReplayState &state, NameType type, std::uint64_t program = 0) {
+  return state.names[{type, program}];
+}
+
+// Returns the replayed value of a captured name, or the captured value if the
+// name was not created by the captured calls
+std::uint64_t translateName(ReplayState &state, NameType type,
+                            std::uint64_t name, std::uint64_t program) {
+  auto const &names{getNames(state, type, program)};
+  auto const iter{names.find(name)};
+  return iter == names.end() ? name : iter->second;
+}
+
+// Returns the call with its names translated to the names of the replay
+Call const &translateCall(Call const &call, ReplayFunction const &function,
+                          ReplayState &state) {
+  if (function.nameParameters.empty()) {
+    return call;
+  }
+  state.translated = call;
+  auto &args{state.translated.args};
+  for (auto const &parameter : function.nameParameters) {
+    if (parameter.index >= args.size()) {
+      continue;
+    }
+    auto program{std::uint64_t{}};
+    if (parameter.type == NameType::UniformLocation ||
+        parameter.type == NameType::UniformBlockIndex) {
+      program = parameter.program ? call.args.at(*parameter.program).bits
+                                  : state.program;
+    }
+    auto &arg{args.at(parameter.index)};
+    if (arg.kind != Kind::Bytes) {
+      arg.bits = translateName(state, parameter.type, arg.bits, program);
+      continue;
+    }
+    // Array of names, e.g., of glDeleteBuffers
+    auto *const bytes{reinterpret_cast<char *>(arg.data.data())};
+    for (auto offset{std::size_t{}}; offset + sizeof(GLuint) <= arg.bits;
+         offset += sizeof(GLuint)) {
+      GLuint name{};
+      std::memcpy(&name, std::next(bytes, gsl::narrow<long>(offset)),
+                  sizeof(name));
+      name = gsl::narrow_cast<GLuint>(
+          translateName(state, parameter.type, name, program));
+      std::memcpy(std::next(bytes, gsl::narrow<long>(offset)), &name,
+                  sizeof(name));
+    }
+  }
+  return state.translated;
+}
+
+// Maps the names returned by a call to the names of the replay
+void updateNames(std::string_view name, Call const &call,
+                 ReplayFunction const &function,
+                 abcg::OpenGLCaptureValue const &result, ReplayState &state) {
+  if (call.result.kind == Kind::Sync) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    state.syncs[call.result.bits] = reinterpret_cast<GLsync>(result.bits);
+    return;
+  }
+  if (name == "glDeleteSync" && !call.args.empty()) {
+    state.syncs.erase(call.args.front().bits);
+    return;
+  }
+  if (name == "glUseProgram" && !call.args.empty()) {
+    state.program = call.args.front().bits;
+    return;
+  }
+
+  if (function.createdType) {
+    auto &names{getNames(state, *function.createdType)};
+    if (call.result.kind == Kind::Integer) {
+      // glCreate*
+      names[call.result.bits] = result.bits;
+    } else if (call.result.kind == Kind::Bytes) {
+      // glGen* writes the names to the output storage
+      auto const count{std::min(gsl::narrow<std::size_t>(call.result.bits),
+                                state.output.size() * sizeof(std::uint64_t)) /
+                       sizeof(GLuint)};
+      for (auto const index : iter::range(count)) {
+        GLuint captured{};
+        GLuint replayed{};
+        auto const offset{gsl::narrow<long>(index * sizeof(GLuint))};
+        std::memcpy(&captured,
+                    std::next(reinterpret_cast<char const *>(
+                                  call.result.data.data()),
+                              offset),
+                    sizeof(GLuint));
+        std::memcpy(&replayed,
+                    std::next(reinterpret_cast<char const *>(
+                                  state.output.data()),
+                              offset),
+                    sizeof(GLuint));
+        names[captured] = replayed;
+      }
+    }
+    return;
+  }
+
+  if (call.result.kind != Kind::Integer || call.args.empty()) {
+    return;
+  }
+  auto const program{call.args.front().bits};
+  if (name == "glGetUniformLocation") {
+    getNames(state, NameType::UniformLocation, program)[call.result.bits] =
+        result.bits;
+  } else if (name == "glGetUniformBlockIndex") {
+    getNames(state, NameType::UniformBlockIndex, program)[call.result.bits] =
+        result.bits;
+  } else if (name == "glGetAttribLocation") {
+    // Attribute locations are not specific to a program when the vertex
+    // arrays are set up, so the last location queried for a captured location
+    // is used
+    getNames(state, NameType::AttribLocation)[call.result.bits] = result.bits;
+  }
+}
+
+struct ReplayResult {
+  std::vector<std::pair<std::uint64_t, Clock::duration>> frameTimes;
+  std::unordered_map<std::string_view, FunctionStats> functionStats;
+};
+
+ReplayResult replay(Capture const &capture) {
+  auto const functions{getReplayFunctions()};
+
+  // Resolve the functions of the capture file
+  std::vector<ReplayFunction> replayFunctions;
+  for (auto const &name : capture.functions) {
+    if (auto const iter{functions.find(name)};
+        iter != functions.end() && iter->second.supported) {
+      replayFunctions.push_back(iter->second);
+    } else {
+      if (!name.empty()) {
+        fmt::print(stderr, "Warning: {} is not supported and is skipped\n",
+                   name);
+      }
+      replayFunctions.emplace_back();
+    }
+  }
+
+  // Large enough for reading the pixels of the default framebuffer
+  ReplayState state;
+  state.output.resize(std::max<std::size_t>(
+      std::size_t{1} << 17U,
+      gsl::narrow<std::size_t>(std::max(capture.info.width, 1)) *
+          gsl::narrow<std::size_t>(std::max(capture.info.height, 1)) * 2U));
+
+  ReplayResult result;
+  auto const replayFrame{[&](Frame const &frame, bool timed) {
+    for (auto const &call : frame.calls) {
+      auto const &function{replayFunctions.at(call.function)};
+      if (function.replayer == nullptr) {
+        continue;
+      }
+      auto const &name{capture.functions.at(call.function)};
+      auto const &translated{translateCall(call, function, state)};
+      auto const start{Clock::now()};
+      auto const value{function.replayer(translated, state)};
+      if (timed) {
+        auto &stats{result.functionStats[name]};
+        ++stats.calls;
+        stats.time += Clock::now() - start;
+      }
+      updateNames(name, call, function, value, state);
+    }
+  }};
+
+  for (auto const &frame : capture.frames) {
+    if (!frame.measured) {
+      replayFrame(frame, false);
+      continue;
+    }
+    auto const start{Clock::now()};
+    replayFrame(frame, true);
+    glFinish();
+    result.frameTimes.emplace_back(frame.index, Clock::now() - start);
+  }
+  return result;
+}
+
+void printResult(ReplayResult const &result) {
+  auto const toMilliseconds{[](Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  }};
+
+  Clock::duration totalTime{};
+  fmt::print("{:>8} {:>12}\n", "Frame", "Time (ms)");
+  for (auto const &[index, time] : result.frameTimes) {
+    fmt::print("{:>8} {:>12.3f}\n", index, toMilliseconds(time));
+    totalTime += time;
+  }
+  if (!result.frameTimes.empty()) {
+    fmt::print("{:>8} {:>12.3f}\n\n", "Average",
+               toMilliseconds(totalTime) /
+                   static_cast<double>(result.frameTimes.size()));
+  }
+
+  std::vector<std::pair<std::string_view, FunctionStats>> functions(
+      result.functionStats.begin(), result.functionStats.end());
+  std::ranges::sort(functions, [](auto const &lhs, auto const &rhs) {
+    return lhs.second.time > rhs.second.time;
+  });
+  fmt::print("{:<36} {:>10} {:>12} {:>12}\n", "Function", "Calls",
+             "Total (ms)", "Average (us)");
+  for (auto const &[name, stats] : functions) {
+    fmt::print("{:<36} {:>10} {:>12.3f} {:>12.3f}\n", name, stats.calls,
+               toMilliseconds(stats.time),
+               toMilliseconds(stats.time) * 1000.0 /
+                   static_cast<double>(stats.calls));
+  }
+}
+
+struct ReplayContext {
+  SDL_Window *window{};
+  SDL_GLContext context{};
+};
+
+// Initializes the video subsystem with the given driver (or the default driver
+// if null) and creates a hidden window with a context similar to the captured
+// one. On failure, the video subsystem is shut down and an empty context is
+// returned
+ReplayContext createContext(abcg::OpenGLCaptureInfo const &info,
+                            char const *driver) {
+  if (SDL_VideoInit(driver) != 0) {
+    return {};
+  }
+
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, info.majorVersion);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, info.minorVersion);
+  SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, info.profileMask);
+  SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+  SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
+
+  auto *window{SDL_CreateWindow("abcg_replay", SDL_WINDOWPOS_CENTERED,
+                                SDL_WINDOWPOS_CENTERED,
+                                std::max(info.width, 1),
+                                std::max(info.height, 1),
+                                SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN)};
+  if (window == nullptr) {
+    SDL_VideoQuit();
+    return {};
+  }
+  auto *context{SDL_GL_CreateContext(window)};
+  if (context == nullptr) {
+    SDL_DestroyWindow(window);
+    SDL_VideoQuit();
+    return {};
+  }
+  return {.window = window, .context = context};
+}
+
+void run(std::string const &path) {
+  auto const capture{readCapture(path)};
+  auto const &info{capture.info};
+
+  if (SDL_Init(0) != 0) {
+    throw abcg::SDLError("SDL_Init failed");
+  }
+
+  // Do not require a display unless the user selected the driver explicitly.
+  // If the offscreen driver is not available or cannot create the context,
+  // fall back to the default driver.
+  auto const offscreen{SDL_getenv("SDL_VIDEODRIVER") == nullptr};
+  auto replayContext{createContext(info, offscreen ? "offscreen" : nullptr)};
+  if (replayContext.context == nullptr && offscreen) {
+    fmt::print(stderr, "Offscreen video driver failed ({}), using default\n",
+               SDL_GetError());
+    replayContext = createContext(info, nullptr);
+  }
+  if (replayContext.context == nullptr) {
+    throw abcg::SDLError("Failed to create OpenGL context");
+  }
+
+  // GLEW built with GLX support reports this error with other windowing
+  // systems (e.g., EGL), although the functions are loaded
+  if (auto const err{glewInit()};
+      GLEW_OK != err && GLEW_ERROR_NO_GLX_DISPLAY != err) {
+    throw abcg::Exception{fmt::format("Failed to initialize OpenGL loader: {}",
+                                      glewGetErrorString(err))};
+  }
+
+  fmt::print("Replaying {} ({} frames, OpenGL {}.{})\n", path,
+             capture.frames.size() - 1, info.majorVersion, info.minorVersion);
+  printResult(replay(capture));
+
+  SDL_GL_DeleteContext(replayContext.context);
+  SDL_DestroyWindow(replayContext.window);
+  SDL_VideoQuit();
+  SDL_Quit();
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    auto const args{std::span{argv, gsl::narrow<std::size_t>(argc)}};
+    if (args.size() != 2) {
+      fmt::print(stderr, "Usage: abcg_replay FILE\n");
+      return -1;
+    }
+    run(args[1]);
+  } catch (std::exception const &exception) {
+    fmt::print(stderr, "{}\n", exception.what());
+    return -1;
+  }
+  return 0;
+}